@@ -18,11 +18,16 @@
 
 namespace
 {
-    struct PiConsoleInformation
+    struct PiConsoleLayout
     {
-        SIZE_T Size;
         int WindowDpi;
         int InputEditHeight;
+    };
+
+    struct PiConsoleInformation
+    {
+        SIZE_T Size;
+        Mile::SeqLock<PiConsoleLayout> Layout;
         HANDLE InputSignal;
         HWND InputEdit;
         HWND OutputEdit;
@@ -54,7 +59,8 @@ namespace
             ::PiConsoleGetInformation(WindowHandle);
         if (ConsoleInformation)
         {
-            int& InputEditHeight = ConsoleInformation->InputEditHeight;
+            int InputEditHeight =
+                ConsoleInformation->Layout.Load().InputEditHeight;
             HWND& FocusedEdit = ConsoleInformation->FocusedEdit;
             HWND& InputEdit = ConsoleInformation->InputEdit;
             HWND& OutputEdit = ConsoleInformation->OutputEdit;
@@ -98,7 +104,7 @@ namespace
             HFONT FontHandle = ::CreateFontW(
                 -::MulDiv(
                     FontSize,
-                    ConsoleInformation->WindowDpi,
+                    ConsoleInformation->Layout.Load().WindowDpi,
                     USER_DEFAULT_SCREEN_DPI),
                 0,
                 0,
@@ -240,7 +246,7 @@ namespace
                 if (wParam == VK_TAB)
                 {
                     ConsoleInformation->FocusedEdit =
-                        (ConsoleInformation->InputEditHeight != 0)
+                        (ConsoleInformation->Layout.Load().InputEditHeight != 0)
                         ? ConsoleInformation->InputEdit
                         : ConsoleInformation->OutputEdit;
                     ::SetFocus(ConsoleInformation->FocusedEdit);
@@ -280,6 +286,9 @@ namespace
             {
                 return -1;
             }
+            MILE_ACCOUNT_ALLOCATION(
+                "Mile.PiConsole.Information",
+                sizeof(PiConsoleInformation));
 
             if (!::SetPropW(
                 hWnd,
@@ -290,7 +299,7 @@ namespace
             }
 
             ConsoleInformation->Size = sizeof(PiConsoleInformation);
-            ConsoleInformation->InputEditHeight = 0;
+            new (&ConsoleInformation->Layout) Mile::SeqLock<PiConsoleLayout>();
 
             Mile::CriticalSection::Initialize(
                 &ConsoleInformation->OperationLock);
@@ -321,11 +330,15 @@ namespace
                     ::ReleaseDC(hWnd, hDC);
                 }
             }
-            ConsoleInformation->WindowDpi = xDPI;
+            ConsoleInformation->Layout.Update([&](PiConsoleLayout& Layout)
+            {
+                Layout.WindowDpi = xDPI;
+            });
 
+            PiConsoleLayout Layout = ConsoleInformation->Layout.Load();
             int RealInputEditHeight = ::MulDiv(
-                ConsoleInformation->InputEditHeight,
-                ConsoleInformation->WindowDpi,
+                Layout.InputEditHeight,
+                Layout.WindowDpi,
                 USER_DEFAULT_SCREEN_DPI);
 
             Mile::EnableChildWindowDpiMessage(hWnd);
@@ -448,9 +461,10 @@ namespace
                 ::PiConsoleGetInformation(hWnd);
             if (ConsoleInformation)
             {
+                PiConsoleLayout Layout = ConsoleInformation->Layout.Load();
                 int RealInputEditHeight = ::MulDiv(
-                    ConsoleInformation->InputEditHeight,
-                    ConsoleInformation->WindowDpi,
+                    Layout.InputEditHeight,
+                    Layout.WindowDpi,
                     USER_DEFAULT_SCREEN_DPI);
 
                 if (ConsoleInformation->InputEdit)
@@ -488,7 +502,10 @@ namespace
                 ::PiConsoleGetInformation(hWnd);
             if (ConsoleInformation)
             {
-                ConsoleInformation->WindowDpi = HIWORD(wParam);
+                ConsoleInformation->Layout.Update([&](PiConsoleLayout& Layout)
+                {
+                    Layout.WindowDpi = HIWORD(wParam);
+                });
             }
 
             ::PiConsoleChangeFont(hWnd, 16);
@@ -535,6 +552,9 @@ namespace
                 }
 
                 ::MileFreeMemory(ConsoleInformation);
+                MILE_ACCOUNT_FREE(
+                    "Mile.PiConsole.Information",
+                    sizeof(PiConsoleInformation));
             }
 
             ::PostQuitMessage(0);
@@ -704,16 +724,30 @@ void Mile::PiConsole::PrintMessage(
 LPWSTR Mile::PiConsole::GetInput(
     _In_ HWND WindowHandle,
     _In_ LPCWSTR InputPrompt)
+{
+    Mile::UniqueBuffer<wchar_t> Input;
+    Mile::PiConsole::GetInput(WindowHandle, InputPrompt, Input);
+    return Input.Detach();
+}
+
+bool Mile::PiConsole::GetInput(
+    _In_ HWND WindowHandle,
+    _In_ LPCWSTR InputPrompt,
+    _Out_ Mile::UniqueBuffer<wchar_t>& Input)
 {
     bool Result = false;
-    wchar_t* InputBuffer = nullptr;
     PiConsoleInformation* ConsoleInformation = nullptr;
 
+    Input.Close();
+
     auto ExitHandler = Mile::ScopeExitTaskHandler([&]()
     {
         if (ConsoleInformation)
         {
-            ConsoleInformation->InputEditHeight = 0;
+            ConsoleInformation->Layout.Update([](PiConsoleLayout& Layout)
+            {
+                Layout.InputEditHeight = 0;
+            });
             ::PiConsoleRefreshLayout(WindowHandle);
 
             ::SendMessageW(
@@ -733,18 +767,14 @@ LPWSTR Mile::PiConsole::GetInput(
 
         if (!Result)
         {
-            if (InputBuffer)
-            {
-                ::MileFreeMemory(InputBuffer);
-                InputBuffer = nullptr;
-            }
+            Input.Close();
         }
     });
 
     ConsoleInformation = ::PiConsoleGetInformation(WindowHandle);
     if (!ConsoleInformation)
     {
-        return nullptr;
+        return false;
     }
 
     Mile::AutoRawCriticalSectionTryLock Guard(
@@ -764,10 +794,13 @@ LPWSTR Mile::PiConsole::GetInput(
     if (!::ResetEvent(
         ConsoleInformation->InputSignal))
     {
-        return nullptr;
+        return false;
     }
 
-    ConsoleInformation->InputEditHeight = 24;
+    ConsoleInformation->Layout.Update([](PiConsoleLayout& Layout)
+    {
+        Layout.InputEditHeight = 24;
+    });
     ::PiConsoleRefreshLayout(WindowHandle);
 
     ::WaitForSingleObjectEx(
@@ -779,16 +812,27 @@ LPWSTR Mile::PiConsole::GetInput(
         ConsoleInformation->InputEdit);
     if (TextLength)
     {
-        InputBuffer = reinterpret_cast<wchar_t*>(
-            ::MileAllocateMemory((TextLength + 1) * sizeof(wchar_t)));
-        if (InputBuffer)
+        Input.Attach(
+            reinterpret_cast<wchar_t*>(
+                ::MileAllocateMemory((TextLength + 1) * sizeof(wchar_t))),
+            0,
+            static_cast<std::size_t>(TextLength) + 1);
+        if (Input)
         {
-            Result = ::GetWindowTextW(
+            int CopiedLength = ::GetWindowTextW(
                 ConsoleInformation->InputEdit,
-                InputBuffer,
+                Input.Get(),
                 TextLength + 1);
+            Input.SetLength(static_cast<std::size_t>(CopiedLength));
+            Result = (0 != CopiedLength);
+            if (Result)
+            {
+                MILE_ACCOUNT_HANDED_OFF_ALLOCATION(
+                    "Mile.PiConsole.GetInput",
+                    (TextLength + 1) * sizeof(wchar_t));
+            }
         }
     }
 
-    return InputBuffer;
+    return Result;
 }
@@ -69,6 +69,22 @@ namespace Mile
             _In_ HWND WindowHandle,
             _In_ LPCWSTR InputPrompt);
 
+        /**
+         * @brief Gets input from a Portable Interactive Console (Pi Console)
+         *        window into a unique buffer.
+         * @param WindowHandle The handle of a Portable Interactive Console (Pi
+         *                     Console) window.
+         * @param InputPrompt The prompt you want to notice to the user.
+         * @param Input The unique buffer that receives the next line of
+         *              characters from the user input, the length of it
+         *              excludes the terminating null character.
+         * @return true if the user input is not empty, otherwise false.
+        */
+        static bool GetInput(
+            _In_ HWND WindowHandle,
+            _In_ LPCWSTR InputPrompt,
+            _Out_ Mile::UniqueBuffer<wchar_t>& Input);
+
     };
 }
 
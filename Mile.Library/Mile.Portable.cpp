@@ -10,204 +10,4844 @@
 
 #include "Mile.Portable.h"
 
-void Mile::SpiltCommandLineEx(
-    std::wstring const& CommandLine,
-    std::vector<std::wstring> const& OptionPrefixes,
-    std::vector<std::wstring> const& OptionParameterSeparators,
-    std::wstring& ApplicationName,
-    std::map<std::wstring, std::wstring>& OptionsAndParameters,
-    std::wstring& UnresolvedCommandLine)
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+#if !defined(MILE_PORTABLE_DISABLE_SIMD)
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MILE_PORTABLE_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define MILE_PORTABLE_SIMD_AVX2
+#define MILE_PORTABLE_TARGET_AVX2
+#include <immintrin.h>
+#elif defined(_MSC_VER) || defined(__GNUC__)
+// The AVX2 implementations are compiled for the processors without AVX2 too,
+// and are only called when Mile::GetPlatformInfo reports AVX2.
+#define MILE_PORTABLE_SIMD_AVX2
+#define MILE_PORTABLE_SIMD_AVX2_DISPATCH
+#if defined(_MSC_VER) && !defined(__clang__)
+#define MILE_PORTABLE_TARGET_AVX2
+#else
+#define MILE_PORTABLE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#include <immintrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define MILE_PORTABLE_SIMD_NEON
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace
 {
-    ApplicationName.clear();
-    OptionsAndParameters.clear();
-    UnresolvedCommandLine.clear();
+    /**
+     * @brief The unsigned integer type which has the same size as the
+     *        character type, for sharing the SIMD implementations between
+     *        the character types with the same code unit size.
+     * @tparam CharType The character type.
+    */
+    template<typename CharType>
+    using CodeUnitType = typename std::conditional<
+        1 == sizeof(CharType),
+        std::uint8_t,
+        typename std::conditional<
+            2 == sizeof(CharType),
+            std::uint16_t,
+            std::uint32_t>::type>::type;
 
-    size_t arg_size = 0;
-    for (auto& SplitArgument : Mile::SplitCommandLineWideString(CommandLine))
+    template<typename CharType>
+    static bool IsCommandArgumentsEnd(
+        CharType const* Current,
+        CharType const* End)
     {
-        // We need to process the application name at the beginning.
-        if (ApplicationName.empty())
-        {
-            // For getting the unresolved command line, we need to cumulate
-            // length which including spaces.
-            arg_size += SplitArgument.size() + 1;
+        return Current == End || 0 == *Current;
+    }
 
-            // Save
-            ApplicationName = SplitArgument;
+    template<typename CharType>
+    static CharType const* SkipCommandArgumentDelimiters(
+        CharType const* Current,
+        CharType const* End)
+    {
+        while (Current != End && (' ' == *Current || '\t' == *Current))
+        {
+            ++Current;
         }
-        else
+
+        return Current;
+    }
+
+    template<typename CharType>
+    static CharType ToLowerAscii(
+        CharType Character)
+    {
+        return (Character >= 'A' && Character <= 'Z')
+            ? static_cast<CharType>(Character - 'A' + 'a')
+            : Character;
+    }
+
+    /**
+     * @brief Checks whether the string starts with the prefix, the comparison
+     *        is case-insensitive for ASCII letters like _wcsnicmp in the "C"
+     *        locale.
+     * @param Value The string to check.
+     * @param Prefix The prefix to compare.
+     * @return true if the string starts with the prefix, otherwise false.
+    */
+    template<typename CharType>
+    static bool StartsWithIgnoreCase(
+        Mile::BasicStringSpan<CharType> const& Value,
+        Mile::BasicStringSpan<CharType> const& Prefix)
+    {
+        if (Value.Size() < Prefix.Size())
         {
-            bool IsOption = false;
-            size_t OptionPrefixLength = 0;
+            return false;
+        }
 
-            for (auto& OptionPrefix : OptionPrefixes)
+        for (std::size_t i = 0; i < Prefix.Size(); ++i)
+        {
+            if (::ToLowerAscii(Value[i]) != ::ToLowerAscii(Prefix[i]))
             {
-                if (0 == _wcsnicmp(
-                    SplitArgument.c_str(),
-                    OptionPrefix.c_str(),
-                    OptionPrefix.size()))
-                {
-                    IsOption = true;
-                    OptionPrefixLength = OptionPrefix.size();
-                }
+                return false;
             }
+        }
+
+        return true;
+    }
 
-            if (IsOption)
+    /**
+     * @brief Compares two strings, the comparison is case-insensitive for
+     *        ASCII letters like _wcsnicmp in the "C" locale.
+     * @param Left The first string to compare.
+     * @param Right The second string to compare.
+     * @return A negative value if Left is less than Right, zero if they are
+     *         equal, otherwise a positive value.
+    */
+    template<typename CharType>
+    static int CompareIgnoreCase(
+        Mile::BasicStringSpan<CharType> const& Left,
+        Mile::BasicStringSpan<CharType> const& Right)
+    {
+        std::size_t Length = (std::min)(Left.Size(), Right.Size());
+        for (std::size_t i = 0; i < Length; ++i)
+        {
+            CodeUnitType<CharType> LeftCharacter =
+                ::ToLowerAscii(static_cast<CodeUnitType<CharType>>(Left[i]));
+            CodeUnitType<CharType> RightCharacter =
+                ::ToLowerAscii(static_cast<CodeUnitType<CharType>>(Right[i]));
+            if (LeftCharacter != RightCharacter)
             {
-                // For getting the unresolved command line, we need to cumulate
-                // length which including spaces.
-                arg_size += SplitArgument.size() + 1;
+                return LeftCharacter < RightCharacter ? -1 : 1;
+            }
+        }
+
+        if (Left.Size() == Right.Size())
+        {
+            return 0;
+        }
 
-                // Get the option name and parameter.
+        return Left.Size() < Right.Size() ? -1 : 1;
+    }
 
-                wchar_t* OptionStart = &SplitArgument[0] + OptionPrefixLength;
-                wchar_t* ParameterStart = nullptr;
+    template<typename CodeUnit>
+    static bool IsCommandArgumentSpecialCharacter(
+        CodeUnit Character)
+    {
+        return 0 == Character
+            || ' ' == Character
+            || '\t' == Character
+            || '\\' == Character
+            || '"' == Character;
+    }
 
-                for (auto& OptionParameterSeparator
-                    : OptionParameterSeparators)
-                {
-                    wchar_t* Result = wcsstr(
-                        OptionStart,
-                        OptionParameterSeparator.c_str());
-                    if (nullptr == Result)
-                    {
-                        continue;
-                    }
+    template<typename CodeUnit>
+    static CodeUnit const* FindCommandArgumentSpecialCharacterScalar(
+        CodeUnit const* Current,
+        CodeUnit const* End)
+    {
+        while (Current != End && !::IsCommandArgumentSpecialCharacter(*Current))
+        {
+            ++Current;
+        }
+
+        return Current;
+    }
 
-                    Result[0] = L'\0';
-                    ParameterStart = Result + OptionParameterSeparator.size();
+#if defined(MILE_PORTABLE_SIMD_SSE2) || defined(MILE_PORTABLE_SIMD_NEON)
 
-                    break;
-                }
+    static unsigned long CountTrailingZeroBits(
+        std::uint64_t Value)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long Index = 0;
+        ::_BitScanForward64(&Index, Value);
+        return Index;
+#elif defined(_MSC_VER)
+        unsigned long Index = 0;
+        if (::_BitScanForward(&Index, static_cast<unsigned long>(Value)))
+        {
+            return Index;
+        }
+        ::_BitScanForward(&Index, static_cast<unsigned long>(Value >> 32));
+        return Index + 32;
+#else
+        return static_cast<unsigned long>(__builtin_ctzll(Value));
+#endif
+    }
+
+#endif
+
+#if defined(MILE_PORTABLE_SIMD_SSE2)
+
+#if defined(MILE_PORTABLE_SIMD_AVX2)
+
+    static bool IsAvx2Available() noexcept
+    {
+#if defined(MILE_PORTABLE_SIMD_AVX2_DISPATCH)
+        // Read from the platform snapshot on the first use, so the snapshot
+        // is not taken during the static initialization.
+        static const bool Available = Mile::GetPlatformInfo().HasAvx2;
+        return Available;
+#else
+        return true;
+#endif
+    }
 
-                // Save
-                OptionsAndParameters[(OptionStart ? OptionStart : L"")] =
-                    (ParameterStart ? ParameterStart : L"");
+    /**
+     * @brief Skips the 32-byte blocks without the special code units with the
+     *        AVX2 instructions.
+     * @return true if a special code unit is found, and Current points to
+     *         it. Otherwise false, and Current points to the remaining code
+     *         units which are less than 32 bytes.
+    */
+    MILE_PORTABLE_TARGET_AVX2
+    static bool FindCommandArgumentSpecialCodeUnitAvx2(
+        std::uint8_t const*& Current,
+        std::uint8_t const* End)
+    {
+        __m256i const Spaces256 = ::_mm256_set1_epi8(' ');
+        __m256i const Tabs256 = ::_mm256_set1_epi8('\t');
+        __m256i const Backslashes256 = ::_mm256_set1_epi8('\\');
+        __m256i const Quotes256 = ::_mm256_set1_epi8('"');
+        __m256i const Zeros256 = ::_mm256_setzero_si256();
+        while (End - Current >= 32)
+        {
+            __m256i Block = ::_mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(Current));
+            __m256i Matches = ::_mm256_or_si256(
+                ::_mm256_or_si256(
+                    ::_mm256_cmpeq_epi8(Block, Spaces256),
+                    ::_mm256_cmpeq_epi8(Block, Tabs256)),
+                ::_mm256_or_si256(
+                    ::_mm256_cmpeq_epi8(Block, Backslashes256),
+                    ::_mm256_cmpeq_epi8(Block, Quotes256)));
+            Matches = ::_mm256_or_si256(
+                Matches,
+                ::_mm256_cmpeq_epi8(Block, Zeros256));
+            std::uint32_t Mask = static_cast<std::uint32_t>(
+                ::_mm256_movemask_epi8(Matches));
+            if (Mask)
+            {
+                Current += ::CountTrailingZeroBits(Mask);
+                return true;
             }
-            else
+            Current += 32;
+        }
+
+        return false;
+    }
+
+#endif
+
+    static std::uint8_t const* FindCommandArgumentSpecialCodeUnit(
+        std::uint8_t const* Current,
+        std::uint8_t const* End)
+    {
+#if defined(MILE_PORTABLE_SIMD_AVX2)
+        if (::IsAvx2Available() &&
+            ::FindCommandArgumentSpecialCodeUnitAvx2(Current, End))
+        {
+            return Current;
+        }
+#endif
+        __m128i const Spaces = ::_mm_set1_epi8(' ');
+        __m128i const Tabs = ::_mm_set1_epi8('\t');
+        __m128i const Backslashes = ::_mm_set1_epi8('\\');
+        __m128i const Quotes = ::_mm_set1_epi8('"');
+        __m128i const Zeros = ::_mm_setzero_si128();
+        while (End - Current >= 16)
+        {
+            __m128i Block = ::_mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(Current));
+            __m128i Matches = ::_mm_or_si128(
+                ::_mm_or_si128(
+                    ::_mm_cmpeq_epi8(Block, Spaces),
+                    ::_mm_cmpeq_epi8(Block, Tabs)),
+                ::_mm_or_si128(
+                    ::_mm_cmpeq_epi8(Block, Backslashes),
+                    ::_mm_cmpeq_epi8(Block, Quotes)));
+            Matches = ::_mm_or_si128(Matches, ::_mm_cmpeq_epi8(Block, Zeros));
+            std::uint32_t Mask = static_cast<std::uint32_t>(
+                ::_mm_movemask_epi8(Matches));
+            if (Mask)
             {
-                // Get the approximate location of the unresolved command line.
-                // We use "(arg_size - 1)" to ensure that the program path
-                // without quotes can also correctly parse.
-                wchar_t* search_start =
-                    const_cast<wchar_t*>(CommandLine.c_str()) + (arg_size - 1);
+                return Current + ::CountTrailingZeroBits(Mask);
+            }
+            Current += 16;
+        }
 
-                // Get the unresolved command line. Search for the beginning of
-                // the first parameter delimiter called space and exclude the
-                // first space by adding 1 to the result.
-                wchar_t* command = wcsstr(search_start, L" ") + 1;
+        return ::FindCommandArgumentSpecialCharacterScalar(Current, End);
+    }
 
-                // Omit the space. (Thanks to wzzw.)
-                while (command && *command == L' ')
-                {
-                    ++command;
-                }
+#if defined(MILE_PORTABLE_SIMD_AVX2)
 
-                // Save
-                if (command)
-                {
-                    UnresolvedCommandLine = command;
-                }
+    MILE_PORTABLE_TARGET_AVX2
+    static bool FindCommandArgumentSpecialCodeUnitAvx2(
+        std::uint16_t const*& Current,
+        std::uint16_t const* End)
+    {
+        __m256i const Spaces256 = ::_mm256_set1_epi16(' ');
+        __m256i const Tabs256 = ::_mm256_set1_epi16('\t');
+        __m256i const Backslashes256 = ::_mm256_set1_epi16('\\');
+        __m256i const Quotes256 = ::_mm256_set1_epi16('"');
+        __m256i const Zeros256 = ::_mm256_setzero_si256();
+        while (End - Current >= 16)
+        {
+            __m256i Block = ::_mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(Current));
+            __m256i Matches = ::_mm256_or_si256(
+                ::_mm256_or_si256(
+                    ::_mm256_cmpeq_epi16(Block, Spaces256),
+                    ::_mm256_cmpeq_epi16(Block, Tabs256)),
+                ::_mm256_or_si256(
+                    ::_mm256_cmpeq_epi16(Block, Backslashes256),
+                    ::_mm256_cmpeq_epi16(Block, Quotes256)));
+            Matches = ::_mm256_or_si256(
+                Matches,
+                ::_mm256_cmpeq_epi16(Block, Zeros256));
+            std::uint32_t Mask = static_cast<std::uint32_t>(
+                ::_mm256_movemask_epi8(Matches));
+            if (Mask)
+            {
+                Current += ::CountTrailingZeroBits(Mask) / 2;
+                return true;
+            }
+            Current += 16;
+        }
 
-                break;
+        return false;
+    }
+
+#endif
+
+    static std::uint16_t const* FindCommandArgumentSpecialCodeUnit(
+        std::uint16_t const* Current,
+        std::uint16_t const* End)
+    {
+#if defined(MILE_PORTABLE_SIMD_AVX2)
+        if (::IsAvx2Available() &&
+            ::FindCommandArgumentSpecialCodeUnitAvx2(Current, End))
+        {
+            return Current;
+        }
+#endif
+        __m128i const Spaces = ::_mm_set1_epi16(' ');
+        __m128i const Tabs = ::_mm_set1_epi16('\t');
+        __m128i const Backslashes = ::_mm_set1_epi16('\\');
+        __m128i const Quotes = ::_mm_set1_epi16('"');
+        __m128i const Zeros = ::_mm_setzero_si128();
+        while (End - Current >= 8)
+        {
+            __m128i Block = ::_mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(Current));
+            __m128i Matches = ::_mm_or_si128(
+                ::_mm_or_si128(
+                    ::_mm_cmpeq_epi16(Block, Spaces),
+                    ::_mm_cmpeq_epi16(Block, Tabs)),
+                ::_mm_or_si128(
+                    ::_mm_cmpeq_epi16(Block, Backslashes),
+                    ::_mm_cmpeq_epi16(Block, Quotes)));
+            Matches = ::_mm_or_si128(Matches, ::_mm_cmpeq_epi16(Block, Zeros));
+            std::uint32_t Mask = static_cast<std::uint32_t>(
+                ::_mm_movemask_epi8(Matches));
+            if (Mask)
+            {
+                return Current + ::CountTrailingZeroBits(Mask) / 2;
             }
+            Current += 8;
         }
+
+        return ::FindCommandArgumentSpecialCharacterScalar(Current, End);
     }
-}
 
-std::vector<std::wstring> Mile::SpiltCommandArguments(
-    std::wstring const& Arguments)
-{
-    // Initialize the SplitArguments.
-    std::vector<std::wstring> SplitArguments;
+    static std::uint32_t const* FindCommandArgumentSpecialCodeUnit(
+        std::uint32_t const* Current,
+        std::uint32_t const* End)
+    {
+        __m128i const Spaces = ::_mm_set1_epi32(' ');
+        __m128i const Tabs = ::_mm_set1_epi32('\t');
+        __m128i const Backslashes = ::_mm_set1_epi32('\\');
+        __m128i const Quotes = ::_mm_set1_epi32('"');
+        __m128i const Zeros = ::_mm_setzero_si128();
+        while (End - Current >= 4)
+        {
+            __m128i Block = ::_mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(Current));
+            __m128i Matches = ::_mm_or_si128(
+                ::_mm_or_si128(
+                    ::_mm_cmpeq_epi32(Block, Spaces),
+                    ::_mm_cmpeq_epi32(Block, Tabs)),
+                ::_mm_or_si128(
+                    ::_mm_cmpeq_epi32(Block, Backslashes),
+                    ::_mm_cmpeq_epi32(Block, Quotes)));
+            Matches = ::_mm_or_si128(Matches, ::_mm_cmpeq_epi32(Block, Zeros));
+            std::uint32_t Mask = static_cast<std::uint32_t>(
+                ::_mm_movemask_epi8(Matches));
+            if (Mask)
+            {
+                return Current + ::CountTrailingZeroBits(Mask) / 4;
+            }
+            Current += 4;
+        }
+
+        return ::FindCommandArgumentSpecialCharacterScalar(Current, End);
+    }
+
+#elif defined(MILE_PORTABLE_SIMD_NEON)
 
-    int copy_character;                   /* 1 = copy char to *args */
-    unsigned numslash;              /* num of backslashes seen */
+    static std::uint8_t const* FindCommandArgumentSpecialCodeUnit(
+        std::uint8_t const* Current,
+        std::uint8_t const* End)
+    {
+        uint8x16_t const Spaces = ::vdupq_n_u8(' ');
+        uint8x16_t const Tabs = ::vdupq_n_u8('\t');
+        uint8x16_t const Backslashes = ::vdupq_n_u8('\\');
+        uint8x16_t const Quotes = ::vdupq_n_u8('"');
+        uint8x16_t const Zeros = ::vdupq_n_u8(0);
+        while (End - Current >= 16)
+        {
+            uint8x16_t Block = ::vld1q_u8(Current);
+            uint8x16_t Matches = ::vorrq_u8(
+                ::vorrq_u8(
+                    ::vceqq_u8(Block, Spaces),
+                    ::vceqq_u8(Block, Tabs)),
+                ::vorrq_u8(
+                    ::vceqq_u8(Block, Backslashes),
+                    ::vceqq_u8(Block, Quotes)));
+            Matches = ::vorrq_u8(Matches, ::vceqq_u8(Block, Zeros));
+            // Narrow each 8-bit lane to 4 bits for getting a 64-bit mask.
+            std::uint64_t Mask = ::vget_lane_u64(
+                ::vreinterpret_u64_u8(::vshrn_n_u16(
+                    ::vreinterpretq_u16_u8(Matches),
+                    4)),
+                0);
+            if (Mask)
+            {
+                return Current + ::CountTrailingZeroBits(Mask) / 4;
+            }
+            Current += 16;
+        }
 
-    std::wstring Buffer;
-    Buffer.reserve(Arguments.size());
+        return ::FindCommandArgumentSpecialCharacterScalar(Current, End);
+    }
 
-    /* first scan the program name, copy it, and count the bytes */
-    wchar_t* p = const_cast<wchar_t*>(Arguments.c_str());
+    static std::uint16_t const* FindCommandArgumentSpecialCodeUnit(
+        std::uint16_t const* Current,
+        std::uint16_t const* End)
+    {
+        uint16x8_t const Spaces = ::vdupq_n_u16(' ');
+        uint16x8_t const Tabs = ::vdupq_n_u16('\t');
+        uint16x8_t const Backslashes = ::vdupq_n_u16('\\');
+        uint16x8_t const Quotes = ::vdupq_n_u16('"');
+        uint16x8_t const Zeros = ::vdupq_n_u16(0);
+        while (End - Current >= 8)
+        {
+            uint16x8_t Block = ::vld1q_u16(Current);
+            uint16x8_t Matches = ::vorrq_u16(
+                ::vorrq_u16(
+                    ::vceqq_u16(Block, Spaces),
+                    ::vceqq_u16(Block, Tabs)),
+                ::vorrq_u16(
+                    ::vceqq_u16(Block, Backslashes),
+                    ::vceqq_u16(Block, Quotes)));
+            Matches = ::vorrq_u16(Matches, ::vceqq_u16(Block, Zeros));
+            // Narrow each 16-bit lane to 8 bits for getting a 64-bit mask.
+            std::uint64_t Mask = ::vget_lane_u64(
+                ::vreinterpret_u64_u8(::vshrn_n_u16(Matches, 4)),
+                0);
+            if (Mask)
+            {
+                return Current + ::CountTrailingZeroBits(Mask) / 8;
+            }
+            Current += 8;
+        }
 
-    bool InQuotes = false;
+        return ::FindCommandArgumentSpecialCharacterScalar(Current, End);
+    }
 
-    // Loop on each argument
-    for (;;)
+    static std::uint32_t const* FindCommandArgumentSpecialCodeUnit(
+        std::uint32_t const* Current,
+        std::uint32_t const* End)
     {
-        if (*p)
+        uint32x4_t const Spaces = ::vdupq_n_u32(' ');
+        uint32x4_t const Tabs = ::vdupq_n_u32('\t');
+        uint32x4_t const Backslashes = ::vdupq_n_u32('\\');
+        uint32x4_t const Quotes = ::vdupq_n_u32('"');
+        uint32x4_t const Zeros = ::vdupq_n_u32(0);
+        while (End - Current >= 4)
         {
-            while (*p == ' ' || *p == '\t')
-                ++p;
+            uint32x4_t Block = ::vld1q_u32(Current);
+            uint32x4_t Matches = ::vorrq_u32(
+                ::vorrq_u32(
+                    ::vceqq_u32(Block, Spaces),
+                    ::vceqq_u32(Block, Tabs)),
+                ::vorrq_u32(
+                    ::vceqq_u32(Block, Backslashes),
+                    ::vceqq_u32(Block, Quotes)));
+            Matches = ::vorrq_u32(Matches, ::vceqq_u32(Block, Zeros));
+            // Narrow each 32-bit lane to 16 bits for getting a 64-bit mask.
+            std::uint64_t Mask = ::vget_lane_u64(
+                ::vreinterpret_u64_u16(::vshrn_n_u32(Matches, 16)),
+                0);
+            if (Mask)
+            {
+                return Current + ::CountTrailingZeroBits(Mask) / 16;
+            }
+            Current += 4;
         }
 
-        // End of arguments
-        if (*p == '\0')
-            break;
+        return ::FindCommandArgumentSpecialCharacterScalar(Current, End);
+    }
+
+#else
+
+    template<typename CodeUnit>
+    static CodeUnit const* FindCommandArgumentSpecialCodeUnit(
+        CodeUnit const* Current,
+        CodeUnit const* End)
+    {
+        return ::FindCommandArgumentSpecialCharacterScalar(Current, End);
+    }
+
+#endif
+
+    /**
+     * @brief Finds the first character which needs the special handling when
+     *        scanning the arguments, which are the null character, spaces,
+     *        tabs, backslashes and quotes. Long runs of ordinary characters
+     *        are skipped with SIMD instructions if possible. UTF-8 strings are
+     *        also safe because all special characters are ASCII characters.
+     * @param Current The pointer to the first character to search.
+     * @param End The pointer to the end of the command arguments string.
+     * @return The pointer to the first special character, or End if not found.
+    */
+    template<typename CharType>
+    static CharType const* FindCommandArgumentSpecialCharacter(
+        CharType const* Current,
+        CharType const* End)
+    {
+        using UnitType = CodeUnitType<CharType>;
 
-        // Initialize the argument buffer.
-        Buffer.clear();
+        return reinterpret_cast<CharType const*>(
+            ::FindCommandArgumentSpecialCodeUnit(
+                reinterpret_cast<UnitType const*>(Current),
+                reinterpret_cast<UnitType const*>(End)));
+    }
+
+    /**
+     * @brief Scans one argument from the command arguments string in a way
+     *        that is similar to the standard C run-time.
+     * @param Current The pointer to the first character of the argument, it
+     *                should not be a delimiter or the end of the string.
+     * @param End The pointer to the end of the command arguments string.
+     * @param Output The buffer which receives the unescaped argument. If this
+     *               parameter is nullptr, the function only computes the
+     *               length of the unescaped argument.
+     * @param Length The length of the unescaped argument.
+     * @return The pointer to the character following the argument.
+    */
+    template<typename CharType>
+    static CharType const* ScanCommandArgument(
+        CharType const* Current,
+        CharType const* End,
+        CharType* Output,
+        std::size_t& Length)
+    {
+        bool InQuotes = false;
+
+        Length = 0;
 
-        // Loop through scanning one argument:
         for (;;)
         {
-            copy_character = 1;
+            // Copy the run of ordinary characters at once, because they will
+            // be copied literally whether or not they are inside quotes.
+            CharType const* OrdinaryEnd =
+                ::FindCommandArgumentSpecialCharacter(Current, End);
+            if (Output)
+            {
+                std::memcpy(
+                    Output + Length,
+                    Current,
+                    (OrdinaryEnd - Current) * sizeof(CharType));
+            }
+            Length += OrdinaryEnd - Current;
+            Current = OrdinaryEnd;
+
+            bool CopyCharacter = true;
 
             // Rules: 2N backslashes + " ==> N backslashes and begin/end quote
             // 2N + 1 backslashes + " ==> N backslashes + literal " N
             // backslashes ==> N backslashes
-            numslash = 0;
-
-            while (*p == '\\')
+            std::size_t BackslashCount = 0;
+            while (Current != End && '\\' == *Current)
             {
                 // Count number of backslashes for use below
-                ++p;
-                ++numslash;
+                ++Current;
+                ++BackslashCount;
             }
 
-            if (*p == '"')
+            bool IsEnd = ::IsCommandArgumentsEnd(Current, End);
+
+            if (!IsEnd && '"' == *Current)
             {
                 // if 2N backslashes before, start/end quote, otherwise copy
                 // literally:
-                if (numslash % 2 == 0)
+                if (0 == BackslashCount % 2)
                 {
-                    if (InQuotes && p[1] == '"')
+                    if (InQuotes && Current + 1 != End && '"' == Current[1])
                     {
-                        p++; // Double quote inside quoted string
+                        // Double quote inside quoted string
+                        ++Current;
                     }
                     else
                     {
                         // Skip first quote char and copy second:
-                        copy_character = 0; // Don't copy quote
+                        CopyCharacter = false;
                         InQuotes = !InQuotes;
                     }
                 }
 
-                numslash /= 2;
+                BackslashCount /= 2;
             }
 
             // Copy slashes:
-            while (numslash--)
+            if (Output)
             {
-                Buffer.push_back(L'\\');
+                for (std::size_t i = 0; i < BackslashCount; ++i)
+                {
+                    Output[Length + i] = static_cast<CharType>('\\');
+                }
             }
+            Length += BackslashCount;
 
             // If at end of arg, break loop:
-            if (*p == '\0' || (!InQuotes && (*p == ' ' || *p == '\t')))
+            if (IsEnd || (!InQuotes && (' ' == *Current || '\t' == *Current)))
+            {
                 break;
+            }
 
             // Copy character into argument:
-            if (copy_character)
+            if (CopyCharacter)
             {
-                Buffer.push_back(*p);
+                if (Output)
+                {
+                    Output[Length] = *Current;
+                }
+                ++Length;
             }
 
-            ++p;
+            ++Current;
         }
 
-        // Save te argument.
-        SplitArguments.push_back(Buffer);
+        return Current;
     }
 
-    return SplitArguments;
+    template<typename CharType>
+    static Mile::BasicStringSpan<CharType> ToStringSpan(
+        std::basic_string<CharType> const& Value)
+    {
+        return Mile::BasicStringSpan<CharType>(Value);
+    }
+
+    template<typename CharType>
+    static Mile::BasicStringSpan<CharType> ToStringSpan(
+        Mile::BasicStringSpan<CharType> const& Value)
+    {
+        return Value;
+    }
+
+    template<typename CharType>
+    static Mile::BasicStringSpan<CharType> ToStringSpan(
+        CharType const* Value)
+    {
+        return Mile::BasicStringSpan<CharType>(
+            Value,
+            std::char_traits<CharType>::length(Value));
+    }
+
+    /**
+     * @brief Checks whether the string equals to the ASCII string, the
+     *        comparison is case-insensitive for ASCII letters.
+     * @param Value The string to check.
+     * @param Expected The null-terminated ASCII string to compare.
+     * @return true if the strings are equal, otherwise false.
+    */
+    template<typename CharType>
+    static bool EqualsAsciiIgnoreCase(
+        Mile::BasicStringSpan<CharType> const& Value,
+        char const* Expected)
+    {
+        std::size_t Index = 0;
+        for (; Index < Value.Size(); ++Index)
+        {
+            if (!Expected[Index] ||
+                ::ToLowerAscii(Value[Index]) !=
+                static_cast<CharType>(::ToLowerAscii(Expected[Index])))
+            {
+                return false;
+            }
+        }
+        return !Expected[Index];
+    }
+
+    /**
+     * @brief Parses the digits of an unsigned integer.
+     * @param Current The pointer to the first digit.
+     * @param End The pointer past the end of the string.
+     * @param Base The base of the integer, which can be 10 or 16.
+     * @param Result The parsed integer value.
+     * @return The pointer to the first non-digit character, or nullptr if
+     *         there are no digits or the value overflows.
+    */
+    template<typename CharType>
+    static CharType const* ParseUnsignedDigits(
+        CharType const* Current,
+        CharType const* End,
+        unsigned Base,
+        std::uint64_t& Result)
+    {
+        CharType const* const Start = Current;
+        std::uint64_t Value = 0;
+        for (; Current != End; ++Current)
+        {
+            unsigned Digit = 0;
+            if (*Current >= '0' && *Current <= '9')
+            {
+                Digit = static_cast<unsigned>(*Current - '0');
+            }
+            else if (16 == Base && *Current >= 'a' && *Current <= 'f')
+            {
+                Digit = static_cast<unsigned>(*Current - 'a' + 10);
+            }
+            else if (16 == Base && *Current >= 'A' && *Current <= 'F')
+            {
+                Digit = static_cast<unsigned>(*Current - 'A' + 10);
+            }
+            else
+            {
+                break;
+            }
+
+            if (Value > (UINT64_MAX - Digit) / Base)
+            {
+                return nullptr;
+            }
+            Value = Value * Base + Digit;
+        }
+
+        if (Current == Start)
+        {
+            return nullptr;
+        }
+
+        Result = Value;
+        return Current;
+    }
+
+    /**
+     * @brief The range of an array, for iterating the arrays with the
+     *        range-based for loop.
+     * @tparam ElementType The element type of the array.
+    */
+    template<typename ElementType>
+    struct ArrayRange
+    {
+        ElementType const* First;
+        ElementType const* Last;
+
+        ElementType const* begin() const
+        {
+            return this->First;
+        }
+
+        ElementType const* end() const
+        {
+            return this->Last;
+        }
+    };
+
+    /**
+     * @brief Quotes one argument for the command line in a way that is the
+     *        inverse of ScanCommandArgument.
+     * @param Argument The argument to quote.
+     * @param Output The buffer which receives the quoted argument. If this
+     *               parameter is nullptr, the function only computes the
+     *               length of the quoted argument.
+     * @return The length of the quoted argument.
+    */
+    template<typename CharType>
+    static std::size_t QuoteCommandArgument(
+        Mile::BasicStringSpan<CharType> const& Argument,
+        CharType* Output)
+    {
+        CharType const* Current = Argument.begin();
+        CharType const* const End = Argument.end();
+
+        bool NeedQuotes = Argument.Empty();
+        for (CharType const* Character = Current; Character != End; ++Character)
+        {
+            if (' ' == *Character || '\t' == *Character)
+            {
+                NeedQuotes = true;
+                break;
+            }
+        }
+
+        std::size_t Length = 0;
+
+        if (NeedQuotes)
+        {
+            if (Output)
+            {
+                Output[Length] = static_cast<CharType>('"');
+            }
+            ++Length;
+        }
+
+        for (;;)
+        {
+            // Copy the run of ordinary characters at once, because they are
+            // not changed by quoting.
+            CharType const* OrdinaryEnd =
+                ::FindCommandArgumentSpecialCharacter(Current, End);
+            if (Output)
+            {
+                std::memcpy(
+                    Output + Length,
+                    Current,
+                    (OrdinaryEnd - Current) * sizeof(CharType));
+            }
+            Length += OrdinaryEnd - Current;
+            Current = OrdinaryEnd;
+
+            std::size_t BackslashCount = 0;
+            while (Current != End && '\\' == *Current)
+            {
+                ++Current;
+                ++BackslashCount;
+            }
+
+            // Rules: N backslashes + " ==> 2N + 1 backslashes + "
+            // N backslashes + closing quote ==> 2N backslashes + closing quote
+            // N backslashes ==> N backslashes
+            if (Current == End)
+            {
+                if (NeedQuotes)
+                {
+                    BackslashCount *= 2;
+                }
+            }
+            else if ('"' == *Current)
+            {
+                BackslashCount = BackslashCount * 2 + 1;
+            }
+
+            if (Output)
+            {
+                for (std::size_t i = 0; i < BackslashCount; ++i)
+                {
+                    Output[Length + i] = static_cast<CharType>('\\');
+                }
+            }
+            Length += BackslashCount;
+
+            if (Current == End)
+            {
+                break;
+            }
+
+            // Copy the quote, space, tab or null character.
+            if (Output)
+            {
+                Output[Length] = *Current;
+            }
+            ++Length;
+            ++Current;
+        }
+
+        if (NeedQuotes)
+        {
+            if (Output)
+            {
+                Output[Length] = static_cast<CharType>('"');
+            }
+            ++Length;
+        }
+
+        return Length;
+    }
+
+    /**
+     * @brief Builds a command line string from the command arguments.
+     * @param Arguments The range of the command arguments, each element is a
+     *                  string or a string span.
+     * @param Output The buffer which receives the command line. If this
+     *               parameter is nullptr, the function only computes the
+     *               length of the command line.
+     * @return The length of the command line.
+    */
+    template<typename CharType, typename ArgumentRangeType>
+    static std::size_t BuildCommandLineString(
+        ArgumentRangeType const& Arguments,
+        CharType* Output)
+    {
+        std::size_t Length = 0;
+        bool First = true;
+        for (auto const& Argument : Arguments)
+        {
+            if (!First)
+            {
+                if (Output)
+                {
+                    Output[Length] = static_cast<CharType>(' ');
+                }
+                ++Length;
+            }
+            First = false;
+
+            Length += ::QuoteCommandArgument(
+                ::ToStringSpan<CharType>(Argument),
+                Output ? Output + Length : nullptr);
+        }
+        return Length;
+    }
+
+    /**
+     * @brief Parses a command line string into the options in the source
+     *        order, which is shared by all overloads of
+     *        Mile::SpiltCommandLineEx.
+     * @param CommandLine The pointer to the command line string.
+     * @param Length The length of the command line string.
+     * @param OptionPrefixes The range of the prefixes of option, each element
+     *                       is a string or a null-terminated string pointer.
+     * @param OptionParameterSeparators The range of the separators of option,
+     *                                  each element is a string or a
+     *                                  null-terminated string pointer.
+     * @param Buffer The buffer which receives all strings of the result.
+     * @param ApplicationName The application name.
+     * @param Options The options and parameters in the source order, which
+     *                may contain the same option name more than once.
+     * @param UnresolvedCommandLine The unresolved command line.
+    */
+    template<
+        typename CharType,
+        typename PrefixRangeType,
+        typename SeparatorRangeType>
+    static void ParseCommandLineOptions(
+        CharType const* CommandLine,
+        std::size_t Length,
+        PrefixRangeType const& OptionPrefixes,
+        SeparatorRangeType const& OptionParameterSeparators,
+        std::unique_ptr<CharType[]>& Buffer,
+        Mile::BasicStringSpan<CharType>& ApplicationName,
+        std::vector<typename Mile::BasicCommandLineOptions<
+            CharType>::EntryType>& Options,
+        Mile::BasicStringSpan<CharType>& UnresolvedCommandLine)
+    {
+        using StringSpanType = Mile::BasicStringSpan<CharType>;
+
+        // The unescaped arguments never exceed the length of their source, and
+        // the unresolved command line is copied from the rest of the source, so
+        // the buffer with the length of the source is enough for everything.
+        Buffer.reset(new CharType[Length + 1]);
+        CharType* Current = Buffer.get();
+
+        ApplicationName = StringSpanType();
+        Options.clear();
+        UnresolvedCommandLine = StringSpanType();
+
+        Mile::BasicCommandArgumentRange<CharType> Arguments(
+            CommandLine,
+            Length);
+        auto Iterator = Arguments.begin();
+
+        // We need to process the application name at the beginning.
+        if (Iterator != Arguments.end())
+        {
+            std::memcpy(
+                Current,
+                Iterator->Data(),
+                Iterator->Size() * sizeof(CharType));
+            ApplicationName = StringSpanType(Current, Iterator->Size());
+            Current += Iterator->Size();
+            ++Iterator;
+        }
+
+        for (; Iterator != Arguments.end(); ++Iterator)
+        {
+            StringSpanType const& Argument = *Iterator;
+
+            bool IsOption = false;
+            std::size_t OptionPrefixLength = 0;
+
+            for (auto const& OptionPrefix : OptionPrefixes)
+            {
+                StringSpanType Prefix = ::ToStringSpan<CharType>(OptionPrefix);
+                if (::StartsWithIgnoreCase(Argument, Prefix))
+                {
+                    IsOption = true;
+                    OptionPrefixLength = Prefix.Size();
+                }
+            }
+
+            if (!IsOption)
+            {
+                // The unresolved command line starts exactly at the source of
+                // the first non-option argument, and we don't need to decode
+                // the rest.
+                CharType const* UnresolvedStart =
+                    CommandLine + Iterator.SourceOffset();
+                std::size_t UnresolvedLength = std::find(
+                    UnresolvedStart,
+                    CommandLine + Length,
+                    static_cast<CharType>('\0')) - UnresolvedStart;
+                std::memcpy(
+                    Current,
+                    UnresolvedStart,
+                    UnresolvedLength * sizeof(CharType));
+                UnresolvedCommandLine = StringSpanType(
+                    Current,
+                    UnresolvedLength);
+                break;
+            }
+
+            // The argument may refer to the source or the buffer of the range,
+            // so it needs to be copied before decoding the next argument.
+            std::memcpy(
+                Current,
+                Argument.Data(),
+                Argument.Size() * sizeof(CharType));
+            CharType const* ArgumentStart = Current;
+            Current += Argument.Size();
+            CharType const* ArgumentEnd = Current;
+
+            // Get the option name and parameter.
+
+            CharType const* OptionStart = ArgumentStart + OptionPrefixLength;
+            CharType const* OptionEnd = ArgumentEnd;
+            CharType const* ParameterStart = OptionEnd;
+
+            for (auto const& OptionParameterSeparator
+                : OptionParameterSeparators)
+            {
+                StringSpanType Separator =
+                    ::ToStringSpan<CharType>(OptionParameterSeparator);
+                CharType const* SeparatorStart = std::search(
+                    OptionStart,
+                    ArgumentEnd,
+                    Separator.begin(),
+                    Separator.end());
+                if (SeparatorStart == ArgumentEnd && !Separator.Empty())
+                {
+                    continue;
+                }
+
+                OptionEnd = SeparatorStart;
+                ParameterStart = SeparatorStart + Separator.Size();
+
+                break;
+            }
+
+            // Save
+            Options.emplace_back(
+                StringSpanType(OptionStart, OptionEnd - OptionStart),
+                StringSpanType(
+                    ParameterStart,
+                    ArgumentEnd - ParameterStart));
+        }
+    }
+
+    /**
+     * @brief Parses a command line string and get more friendly result, which
+     *        is shared by the overloads of Mile::SpiltCommandLineEx returning
+     *        Mile::BasicCommandLineOptions.
+     * @param CommandLine The pointer to the command line string.
+     * @param Length The length of the command line string.
+     * @param OptionPrefixes The range of the prefixes of option, each element
+     *                       is a string or a null-terminated string pointer.
+     * @param OptionParameterSeparators The range of the separators of option,
+     *                                  each element is a string or a
+     *                                  null-terminated string pointer.
+     * @return The application name, the options and parameters, and the
+     *         unresolved command line.
+    */
+    template<
+        typename CharType,
+        typename PrefixRangeType,
+        typename SeparatorRangeType>
+    static Mile::BasicCommandLineOptions<CharType> SpiltCommandLineOptions(
+        CharType const* CommandLine,
+        std::size_t Length,
+        PrefixRangeType const& OptionPrefixes,
+        SeparatorRangeType const& OptionParameterSeparators)
+    {
+        using EntryType =
+            typename Mile::BasicCommandLineOptions<CharType>::EntryType;
+
+        std::unique_ptr<CharType[]> Buffer;
+        Mile::BasicStringSpan<CharType> ApplicationName;
+        std::vector<EntryType> Options;
+        Mile::BasicStringSpan<CharType> UnresolvedCommandLine;
+        ::ParseCommandLineOptions(
+            CommandLine,
+            Length,
+            OptionPrefixes,
+            OptionParameterSeparators,
+            Buffer,
+            ApplicationName,
+            Options,
+            UnresolvedCommandLine);
+
+        // Sort the options by the case-insensitive names, and only keep the
+        // last one if an option is specified more than once.
+        std::stable_sort(
+            Options.begin(),
+            Options.end(),
+            [](EntryType const& Left, EntryType const& Right)
+            {
+                return ::CompareIgnoreCase(Left.first, Right.first) < 0;
+            });
+        std::size_t Count = 0;
+        for (std::size_t i = 0; i < Options.size(); ++i)
+        {
+            if (i + 1 < Options.size() &&
+                0 == ::CompareIgnoreCase(
+                    Options[i].first,
+                    Options[i + 1].first))
+            {
+                continue;
+            }
+
+            Options[Count++] = Options[i];
+        }
+        Options.resize(Count);
+
+        return Mile::BasicCommandLineOptions<CharType>(
+            std::move(Buffer),
+            ApplicationName,
+            std::move(Options),
+            UnresolvedCommandLine);
+    }
+
+    /**
+     * @brief Decodes a Unicode code point from the UTF-8 string, the invalid
+     *        sequences are decoded as U+FFFD.
+     * @param Current The pointer to the current code unit, which will be moved
+     *                to the next code point.
+     * @param End The pointer to the end of the string.
+     * @return The decoded code point.
+    */
+    static std::uint32_t DecodeCodePoint(
+        std::uint8_t const*& Current,
+        std::uint8_t const* End)
+    {
+        std::uint32_t CodePoint = *Current++;
+        if (CodePoint < 0x80)
+        {
+            return CodePoint;
+        }
+
+        std::size_t TrailCount = 0;
+        std::uint32_t Minimum = 0;
+        if (0xC0 == (CodePoint & 0xE0))
+        {
+            TrailCount = 1;
+            Minimum = 0x80;
+            CodePoint &= 0x1F;
+        }
+        else if (0xE0 == (CodePoint & 0xF0))
+        {
+            TrailCount = 2;
+            Minimum = 0x800;
+            CodePoint &= 0x0F;
+        }
+        else if (0xF0 == (CodePoint & 0xF8))
+        {
+            TrailCount = 3;
+            Minimum = 0x10000;
+            CodePoint &= 0x07;
+        }
+        else
+        {
+            return 0xFFFD;
+        }
+
+        for (; TrailCount; --TrailCount)
+        {
+            if (Current == End || 0x80 != (*Current & 0xC0))
+            {
+                return 0xFFFD;
+            }
+            CodePoint = (CodePoint << 6) | (*Current++ & 0x3F);
+        }
+
+        if (CodePoint < Minimum ||
+            CodePoint > 0x10FFFF ||
+            (CodePoint >= 0xD800 && CodePoint <= 0xDFFF))
+        {
+            return 0xFFFD;
+        }
+
+        return CodePoint;
+    }
+
+    /**
+     * @brief Decodes a Unicode code point from the UTF-16 string, the unpaired
+     *        surrogates are decoded as U+FFFD.
+     * @param Current The pointer to the current code unit, which will be moved
+     *                to the next code point.
+     * @param End The pointer to the end of the string.
+     * @return The decoded code point.
+    */
+    static std::uint32_t DecodeCodePoint(
+        std::uint16_t const*& Current,
+        std::uint16_t const* End)
+    {
+        std::uint32_t CodePoint = *Current++;
+        if (CodePoint < 0xD800 || CodePoint > 0xDFFF)
+        {
+            return CodePoint;
+        }
+
+        if (CodePoint <= 0xDBFF &&
+            Current != End &&
+            *Current >= 0xDC00 &&
+            *Current <= 0xDFFF)
+        {
+            return 0x10000 +
+                ((CodePoint - 0xD800) << 10) +
+                (*Current++ - 0xDC00);
+        }
+
+        return 0xFFFD;
+    }
+
+    /**
+     * @brief Decodes a Unicode code point from the UTF-32 string, the invalid
+     *        code points are decoded as U+FFFD.
+     * @param Current The pointer to the current code unit, which will be moved
+     *                to the next code point.
+     * @param End The pointer to the end of the string.
+     * @return The decoded code point.
+    */
+    static std::uint32_t DecodeCodePoint(
+        std::uint32_t const*& Current,
+        std::uint32_t const* End)
+    {
+        static_cast<void>(End);
+
+        std::uint32_t CodePoint = *Current++;
+        if (CodePoint > 0x10FFFF ||
+            (CodePoint >= 0xD800 && CodePoint <= 0xDFFF))
+        {
+            return 0xFFFD;
+        }
+
+        return CodePoint;
+    }
+
+    /**
+     * @brief Appends a Unicode code point to the string, which is encoded in
+     *        UTF-8, UTF-16 or UTF-32 depending on the size of the character
+     *        type.
+     * @param Output The string to append.
+     * @param CodePoint The code point to append.
+    */
+    template<typename CharType>
+    static void AppendCodePoint(
+        std::basic_string<CharType>& Output,
+        std::uint32_t CodePoint)
+    {
+        if (1 == sizeof(CharType))
+        {
+            if (CodePoint < 0x80)
+            {
+                Output.push_back(static_cast<CharType>(CodePoint));
+            }
+            else if (CodePoint < 0x800)
+            {
+                Output.push_back(static_cast<CharType>(
+                    0xC0 | (CodePoint >> 6)));
+                Output.push_back(static_cast<CharType>(
+                    0x80 | (CodePoint & 0x3F)));
+            }
+            else if (CodePoint < 0x10000)
+            {
+                Output.push_back(static_cast<CharType>(
+                    0xE0 | (CodePoint >> 12)));
+                Output.push_back(static_cast<CharType>(
+                    0x80 | ((CodePoint >> 6) & 0x3F)));
+                Output.push_back(static_cast<CharType>(
+                    0x80 | (CodePoint & 0x3F)));
+            }
+            else
+            {
+                Output.push_back(static_cast<CharType>(
+                    0xF0 | (CodePoint >> 18)));
+                Output.push_back(static_cast<CharType>(
+                    0x80 | ((CodePoint >> 12) & 0x3F)));
+                Output.push_back(static_cast<CharType>(
+                    0x80 | ((CodePoint >> 6) & 0x3F)));
+                Output.push_back(static_cast<CharType>(
+                    0x80 | (CodePoint & 0x3F)));
+            }
+        }
+        else if (2 == sizeof(CharType) && CodePoint >= 0x10000)
+        {
+            CodePoint -= 0x10000;
+            Output.push_back(static_cast<CharType>(
+                0xD800 | (CodePoint >> 10)));
+            Output.push_back(static_cast<CharType>(
+                0xDC00 | (CodePoint & 0x3FF)));
+        }
+        else
+        {
+            Output.push_back(static_cast<CharType>(CodePoint));
+        }
+    }
+
+    /**
+     * @brief Converts the Unicode string between the character types, the
+     *        strings of the 1-byte, 2-byte and 4-byte character types are
+     *        treated as UTF-8, UTF-16 and UTF-32.
+     * @param Source The string to convert.
+     * @param Output The converted string.
+    */
+    template<typename TargetCharType, typename SourceCharType>
+    static void ConvertUnicodeString(
+        Mile::BasicStringSpan<SourceCharType> const& Source,
+        std::basic_string<TargetCharType>& Output)
+    {
+        if (sizeof(TargetCharType) == sizeof(SourceCharType))
+        {
+            Output.assign(
+                reinterpret_cast<TargetCharType const*>(Source.Data()),
+                Source.Size());
+            return;
+        }
+
+        using SourceUnitType = CodeUnitType<SourceCharType>;
+
+        SourceUnitType const* Current =
+            reinterpret_cast<SourceUnitType const*>(Source.begin());
+        SourceUnitType const* const End =
+            reinterpret_cast<SourceUnitType const*>(Source.end());
+
+        Output.clear();
+        Output.reserve(Source.Size());
+        while (Current != End)
+        {
+            ::AppendCodePoint(Output, ::DecodeCodePoint(Current, End));
+        }
+    }
+
+    /**
+     * @brief The read-only memory mapping of a response file.
+    */
+    class ResponseFileMapping : Mile::DisableCopyConstruction
+    {
+    private:
+
+        void const* m_Data = nullptr;
+        std::size_t m_Size = 0;
+
+    public:
+
+        ResponseFileMapping() = default;
+
+        ~ResponseFileMapping()
+        {
+            if (this->m_Data)
+            {
+#ifdef _WIN32
+                ::UnmapViewOfFile(this->m_Data);
+#else
+                ::munmap(const_cast<void*>(this->m_Data), this->m_Size);
+#endif
+            }
+        }
+
+        /**
+         * @brief Maps the response file into memory.
+         * @param Path The path of the response file.
+         * @return true if successful, otherwise false.
+        */
+        template<typename CharType>
+        bool Open(
+            Mile::BasicStringSpan<CharType> const& Path)
+        {
+#ifdef _WIN32
+            std::wstring NativePath;
+            ::ConvertUnicodeString(Path, NativePath);
+
+            HANDLE FileHandle = ::CreateFileW(
+                NativePath.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_FLAG_SEQUENTIAL_SCAN,
+                nullptr);
+            if (INVALID_HANDLE_VALUE == FileHandle)
+            {
+                return false;
+            }
+
+            bool Result = false;
+            LARGE_INTEGER FileSize;
+            if (::GetFileSizeEx(FileHandle, &FileSize) &&
+                static_cast<ULONGLONG>(FileSize.QuadPart) <= SIZE_MAX)
+            {
+                this->m_Size = static_cast<std::size_t>(FileSize.QuadPart);
+                if (!this->m_Size)
+                {
+                    // Empty files cannot be mapped.
+                    Result = true;
+                }
+                else
+                {
+                    HANDLE MappingHandle = ::CreateFileMappingW(
+                        FileHandle,
+                        nullptr,
+                        PAGE_READONLY,
+                        0,
+                        0,
+                        nullptr);
+                    if (MappingHandle)
+                    {
+                        this->m_Data = ::MapViewOfFile(
+                            MappingHandle,
+                            FILE_MAP_READ,
+                            0,
+                            0,
+                            0);
+                        Result = (nullptr != this->m_Data);
+                        ::CloseHandle(MappingHandle);
+                    }
+                }
+            }
+
+            ::CloseHandle(FileHandle);
+            return Result;
+#else
+            std::string NativePath;
+            ::ConvertUnicodeString(Path, NativePath);
+
+            int FileDescriptor = ::open(
+                NativePath.c_str(),
+                O_RDONLY | O_CLOEXEC);
+            if (-1 == FileDescriptor)
+            {
+                return false;
+            }
+
+            bool Result = false;
+            struct stat FileStatus;
+            if (0 == ::fstat(FileDescriptor, &FileStatus) &&
+                static_cast<std::uint64_t>(FileStatus.st_size) <= SIZE_MAX)
+            {
+                this->m_Size = static_cast<std::size_t>(FileStatus.st_size);
+                if (!this->m_Size)
+                {
+                    // Empty files cannot be mapped.
+                    Result = true;
+                }
+                else
+                {
+                    void* Data = ::mmap(
+                        nullptr,
+                        this->m_Size,
+                        PROT_READ,
+                        MAP_PRIVATE,
+                        FileDescriptor,
+                        0);
+                    if (MAP_FAILED != Data)
+                    {
+                        ::madvise(Data, this->m_Size, MADV_SEQUENTIAL);
+                        this->m_Data = Data;
+                        Result = true;
+                    }
+                }
+            }
+
+            ::close(FileDescriptor);
+            return Result;
+#endif
+        }
+
+        std::uint8_t const* Data() const
+        {
+            return reinterpret_cast<std::uint8_t const*>(this->m_Data);
+        }
+
+        std::size_t Size() const
+        {
+            return this->m_Data ? this->m_Size : 0;
+        }
+    };
+
+    template<typename CharType>
+    static bool ExpandResponseFile(
+        Mile::BasicStringSpan<CharType> const& Path,
+        std::function<void(Mile::BasicStringSpan<CharType> const&)> const&
+            Callback,
+        std::size_t RemainingDepth);
+
+    /**
+     * @brief Passes the argument to the callback, or expands it if it is a
+     *        response file reference which starts with @.
+     * @param Argument The argument to process.
+     * @param Callback The callback which receives the arguments.
+     * @param RemainingDepth The remaining nesting depth of response files.
+     * @return true if successful, otherwise false.
+    */
+    template<typename CharType>
+    static bool ProcessCommandArgument(
+        Mile::BasicStringSpan<CharType> const& Argument,
+        std::function<void(Mile::BasicStringSpan<CharType> const&)> const&
+            Callback,
+        std::size_t RemainingDepth)
+    {
+        if (Argument.Empty() || '@' != Argument[0])
+        {
+            Callback(Argument);
+            return true;
+        }
+
+        if (!RemainingDepth)
+        {
+            return false;
+        }
+
+        return ::ExpandResponseFile(
+            Mile::BasicStringSpan<CharType>(
+                Argument.Data() + 1,
+                Argument.Size() - 1),
+            Callback,
+            RemainingDepth - 1);
+    }
+
+    /**
+     * @brief Tokenizes the content of a response file line by line with the
+     *        same quoting rules as the command arguments, so only the longest
+     *        line needs to be buffered.
+     * @param Content The pointer to the content of the response file.
+     * @param Length The length of the content of the response file.
+     * @param Callback The callback which receives the arguments.
+     * @param RemainingDepth The remaining nesting depth of response files.
+     * @return true if successful, otherwise false.
+    */
+    template<typename CharType, typename FileCharType>
+    static bool ExpandResponseFileContent(
+        FileCharType const* Content,
+        std::size_t Length,
+        std::function<void(Mile::BasicStringSpan<CharType> const&)> const&
+            Callback,
+        std::size_t RemainingDepth)
+    {
+        std::vector<FileCharType> Buffer;
+        std::basic_string<CharType> ConvertedArgument;
+
+        FileCharType const* const End = Content + Length;
+        for (FileCharType const* LineStart = Content; LineStart != End;)
+        {
+            FileCharType const* LineEnd = std::find(
+                LineStart,
+                End,
+                static_cast<FileCharType>('\n'));
+            FileCharType const* NextLineStart =
+                (LineEnd == End) ? End : LineEnd + 1;
+            if (LineEnd != LineStart && '\r' == LineEnd[-1])
+            {
+                --LineEnd;
+            }
+
+            std::size_t LineLength = LineEnd - LineStart;
+            if (Buffer.size() < LineLength + 1)
+            {
+                Buffer.resize(LineLength + 1);
+            }
+
+            for (FileCharType const* Current = LineStart;;)
+            {
+                Current = ::SkipCommandArgumentDelimiters(Current, LineEnd);
+                if (::IsCommandArgumentsEnd(Current, LineEnd))
+                {
+                    break;
+                }
+
+                std::size_t ArgumentLength = 0;
+                Current = ::ScanCommandArgument(
+                    Current,
+                    LineEnd,
+                    Buffer.data(),
+                    ArgumentLength);
+
+                Mile::BasicStringSpan<CharType> Argument;
+                if (sizeof(CharType) == sizeof(FileCharType))
+                {
+                    Argument = Mile::BasicStringSpan<CharType>(
+                        reinterpret_cast<CharType const*>(Buffer.data()),
+                        ArgumentLength);
+                }
+                else
+                {
+                    ::ConvertUnicodeString(
+                        Mile::BasicStringSpan<FileCharType>(
+                            Buffer.data(),
+                            ArgumentLength),
+                        ConvertedArgument);
+                    Argument = Mile::BasicStringSpan<CharType>(
+                        ConvertedArgument);
+                }
+
+                if (!::ProcessCommandArgument(
+                    Argument,
+                    Callback,
+                    RemainingDepth))
+                {
+                    return false;
+                }
+            }
+
+            LineStart = NextLineStart;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Expands the response file. The response file is UTF-16LE if it
+     *        starts with the UTF-16LE BOM, otherwise it is UTF-8 with an
+     *        optional BOM.
+     * @param Path The path of the response file.
+     * @param Callback The callback which receives the arguments.
+     * @param RemainingDepth The remaining nesting depth of response files.
+     * @return true if successful, otherwise false.
+    */
+    template<typename CharType>
+    static bool ExpandResponseFile(
+        Mile::BasicStringSpan<CharType> const& Path,
+        std::function<void(Mile::BasicStringSpan<CharType> const&)> const&
+            Callback,
+        std::size_t RemainingDepth)
+    {
+        ResponseFileMapping Mapping;
+        if (!Mapping.Open(Path))
+        {
+            return false;
+        }
+
+        std::uint8_t const* Content = Mapping.Data();
+        std::size_t Length = Mapping.Size();
+
+        if (Length >= 2 && 0xFF == Content[0] && 0xFE == Content[1])
+        {
+            return ::ExpandResponseFileContent(
+                reinterpret_cast<char16_t const*>(Content + 2),
+                (Length - 2) / sizeof(char16_t),
+                Callback,
+                RemainingDepth);
+        }
+
+        if (Length >= 3 &&
+            0xEF == Content[0] &&
+            0xBB == Content[1] &&
+            0xBF == Content[2])
+        {
+            Content += 3;
+            Length -= 3;
+        }
+
+        return ::ExpandResponseFileContent(
+            reinterpret_cast<char const*>(Content),
+            Length,
+            Callback,
+            RemainingDepth);
+    }
+
+    /**
+     * @brief The chunks of a parallel job, which are claimed one by one by
+     *        the calling thread and the worker threads.
+    */
+    struct ParallelChunkJob
+    {
+        /**
+         * @brief The routine which runs a chunk of the job.
+        */
+        void (*Routine)(void* Context, std::size_t Chunk);
+
+        /**
+         * @brief The context of the routine.
+        */
+        void* Context;
+
+        /**
+         * @brief The number of the chunks.
+        */
+        std::size_t ChunkCount;
+
+        /**
+         * @brief The index of the next chunk to claim.
+        */
+        std::size_t NextChunk;
+
+        /**
+         * @brief The number of the chunks which are not finished.
+        */
+        std::size_t RemainingCount;
+    };
+
+    /**
+     * @brief The context of the worker threads for the parallel jobs. The
+     *        worker threads are created on demand and are kept for the
+     *        lifetime of the process, so a batch does not pay for creating
+     *        and joining threads.
+    */
+    struct ParallelChunkContext
+    {
+        /**
+         * @brief The jobs which have chunks to claim.
+        */
+        std::vector<ParallelChunkJob*> Jobs;
+
+        /**
+         * @brief The number of the worker threads.
+        */
+        std::size_t WorkerCount = 0;
+
+        std::mutex Mutex;
+        std::condition_variable WorkSignal;
+        std::condition_variable DoneSignal;
+    };
+
+    /**
+     * @brief Returns the context of the worker threads for the parallel
+     *        jobs. The context is never destroyed because the worker threads
+     *        are never stopped.
+     * @return The context of the worker threads for the parallel jobs.
+    */
+    static ParallelChunkContext& GetParallelChunkContext()
+    {
+        static ParallelChunkContext* Context = new ParallelChunkContext();
+        return *Context;
+    }
+
+    /**
+     * @brief Claims and runs the next chunk of a job in the queue. The job
+     *        is removed from the queue when its last chunk is claimed. The
+     *        mutex of the context must be held by the caller, and is released
+     *        while the chunk is running.
+     * @param Context The context of the worker threads.
+     * @param Lock The lock which holds the mutex of the context.
+     * @param Job The job to run, which must be in the queue.
+    */
+    static void RunParallelChunk(
+        ParallelChunkContext& Context,
+        std::unique_lock<std::mutex>& Lock,
+        ParallelChunkJob* Job)
+    {
+        std::size_t Chunk = Job->NextChunk++;
+        if (Job->NextChunk == Job->ChunkCount)
+        {
+            Context.Jobs.erase(
+                std::find(Context.Jobs.begin(), Context.Jobs.end(), Job));
+        }
+
+        Lock.unlock();
+        Job->Routine(Job->Context, Chunk);
+        Lock.lock();
+
+        if (0 == --Job->RemainingCount)
+        {
+            Context.DoneSignal.notify_all();
+        }
+    }
+
+    static void ParallelChunkWorkerRoutine(
+        ParallelChunkContext* Context)
+    {
+        std::unique_lock<std::mutex> Lock(Context->Mutex);
+        for (;;)
+        {
+            Context->WorkSignal.wait(
+                Lock,
+                [Context]() { return !Context->Jobs.empty(); });
+            ::RunParallelChunk(*Context, Lock, Context->Jobs.front());
+        }
+    }
+
+    /**
+     * @brief Runs the function for each chunk in parallel on the calling
+     *        thread and the worker threads. The calling thread also claims
+     *        the chunks, so the job finishes even if no worker thread can be
+     *        created or all of them are busy.
+     * @param ChunkCount The number of the chunks.
+     * @param Function The function which receives the index of the chunk,
+     *                 which must not throw.
+    */
+    template<typename FunctionType>
+    static void RunChunksInParallel(
+        std::size_t ChunkCount,
+        FunctionType const& Function)
+    {
+        if (ChunkCount < 2)
+        {
+            if (ChunkCount)
+            {
+                Function(0);
+            }
+            return;
+        }
+
+        ParallelChunkJob Job;
+        Job.Routine = [](void* Context, std::size_t Chunk)
+        {
+            (*static_cast<FunctionType const*>(Context))(Chunk);
+        };
+        Job.Context = const_cast<void*>(
+            static_cast<void const*>(&Function));
+        Job.ChunkCount = ChunkCount;
+        Job.NextChunk = 0;
+        Job.RemainingCount = ChunkCount;
+
+        ParallelChunkContext& Context = ::GetParallelChunkContext();
+        std::unique_lock<std::mutex> Lock(Context.Mutex);
+
+        try
+        {
+            Context.Jobs.push_back(&Job);
+        }
+        catch (...)
+        {
+            Lock.unlock();
+            for (std::size_t Chunk = 0; Chunk < ChunkCount; ++Chunk)
+            {
+                Function(Chunk);
+            }
+            return;
+        }
+
+        // The calling thread runs one of the chunks, so one worker thread
+        // fewer than the chunks is needed.
+        while (Context.WorkerCount < ChunkCount - 1)
+        {
+            try
+            {
+                std::thread(::ParallelChunkWorkerRoutine, &Context).detach();
+                ++Context.WorkerCount;
+            }
+            catch (...)
+            {
+                break;
+            }
+        }
+        Context.WorkSignal.notify_all();
+
+        while (Job.NextChunk < Job.ChunkCount)
+        {
+            ::RunParallelChunk(Context, Lock, &Job);
+        }
+
+        Context.DoneSignal.wait(
+            Lock,
+            [&Job]() { return 0 == Job.RemainingCount; });
+    }
+}
+
+template<typename CharType>
+typename Mile::BasicCommandLineOptions<CharType>::StringSpanType const*
+Mile::BasicCommandLineOptions<CharType>::Find(
+    StringSpanType const& Name) const noexcept
+{
+    auto Iterator = std::lower_bound(
+        this->m_Options.begin(),
+        this->m_Options.end(),
+        Name,
+        [](EntryType const& Left, StringSpanType const& Right)
+        {
+            return ::CompareIgnoreCase(Left.first, Right) < 0;
+        });
+    if (Iterator != this->m_Options.end() &&
+        0 == ::CompareIgnoreCase(Iterator->first, Name))
+    {
+        return &Iterator->second;
+    }
+
+    return nullptr;
+}
+
+void Mile::SpiltCommandLineEx(
+    std::wstring const& CommandLine,
+    std::vector<std::wstring> const& OptionPrefixes,
+    std::vector<std::wstring> const& OptionParameterSeparators,
+    std::wstring& ApplicationName,
+    std::map<std::wstring, std::wstring>& OptionsAndParameters,
+    std::wstring& UnresolvedCommandLine)
+{
+    Mile::SpiltCommandLineEx<wchar_t>(
+        CommandLine,
+        OptionPrefixes,
+        OptionParameterSeparators,
+        ApplicationName,
+        OptionsAndParameters,
+        UnresolvedCommandLine);
+}
+
+template<typename CharType>
+void Mile::SpiltCommandLineEx(
+    std::basic_string<CharType> const& CommandLine,
+    std::vector<std::basic_string<CharType>> const& OptionPrefixes,
+    std::vector<std::basic_string<CharType>> const& OptionParameterSeparators,
+    std::basic_string<CharType>& ApplicationName,
+    std::map<std::basic_string<CharType>, std::basic_string<CharType>>&
+        OptionsAndParameters,
+    std::basic_string<CharType>& UnresolvedCommandLine)
+{
+    std::unique_ptr<CharType[]> Buffer;
+    Mile::BasicStringSpan<CharType> ApplicationNameSpan;
+    std::vector<typename Mile::BasicCommandLineOptions<CharType>::EntryType>
+        Options;
+    Mile::BasicStringSpan<CharType> UnresolvedCommandLineSpan;
+    ::ParseCommandLineOptions(
+        CommandLine.c_str(),
+        CommandLine.size(),
+        OptionPrefixes,
+        OptionParameterSeparators,
+        Buffer,
+        ApplicationNameSpan,
+        Options,
+        UnresolvedCommandLineSpan);
+
+    ApplicationName = ApplicationNameSpan.ToString();
+    // The option names are case-sensitive keys of the map, and the last one
+    // wins if an option is specified more than once.
+    OptionsAndParameters.clear();
+    for (auto const& Option : Options)
+    {
+        OptionsAndParameters[Option.first.ToString()] =
+            Option.second.ToString();
+    }
+    UnresolvedCommandLine = UnresolvedCommandLineSpan.ToString();
+}
+
+template<typename CharType>
+Mile::BasicCommandLineOptions<CharType> Mile::SpiltCommandLineEx(
+    std::basic_string<CharType> const& CommandLine,
+    std::vector<std::basic_string<CharType>> const& OptionPrefixes,
+    std::vector<std::basic_string<CharType>> const& OptionParameterSeparators)
+{
+    return ::SpiltCommandLineOptions(
+        CommandLine.c_str(),
+        CommandLine.size(),
+        OptionPrefixes,
+        OptionParameterSeparators);
+}
+
+template<typename CharType>
+Mile::BasicCommandLineOptions<CharType> Mile::SpiltCommandLineEx(
+    Mile::BasicStringSpan<CharType> const& CommandLine,
+    CharType const* const* OptionPrefixes,
+    std::size_t OptionPrefixCount,
+    CharType const* const* OptionParameterSeparators,
+    std::size_t OptionParameterSeparatorCount)
+{
+    return ::SpiltCommandLineOptions(
+        CommandLine.Data(),
+        CommandLine.Size(),
+        ::ArrayRange<CharType const*>{
+            OptionPrefixes,
+            OptionPrefixes + OptionPrefixCount },
+        ::ArrayRange<CharType const*>{
+            OptionParameterSeparators,
+            OptionParameterSeparators + OptionParameterSeparatorCount });
+}
+
+std::vector<std::wstring> Mile::SpiltCommandArguments(
+    std::wstring const& Arguments)
+{
+    return Mile::SpiltCommandArguments<wchar_t>(Arguments);
+}
+
+template<typename CharType>
+std::vector<std::basic_string<CharType>> Mile::SpiltCommandArguments(
+    std::basic_string<CharType> const& Arguments)
+{
+    Mile::BasicCommandArgumentSpans<CharType> SplitArgumentSpans =
+        Mile::SpiltCommandArgumentsToSpans(Arguments);
+
+    std::vector<std::basic_string<CharType>> SplitArguments;
+    SplitArguments.reserve(SplitArgumentSpans.Count());
+    for (Mile::BasicStringSpan<CharType> const& SplitArgument
+        : SplitArgumentSpans)
+    {
+        SplitArguments.emplace_back(
+            SplitArgument.Data(),
+            SplitArgument.Size());
+    }
+
+    MILE_ACCOUNT_HANDED_OFF_ALLOCATION(
+        "Mile.SpiltCommandArguments",
+        Mile::GetAccountedSize(SplitArguments));
+
+    return SplitArguments;
+}
+
+template<typename CharType>
+Mile::BasicCommandArgumentSpans<CharType> Mile::SpiltCommandArgumentsToSpans(
+    CharType const* Arguments,
+    std::size_t Length)
+{
+    using StringSpanType = Mile::BasicStringSpan<CharType>;
+
+    CharType const* const End = Arguments + Length;
+
+    // The empty and blank command lines have no argument, so they need no
+    // allocation.
+    Arguments = ::SkipCommandArgumentDelimiters(Arguments, End);
+    if (::IsCommandArgumentsEnd(Arguments, End))
+    {
+        return Mile::BasicCommandArgumentSpans<CharType>();
+    }
+    Length = static_cast<std::size_t>(End - Arguments);
+
+    // Every argument except the last one is followed by at least one
+    // delimiter, so counting the delimiters gives the upper bound of the
+    // number of arguments. Also, the unescaped arguments with their
+    // terminating null characters never exceed the length of the source plus
+    // one. So we can parse in a single pass with a single allocation.
+    std::size_t MaximumArgumentCount = 1;
+    for (CharType const* Current = Arguments; Current != End; ++Current)
+    {
+        MaximumArgumentCount += (' ' == *Current) | ('\t' == *Current);
+    }
+    if (MaximumArgumentCount > Length / 2 + 1)
+    {
+        MaximumArgumentCount = Length / 2 + 1;
+    }
+
+    StringSpanType* ArgumentSpans =
+        reinterpret_cast<StringSpanType*>(::operator new(
+            MaximumArgumentCount * sizeof(StringSpanType) +
+            (Length + 1) * sizeof(CharType)));
+    CharType* Buffer = reinterpret_cast<CharType*>(
+        ArgumentSpans + MaximumArgumentCount);
+
+    std::size_t ArgumentCount = 0;
+    for (CharType const* Current = Arguments;;)
+    {
+        Current = ::SkipCommandArgumentDelimiters(Current, End);
+        if (::IsCommandArgumentsEnd(Current, End))
+        {
+            break;
+        }
+
+        std::size_t ArgumentLength = 0;
+        Current = ::ScanCommandArgument(Current, End, Buffer, ArgumentLength);
+        Buffer[ArgumentLength] = static_cast<CharType>('\0');
+
+        new (&ArgumentSpans[ArgumentCount++]) StringSpanType(
+            Buffer,
+            ArgumentLength);
+        Buffer += ArgumentLength + 1;
+    }
+
+    return Mile::BasicCommandArgumentSpans<CharType>(
+        ArgumentSpans,
+        ArgumentCount);
+}
+
+template<typename CharType>
+Mile::BasicCommandArgumentBatch<CharType> Mile::SpiltCommandArgumentsInBatch(
+    Mile::BasicStringSpan<CharType> const* CommandLines,
+    std::size_t Count,
+    std::size_t ThreadCount)
+{
+    if (!ThreadCount)
+    {
+        ThreadCount = Mile::GetPlatformInfo().LogicalProcessorCount;
+    }
+    if (!ThreadCount)
+    {
+        ThreadCount = 1;
+    }
+
+    // Split the lines into the chunks with similar numbers of characters.
+    // The small batches are parsed in fewer chunks, because waking a worker
+    // thread costs more than parsing a few lines.
+    const std::size_t MinimumChunkLength = 256 * 1024;
+    std::size_t TotalLength = 0;
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        TotalLength += CommandLines[i].Size();
+    }
+    std::vector<std::size_t> ChunkLines(1, 0);
+    {
+        std::size_t ChunkLength = TotalLength / ThreadCount + 1;
+        if (ChunkLength < MinimumChunkLength)
+        {
+            ChunkLength = MinimumChunkLength;
+        }
+        std::size_t Length = 0;
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+            Length += CommandLines[i].Size();
+            if (Length >= ChunkLength && i + 1 < Count)
+            {
+                ChunkLines.push_back(i + 1);
+                Length = 0;
+            }
+        }
+        ChunkLines.push_back(Count);
+    }
+    std::size_t ChunkCount = ChunkLines.size() - 1;
+
+    // The first pass counts the arguments and the characters of each chunk,
+    // so the second pass can unescape the arguments into their exact
+    // positions without allocating and copying the results of each chunk.
+    std::vector<std::size_t> ChunkArguments(ChunkCount + 1, 0);
+    std::vector<std::size_t> ChunkCharacters(ChunkCount + 1, 0);
+    ::RunChunksInParallel(
+        ChunkCount,
+        [&](std::size_t Chunk)
+        {
+            std::size_t ArgumentCount = 0;
+            std::size_t CharacterCount = 0;
+            for (std::size_t Line = ChunkLines[Chunk];
+                Line < ChunkLines[Chunk + 1];
+                ++Line)
+            {
+                CharType const* Current = CommandLines[Line].begin();
+                CharType const* const End = CommandLines[Line].end();
+                for (;;)
+                {
+                    Current = ::SkipCommandArgumentDelimiters(Current, End);
+                    if (::IsCommandArgumentsEnd(Current, End))
+                    {
+                        break;
+                    }
+
+                    std::size_t ArgumentLength = 0;
+                    Current = ::ScanCommandArgument<CharType>(
+                        Current,
+                        End,
+                        nullptr,
+                        ArgumentLength);
+                    CharacterCount += ArgumentLength + 1;
+                    ++ArgumentCount;
+                }
+            }
+            ChunkArguments[Chunk + 1] = ArgumentCount;
+            ChunkCharacters[Chunk + 1] = CharacterCount;
+        });
+
+    for (std::size_t Chunk = 0; Chunk < ChunkCount; ++Chunk)
+    {
+        ChunkArguments[Chunk + 1] += ChunkArguments[Chunk];
+        ChunkCharacters[Chunk + 1] += ChunkCharacters[Chunk];
+    }
+
+    std::unique_ptr<std::size_t[]> LineOffsets(new std::size_t[Count + 1]);
+    LineOffsets[Count] = ChunkArguments[ChunkCount];
+    std::unique_ptr<CharType[]> Arena(
+        new CharType[ChunkCharacters[ChunkCount]]);
+    std::unique_ptr<std::size_t[]> ArgumentOffsets(
+        new std::size_t[ChunkArguments[ChunkCount] + 1]);
+    ArgumentOffsets[ChunkArguments[ChunkCount]] = ChunkCharacters[ChunkCount];
+
+    ::RunChunksInParallel(
+        ChunkCount,
+        [&](std::size_t Chunk)
+        {
+            std::size_t ArgumentIndex = ChunkArguments[Chunk];
+            std::size_t Offset = ChunkCharacters[Chunk];
+            for (std::size_t Line = ChunkLines[Chunk];
+                Line < ChunkLines[Chunk + 1];
+                ++Line)
+            {
+                LineOffsets[Line] = ArgumentIndex;
+
+                CharType const* Current = CommandLines[Line].begin();
+                CharType const* const End = CommandLines[Line].end();
+                for (;;)
+                {
+                    Current = ::SkipCommandArgumentDelimiters(Current, End);
+                    if (::IsCommandArgumentsEnd(Current, End))
+                    {
+                        break;
+                    }
+
+                    std::size_t ArgumentLength = 0;
+                    Current = ::ScanCommandArgument(
+                        Current,
+                        End,
+                        Arena.get() + Offset,
+                        ArgumentLength);
+                    Arena[Offset + ArgumentLength] =
+                        static_cast<CharType>('\0');
+
+                    ArgumentOffsets[ArgumentIndex++] = Offset;
+                    Offset += ArgumentLength + 1;
+                }
+            }
+        });
+
+    return Mile::BasicCommandArgumentBatch<CharType>(
+        std::move(Arena),
+        std::move(ArgumentOffsets),
+        std::move(LineOffsets),
+        Count);
+}
+
+template<typename CharType>
+std::size_t Mile::BuildCommandLine(
+    Mile::BasicStringSpan<CharType> const* Arguments,
+    std::size_t Count,
+    CharType* Buffer,
+    std::size_t BufferLength)
+{
+    ::ArrayRange<Mile::BasicStringSpan<CharType>> Range{
+        Arguments,
+        Arguments + Count };
+
+    std::size_t Length = ::BuildCommandLineString<CharType>(Range, nullptr);
+    if (Buffer && Length < BufferLength)
+    {
+        ::BuildCommandLineString<CharType>(Range, Buffer);
+        Buffer[Length] = static_cast<CharType>('\0');
+    }
+
+    return Length;
+}
+
+template<typename CharType>
+std::basic_string<CharType> Mile::BuildCommandLine(
+    Mile::BasicStringSpan<CharType> const* Arguments,
+    std::size_t Count)
+{
+    ::ArrayRange<Mile::BasicStringSpan<CharType>> Range{
+        Arguments,
+        Arguments + Count };
+
+    std::basic_string<CharType> CommandLine(
+        ::BuildCommandLineString<CharType>(Range, nullptr),
+        static_cast<CharType>('\0'));
+    ::BuildCommandLineString<CharType>(Range, &CommandLine[0]);
+    MILE_ACCOUNT_HANDED_OFF_ALLOCATION(
+        "Mile.BuildCommandLine",
+        Mile::GetAccountedSize(CommandLine));
+    return CommandLine;
+}
+
+std::wstring Mile::BuildCommandLine(
+    std::vector<std::wstring> const& Arguments)
+{
+    return Mile::BuildCommandLine<wchar_t>(Arguments);
+}
+
+template<typename CharType>
+std::basic_string<CharType> Mile::BuildCommandLine(
+    std::vector<std::basic_string<CharType>> const& Arguments)
+{
+    std::basic_string<CharType> CommandLine(
+        ::BuildCommandLineString<CharType>(Arguments, nullptr),
+        static_cast<CharType>('\0'));
+    ::BuildCommandLineString<CharType>(Arguments, &CommandLine[0]);
+    MILE_ACCOUNT_HANDED_OFF_ALLOCATION(
+        "Mile.BuildCommandLine",
+        Mile::GetAccountedSize(CommandLine));
+    return CommandLine;
+}
+
+template<typename CharType>
+void Mile::BasicCommandArgumentRange<CharType>::Decode(
+    CharType const* Source,
+    CharType const*& ArgumentSource,
+    CharType const*& Next,
+    StringSpanType& Argument)
+{
+    Source = ::SkipCommandArgumentDelimiters(Source, this->m_End);
+    if (::IsCommandArgumentsEnd(Source, this->m_End))
+    {
+        ArgumentSource = nullptr;
+        Next = nullptr;
+        Argument = StringSpanType();
+        return;
+    }
+
+    ArgumentSource = Source;
+
+    // Refer to the source directly if the argument has no quotes and
+    // backslashes, because it is not changed by unescaping.
+    CharType const* Special = ::FindCommandArgumentSpecialCharacter(
+        Source,
+        this->m_End);
+    if (::IsCommandArgumentsEnd(Special, this->m_End) ||
+        ' ' == *Special ||
+        '\t' == *Special)
+    {
+        Next = Special;
+        Argument = StringSpanType(Source, Special - Source);
+        return;
+    }
+
+    // The unescaped argument never exceeds the length of the source, so the
+    // buffer can be reused for all arguments.
+    if (!this->m_Buffer)
+    {
+        this->m_Buffer.reset(new CharType[this->m_End - this->m_Begin]);
+    }
+
+    std::size_t ArgumentLength = 0;
+    Next = ::ScanCommandArgument(
+        Source,
+        this->m_End,
+        this->m_Buffer.get(),
+        ArgumentLength);
+    Argument = StringSpanType(this->m_Buffer.get(), ArgumentLength);
+}
+
+template<typename CharType>
+bool Mile::ExpandCommandArguments(
+    Mile::BasicStringSpan<CharType> const& Arguments,
+    std::function<void(Mile::BasicStringSpan<CharType> const&)> const&
+        Callback,
+    std::size_t MaximumDepth)
+{
+    CharType const* const End = Arguments.end();
+
+    // The arguments are passed to the callback one by one, so the buffer can
+    // be reused for all arguments.
+    std::unique_ptr<CharType[]> Buffer(new CharType[Arguments.Size() + 1]);
+
+    for (CharType const* Current = Arguments.begin();;)
+    {
+        Current = ::SkipCommandArgumentDelimiters(Current, End);
+        if (::IsCommandArgumentsEnd(Current, End))
+        {
+            break;
+        }
+
+        std::size_t ArgumentLength = 0;
+        Current = ::ScanCommandArgument(
+            Current,
+            End,
+            Buffer.get(),
+            ArgumentLength);
+
+        if (!::ProcessCommandArgument(
+            Mile::BasicStringSpan<CharType>(Buffer.get(), ArgumentLength),
+            Callback,
+            MaximumDepth))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename CharType>
+bool Mile::ParseCommandLineFlag(
+    Mile::BasicStringSpan<CharType> const& Value,
+    bool& Result)
+{
+    static char const* const TrueValues[] = { "1", "true", "on", "yes" };
+    static char const* const FalseValues[] = { "0", "false", "off", "no" };
+
+    for (char const* TrueValue : TrueValues)
+    {
+        if (::EqualsAsciiIgnoreCase(Value, TrueValue))
+        {
+            Result = true;
+            return true;
+        }
+    }
+
+    for (char const* FalseValue : FalseValues)
+    {
+        if (::EqualsAsciiIgnoreCase(Value, FalseValue))
+        {
+            Result = false;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename CharType>
+bool Mile::ParseCommandLineInteger(
+    Mile::BasicStringSpan<CharType> const& Value,
+    std::int64_t& Result)
+{
+    CharType const* Current = Value.begin();
+    CharType const* const End = Value.end();
+
+    bool Negative = false;
+    if (Current != End && ('+' == *Current || '-' == *Current))
+    {
+        Negative = ('-' == *Current);
+        ++Current;
+    }
+
+    unsigned Base = 10;
+    if (End - Current > 2 &&
+        '0' == Current[0] &&
+        ('x' == Current[1] || 'X' == Current[1]))
+    {
+        Base = 16;
+        Current += 2;
+    }
+
+    std::uint64_t Magnitude = 0;
+    Current = ::ParseUnsignedDigits(Current, End, Base, Magnitude);
+    if (Current != End)
+    {
+        return false;
+    }
+
+    std::uint64_t const Limit = static_cast<std::uint64_t>(INT64_MAX);
+    if (Negative)
+    {
+        if (Magnitude > Limit + 1)
+        {
+            return false;
+        }
+        Result = (Magnitude == Limit + 1)
+            ? INT64_MIN
+            : -static_cast<std::int64_t>(Magnitude);
+    }
+    else
+    {
+        if (Magnitude > Limit)
+        {
+            return false;
+        }
+        Result = static_cast<std::int64_t>(Magnitude);
+    }
+
+    return true;
+}
+
+template<typename CharType>
+bool Mile::ParseCommandLineByteSize(
+    Mile::BasicStringSpan<CharType> const& Value,
+    std::uint64_t& Result)
+{
+    struct UnitItem
+    {
+        char const* Name;
+        unsigned Shift;
+    };
+
+    static UnitItem const Units[] =
+    {
+        { "", 0 }, { "B", 0 },
+        { "K", 10 }, { "KB", 10 }, { "KiB", 10 },
+        { "M", 20 }, { "MB", 20 }, { "MiB", 20 },
+        { "G", 30 }, { "GB", 30 }, { "GiB", 30 },
+        { "T", 40 }, { "TB", 40 }, { "TiB", 40 },
+        { "P", 50 }, { "PB", 50 }, { "PiB", 50 },
+    };
+
+    std::uint64_t Number = 0;
+    CharType const* Current = ::ParseUnsignedDigits(
+        Value.begin(),
+        Value.end(),
+        10,
+        Number);
+    if (!Current)
+    {
+        return false;
+    }
+
+    Mile::BasicStringSpan<CharType> Unit(
+        Current,
+        static_cast<std::size_t>(Value.end() - Current));
+    for (UnitItem const& Item : Units)
+    {
+        if (::EqualsAsciiIgnoreCase(Unit, Item.Name))
+        {
+            if (Number > (UINT64_MAX >> Item.Shift))
+            {
+                return false;
+            }
+            Result = Number << Item.Shift;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+namespace
+{
+    /**
+     * @brief The context of the deferred close reaper thread.
+    */
+    struct DeferredCloseContext
+    {
+        /**
+         * @brief The head of the lock-free queue, which is a stack of the
+         *        posted entries in the reverse order.
+        */
+        std::atomic<Mile::DeferredCloseEntry*> Head{ nullptr };
+
+        std::atomic<std::uint64_t> PostedCount{ 0 };
+        std::atomic<std::uint64_t> ClosedCount{ 0 };
+        std::atomic<std::uint64_t> BatchCount{ 0 };
+        std::atomic<std::uint64_t> TotalCloseLatency{ 0 };
+        std::atomic<std::uint64_t> MaximumCloseLatency{ 0 };
+
+        /**
+         * @brief Whether the reaper thread is started, for checking without
+         *        acquiring the mutex when posting.
+        */
+        std::atomic<bool> Running{ false };
+
+        /**
+         * @brief Whether the reaper thread is stopped by DrainDeferredClose.
+        */
+        std::atomic<bool> Stopped{ false };
+
+        std::mutex Mutex;
+        std::condition_variable WakeSignal;
+        std::condition_variable FlushSignal;
+        std::thread Reaper;
+        bool Started = false;
+        bool Stopping = false;
+    };
+
+    /**
+     * @brief Returns the context of the deferred close reaper thread. The
+     *        context is never destroyed, so the values can be posted by the
+     *        destructors of the static objects.
+     * @return The context of the deferred close reaper thread.
+    */
+    static DeferredCloseContext& GetDeferredCloseContext()
+    {
+        static DeferredCloseContext* Context = new DeferredCloseContext();
+        return *Context;
+    }
+
+    static std::int64_t GetSteadyClockNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Closes all entries in the queue in the posted order.
+     * @param Context The context of the deferred close reaper thread.
+    */
+    static void CloseDeferredCloseEntries(
+        DeferredCloseContext& Context)
+    {
+        Mile::DeferredCloseEntry* Entry = Context.Head.exchange(nullptr);
+        if (!Entry)
+        {
+            return;
+        }
+
+        // Reverse the stack to close the entries in the posted order.
+        Mile::DeferredCloseEntry* Batch = nullptr;
+        while (Entry)
+        {
+            Mile::DeferredCloseEntry* Next = Entry->Next;
+            Entry->Next = Batch;
+            Batch = Entry;
+            Entry = Next;
+        }
+
+        std::uint64_t Count = 0;
+        std::uint64_t TotalLatency = 0;
+        std::uint64_t MaximumLatency = 0;
+        while (Batch)
+        {
+            Mile::DeferredCloseEntry* Next = Batch->Next;
+            std::int64_t PostTime = Batch->PostTime;
+            Batch->CloseRoutine(Batch);
+
+            std::uint64_t Latency = static_cast<std::uint64_t>(
+                ::GetSteadyClockNanoseconds() - PostTime);
+            TotalLatency += Latency;
+            if (Latency > MaximumLatency)
+            {
+                MaximumLatency = Latency;
+            }
+            ++Count;
+
+            Batch = Next;
+        }
+
+        Context.TotalCloseLatency.fetch_add(
+            TotalLatency,
+            std::memory_order_relaxed);
+        std::uint64_t Maximum = Context.MaximumCloseLatency.load(
+            std::memory_order_relaxed);
+        while (Maximum < MaximumLatency &&
+            !Context.MaximumCloseLatency.compare_exchange_weak(
+                Maximum,
+                MaximumLatency,
+                std::memory_order_relaxed))
+        {
+        }
+        Context.BatchCount.fetch_add(1, std::memory_order_relaxed);
+        Context.ClosedCount.fetch_add(Count, std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> Lock(Context.Mutex);
+        }
+        Context.FlushSignal.notify_all();
+    }
+
+    static void DeferredCloseReaperRoutine(
+        DeferredCloseContext* Context)
+    {
+        std::unique_lock<std::mutex> Lock(Context->Mutex);
+        while (!Context->Stopping)
+        {
+            Context->WakeSignal.wait(
+                Lock,
+                [Context]()
+                {
+                    return Context->Stopping ||
+                        Context->Head.load(std::memory_order_relaxed);
+                });
+
+            Lock.unlock();
+            ::CloseDeferredCloseEntries(*Context);
+            Lock.lock();
+        }
+    }
+
+    /**
+     * @brief Starts the reaper thread if it is not started.
+     * @param Context The context of the deferred close reaper thread.
+     * @return true if the reaper thread is running, otherwise false.
+    */
+    static bool StartDeferredCloseReaper(
+        DeferredCloseContext& Context)
+    {
+        std::lock_guard<std::mutex> Lock(Context.Mutex);
+        if (!Context.Started && !Context.Stopping)
+        {
+            try
+            {
+                Context.Reaper = std::thread(
+                    ::DeferredCloseReaperRoutine,
+                    &Context);
+                Context.Started = true;
+                Context.Running.store(true, std::memory_order_release);
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }
+        return Context.Started && !Context.Stopping;
+    }
+}
+
+void Mile::PostDeferredClose(
+    Mile::DeferredCloseEntry* Entry) noexcept
+{
+    DeferredCloseContext& Context = ::GetDeferredCloseContext();
+
+    Entry->PostTime = ::GetSteadyClockNanoseconds();
+    Context.PostedCount.fetch_add(1, std::memory_order_relaxed);
+
+    Mile::DeferredCloseEntry* Head = Context.Head.load(
+        std::memory_order_relaxed);
+    do
+    {
+        Entry->Next = Head;
+    } while (!Context.Head.compare_exchange_weak(Head, Entry));
+
+    // The entries posted after the reaper thread is stopped, or when the
+    // reaper thread cannot be started, are closed on the posting thread.
+    // The sequentially consistent operations make sure that the entry is
+    // closed either here or by DrainDeferredClose.
+    if (Context.Stopped.load() ||
+        (!Context.Running.load(std::memory_order_acquire) &&
+            !::StartDeferredCloseReaper(Context)))
+    {
+        ::CloseDeferredCloseEntries(Context);
+        return;
+    }
+
+    if (!Head)
+    {
+        // Acquire the mutex before signaling, so the reaper thread either
+        // sees the entry when checking the predicate or is already waiting.
+        {
+            std::lock_guard<std::mutex> Lock(Context.Mutex);
+        }
+        Context.WakeSignal.notify_one();
+    }
+}
+
+void Mile::FlushDeferredClose() noexcept
+{
+    DeferredCloseContext& Context = ::GetDeferredCloseContext();
+
+    std::uint64_t Target = Context.PostedCount.load(
+        std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> Lock(Context.Mutex);
+    if (!Context.Started || Context.Stopping)
+    {
+        Lock.unlock();
+        ::CloseDeferredCloseEntries(Context);
+        return;
+    }
+
+    Context.WakeSignal.notify_one();
+    Context.FlushSignal.wait(
+        Lock,
+        [&Context, Target]()
+        {
+            return Context.ClosedCount.load(
+                std::memory_order_acquire) >= Target;
+        });
+}
+
+void Mile::DrainDeferredClose() noexcept
+{
+    DeferredCloseContext& Context = ::GetDeferredCloseContext();
+
+    std::thread Reaper;
+    {
+        std::lock_guard<std::mutex> Lock(Context.Mutex);
+        Context.Stopping = true;
+        Context.Stopped.store(true);
+        Reaper = std::move(Context.Reaper);
+    }
+    Context.WakeSignal.notify_one();
+
+    if (Reaper.joinable())
+    {
+        Reaper.join();
+    }
+
+    ::CloseDeferredCloseEntries(Context);
+}
+
+Mile::DeferredCloseStatistics Mile::GetDeferredCloseStatistics() noexcept
+{
+    DeferredCloseContext& Context = ::GetDeferredCloseContext();
+
+    Mile::DeferredCloseStatistics Statistics;
+    Statistics.ClosedCount = Context.ClosedCount.load(
+        std::memory_order_acquire);
+    Statistics.PostedCount = Context.PostedCount.load(
+        std::memory_order_relaxed);
+    Statistics.PendingCount =
+        Statistics.PostedCount > Statistics.ClosedCount
+        ? Statistics.PostedCount - Statistics.ClosedCount
+        : 0;
+    Statistics.BatchCount = Context.BatchCount.load(
+        std::memory_order_relaxed);
+    Statistics.TotalCloseLatency = Context.TotalCloseLatency.load(
+        std::memory_order_relaxed);
+    Statistics.MaximumCloseLatency = Context.MaximumCloseLatency.load(
+        std::memory_order_relaxed);
+    return Statistics;
+}
+
+namespace
+{
+    /**
+     * @brief The size of the header before the blocks allocated by
+     *        Mile::AllocateCachedMemory, which keeps the blocks aligned for
+     *        any fundamental type.
+    */
+    const std::size_t CachedMemoryHeaderSize =
+        alignof(std::max_align_t) > sizeof(std::size_t)
+        ? alignof(std::max_align_t)
+        : sizeof(std::size_t);
+
+    /**
+     * @brief The size of the smallest size class, and the number of the size
+     *        classes. The largest size class is 32 KiB.
+    */
+    const std::size_t CachedMemoryMinimumClassSize = 16;
+    const std::size_t CachedMemoryClassCount = 12;
+
+    /**
+     * @brief The maximum number of the cached blocks of each size class per
+     *        thread.
+    */
+    const std::size_t CachedMemoryClassDepth = 32;
+
+    /**
+     * @brief The size class of the blocks which are not cached.
+    */
+    const std::size_t CachedMemoryLargeClass = CachedMemoryClassCount;
+
+    /**
+     * @brief The free lists of the size classes of a thread, the link to the
+     *        next block is stored in the freed block itself.
+    */
+    struct CachedMemoryCache
+    {
+        void* FreeLists[CachedMemoryClassCount] = {};
+        std::size_t Counts[CachedMemoryClassCount] = {};
+
+        void Trim() noexcept
+        {
+            for (std::size_t i = 0; i < CachedMemoryClassCount; ++i)
+            {
+                while (this->FreeLists[i])
+                {
+                    void* Block = this->FreeLists[i];
+                    this->FreeLists[i] = *reinterpret_cast<void**>(Block);
+                    std::free(
+                        static_cast<unsigned char*>(Block) -
+                        CachedMemoryHeaderSize);
+                }
+                this->Counts[i] = 0;
+            }
+        }
+
+        ~CachedMemoryCache();
+    };
+
+    /**
+     * @brief Whether the cache of the current thread is destroyed, the blocks
+     *        freed by the destructors of the other thread local objects after
+     *        that are freed directly.
+    */
+    static thread_local bool g_CachedMemoryCacheDestroyed = false;
+
+    CachedMemoryCache::~CachedMemoryCache()
+    {
+        this->Trim();
+        g_CachedMemoryCacheDestroyed = true;
+    }
+
+    static CachedMemoryCache* GetCachedMemoryCache() noexcept
+    {
+        if (g_CachedMemoryCacheDestroyed)
+        {
+            return nullptr;
+        }
+        static thread_local CachedMemoryCache Cache;
+        return &Cache;
+    }
+
+    static std::size_t GetCachedMemoryClass(
+        std::size_t Size) noexcept
+    {
+        std::size_t Class = 0;
+        std::size_t ClassSize = CachedMemoryMinimumClassSize;
+        while (ClassSize < Size && Class < CachedMemoryLargeClass)
+        {
+            ClassSize <<= 1;
+            ++Class;
+        }
+        return Class;
+    }
+}
+
+void* Mile::AllocateCachedMemory(
+    std::size_t Size) noexcept
+{
+    std::size_t Class = ::GetCachedMemoryClass(Size);
+    if (CachedMemoryLargeClass != Class)
+    {
+        CachedMemoryCache* Cache = ::GetCachedMemoryCache();
+        if (Cache && Cache->FreeLists[Class])
+        {
+            void* Block = Cache->FreeLists[Class];
+            Cache->FreeLists[Class] = *reinterpret_cast<void**>(Block);
+            --Cache->Counts[Class];
+            return Block;
+        }
+
+        Size = CachedMemoryMinimumClassSize << Class;
+    }
+    else if (Size > SIZE_MAX - CachedMemoryHeaderSize)
+    {
+        return nullptr;
+    }
+
+    unsigned char* Allocation = static_cast<unsigned char*>(
+        std::malloc(CachedMemoryHeaderSize + Size));
+    if (!Allocation)
+    {
+        return nullptr;
+    }
+
+    *reinterpret_cast<std::size_t*>(Allocation) = Class;
+    return Allocation + CachedMemoryHeaderSize;
+}
+
+void Mile::FreeCachedMemory(
+    void* Block) noexcept
+{
+    if (!Block)
+    {
+        return;
+    }
+
+    unsigned char* Allocation =
+        static_cast<unsigned char*>(Block) - CachedMemoryHeaderSize;
+    std::size_t Class = *reinterpret_cast<std::size_t*>(Allocation);
+    if (CachedMemoryLargeClass != Class)
+    {
+        CachedMemoryCache* Cache = ::GetCachedMemoryCache();
+        if (Cache && Cache->Counts[Class] < CachedMemoryClassDepth)
+        {
+            *reinterpret_cast<void**>(Block) = Cache->FreeLists[Class];
+            Cache->FreeLists[Class] = Block;
+            ++Cache->Counts[Class];
+            return;
+        }
+    }
+
+    std::free(Allocation);
+}
+
+void Mile::TrimCachedMemory() noexcept
+{
+    CachedMemoryCache* Cache = ::GetCachedMemoryCache();
+    if (Cache)
+    {
+        Cache->Trim();
+    }
+}
+
+Mile::ScopedArena::ScopedArena(
+    void* Buffer,
+    std::size_t Size) noexcept :
+    m_InitialBuffer(Buffer),
+    m_InitialSize(Size),
+    m_Current(reinterpret_cast<std::uintptr_t>(Buffer)),
+    m_End(reinterpret_cast<std::uintptr_t>(Buffer) + Size)
+{
+}
+
+Mile::ScopedArena::~ScopedArena() noexcept
+{
+    this->Reset();
+}
+
+void* Mile::ScopedArena::Allocate(
+    std::size_t Size,
+    std::size_t Alignment) noexcept
+{
+    if (!Alignment || (Alignment & (Alignment - 1)))
+    {
+        return nullptr;
+    }
+
+    std::uintptr_t Start =
+        (this->m_Current + Alignment - 1) & ~(Alignment - 1);
+    if (!this->m_Current ||
+        Start < this->m_Current ||
+        Start > this->m_End ||
+        Size > this->m_End - Start)
+    {
+        // Allocate a new chunk which is twice as large as the last one, from
+        // a memory page up to 64 KiB, unless the block needs more.
+        const std::size_t PageSize = Mile::GetPlatformInfo().PageSize;
+        const std::size_t MinimumChunkSize = PageSize - sizeof(ChunkHeader);
+        const std::size_t MaximumChunkSize =
+            (PageSize > 65536 ? PageSize : 65536) - sizeof(ChunkHeader);
+        if (Size > SIZE_MAX - Alignment - sizeof(ChunkHeader))
+        {
+            return nullptr;
+        }
+        std::size_t ChunkSize = MinimumChunkSize;
+        if (this->m_Chunks)
+        {
+            ChunkSize = this->m_Chunks->Size * 2 + sizeof(ChunkHeader);
+            if (ChunkSize > MaximumChunkSize)
+            {
+                ChunkSize = MaximumChunkSize;
+            }
+        }
+        if (ChunkSize < Size + Alignment)
+        {
+            ChunkSize = Size + Alignment;
+        }
+
+        ChunkHeader* Chunk = static_cast<ChunkHeader*>(
+            Mile::AllocateCachedMemory(sizeof(ChunkHeader) + ChunkSize));
+        if (!Chunk)
+        {
+            return nullptr;
+        }
+        MILE_ACCOUNT_ALLOCATION(
+            "Mile.ScopedArena",
+            sizeof(ChunkHeader) + ChunkSize);
+        Chunk->Previous = this->m_Chunks;
+        Chunk->Size = ChunkSize;
+        this->m_Chunks = Chunk;
+
+        this->m_Current = reinterpret_cast<std::uintptr_t>(Chunk + 1);
+        this->m_End = this->m_Current + ChunkSize;
+        Start = (this->m_Current + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    this->m_Current = Start + Size;
+    return reinterpret_cast<void*>(Start);
+}
+
+void Mile::ScopedArena::Reset() noexcept
+{
+    while (this->m_Chunks)
+    {
+        ChunkHeader* Previous = this->m_Chunks->Previous;
+        MILE_ACCOUNT_FREE(
+            "Mile.ScopedArena",
+            sizeof(ChunkHeader) + this->m_Chunks->Size);
+        Mile::FreeCachedMemory(this->m_Chunks);
+        this->m_Chunks = Previous;
+    }
+
+    this->m_Current = reinterpret_cast<std::uintptr_t>(this->m_InitialBuffer);
+    this->m_End = this->m_Current + this->m_InitialSize;
+}
+
+void* Mile::ResolveModuleExport(
+    char const* ModuleName,
+    char const* ExportName) noexcept
+{
+#ifdef _WIN32
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP | WINAPI_PARTITION_SYSTEM)
+    // Pin the module if it is loaded, otherwise load it and never free it.
+    HMODULE ModuleHandle = nullptr;
+    if (!::GetModuleHandleExA(
+        GET_MODULE_HANDLE_EX_FLAG_PIN,
+        ModuleName,
+        &ModuleHandle))
+    {
+        ModuleHandle = ::LoadLibraryExA(
+            ModuleName,
+            nullptr,
+            LOAD_LIBRARY_SEARCH_SYSTEM32);
+        if (!ModuleHandle)
+        {
+            return nullptr;
+        }
+    }
+
+    return reinterpret_cast<void*>(::GetProcAddress(ModuleHandle, ExportName));
+#else
+    Mile::UnreferencedParameter(ModuleName);
+    Mile::UnreferencedParameter(ExportName);
+    return nullptr;
+#endif
+#else
+    // The handle is never closed, and RTLD_NODELETE keeps the module loaded
+    // even if the other users close their handles.
+    void* ModuleHandle = ::dlopen(ModuleName, RTLD_NOW | RTLD_NODELETE);
+    if (!ModuleHandle)
+    {
+        return nullptr;
+    }
+
+    return ::dlsym(ModuleHandle, ExportName);
+#endif
+}
+
+namespace
+{
+#if defined(_M_X64) || defined(_M_IX86) || \
+    defined(__x86_64__) || defined(__i386__)
+
+    static void QueryProcessorIdentification(
+        unsigned int Leaf,
+        unsigned int SubLeaf,
+        unsigned int (&Registers)[4]) noexcept
+    {
+#if defined(_MSC_VER)
+        int Values[4] = {};
+        ::__cpuidex(
+            Values,
+            static_cast<int>(Leaf),
+            static_cast<int>(SubLeaf));
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            Registers[i] = static_cast<unsigned int>(Values[i]);
+        }
+#else
+        if (!::__get_cpuid_count(
+            Leaf,
+            SubLeaf,
+            &Registers[0],
+            &Registers[1],
+            &Registers[2],
+            &Registers[3]))
+        {
+            Registers[0] = Registers[1] = Registers[2] = Registers[3] = 0;
+        }
+#endif
+    }
+
+    static std::uint64_t QueryExtendedControlRegister() noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return ::_xgetbv(0);
+#else
+        unsigned int Low = 0;
+        unsigned int High = 0;
+        __asm__ __volatile__("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+        return (static_cast<std::uint64_t>(High) << 32) | Low;
+#endif
+    }
+
+#endif
+
+    static void QueryProcessorFeatures(
+        Mile::PlatformInfo& Information) noexcept
+    {
+#if defined(_M_X64) || defined(_M_IX86) || \
+    defined(__x86_64__) || defined(__i386__)
+        unsigned int Registers[4] = {};
+        ::QueryProcessorIdentification(0, 0, Registers);
+        unsigned int MaximumLeaf = Registers[0];
+        if (MaximumLeaf < 1)
+        {
+            return;
+        }
+
+        ::QueryProcessorIdentification(1, 0, Registers);
+        Information.HasSse2 = 0 != (Registers[3] & (1u << 26));
+        // The CLFLUSH line size in 8-byte units, which is the size of the
+        // cache line on all known processors.
+        std::size_t CacheLineSize = ((Registers[1] >> 8) & 0xFF) * 8;
+        if (CacheLineSize)
+        {
+            Information.CacheLineSize = CacheLineSize;
+        }
+
+        // The AVX state is only usable when the operating system saves the
+        // XMM and YMM registers on the context switches.
+        bool IsAvxStateEnabled =
+            0 != (Registers[2] & (1u << 27)) &&
+            0 != (Registers[2] & (1u << 28)) &&
+            0x6 == (::QueryExtendedControlRegister() & 0x6);
+        if (IsAvxStateEnabled && MaximumLeaf >= 7)
+        {
+            ::QueryProcessorIdentification(7, 0, Registers);
+            Information.HasAvx2 = 0 != (Registers[1] & (1u << 5));
+        }
+#elif defined(_M_ARM64) || defined(__aarch64__)
+        // NEON is mandatory on AArch64.
+        Information.HasNeon = true;
+#else
+        Mile::UnreferencedParameter(Information);
+#endif
+    }
+
+#ifndef _WIN32
+
+    static std::string ReadSystemFileLine(
+        char const* Path)
+    {
+        std::string Line;
+
+        std::FILE* FileHandle = std::fopen(Path, "r");
+        if (FileHandle)
+        {
+            char Buffer[256];
+            if (std::fgets(Buffer, sizeof(Buffer), FileHandle))
+            {
+                Line = Buffer;
+                while (!Line.empty() &&
+                    ('\n' == Line.back() || ' ' == Line.back()))
+                {
+                    Line.pop_back();
+                }
+            }
+            std::fclose(FileHandle);
+        }
+
+        return Line;
+    }
+
+    static std::size_t ReadSystemFileNumber(
+        char const* Path)
+    {
+        std::string Line = ::ReadSystemFileLine(Path);
+        return Line.empty()
+            ? 0
+            : static_cast<std::size_t>(
+                std::strtoull(Line.c_str(), nullptr, 10));
+    }
+
+    /**
+     * @brief Counts the items of a sysfs list like "0-3,8,10-11".
+    */
+    static std::uint32_t CountSystemListItems(
+        std::string const& List)
+    {
+        std::uint32_t Count = 0;
+
+        char const* Current = List.c_str();
+        while (*Current)
+        {
+            char* End = nullptr;
+            unsigned long First = std::strtoul(Current, &End, 10);
+            if (End == Current)
+            {
+                break;
+            }
+            unsigned long Last = First;
+            Current = End;
+            if ('-' == *Current)
+            {
+                ++Current;
+                Last = std::strtoul(Current, &End, 10);
+                if (End == Current || Last < First)
+                {
+                    break;
+                }
+                Current = End;
+            }
+            Count += static_cast<std::uint32_t>(Last - First + 1);
+            if (',' == *Current)
+            {
+                ++Current;
+            }
+        }
+
+        return Count;
+    }
+
+#endif
+}
+
+Mile::PlatformInfo const& Mile::GetPlatformInfo() noexcept
+{
+    static const Mile::PlatformInfo Information = []() -> Mile::PlatformInfo
+    {
+        Mile::PlatformInfo Result = {};
+        Result.PageSize = 4096;
+        Result.CacheLineSize = 64;
+        Result.LogicalProcessorCount = 1;
+        Result.ProcessorCoreCount = 1;
+        Result.NumaNodeCount = 1;
+
+        ::QueryProcessorFeatures(Result);
+
+#ifdef _WIN32
+        // RtlGetVersion reports the real version, which is not affected by
+        // the compatibility manifest of the application.
+        static const Mile::LazyProc<LONG NTAPI(PRTL_OSVERSIONINFOW)>
+            RtlGetVersion("ntdll.dll", "RtlGetVersion");
+        RTL_OSVERSIONINFOW VersionInformation = {};
+        VersionInformation.dwOSVersionInfoSize = sizeof(RTL_OSVERSIONINFOW);
+        if (RtlGetVersion && 0 == RtlGetVersion(&VersionInformation))
+        {
+            Result.MajorVersion = VersionInformation.dwMajorVersion;
+            Result.MinorVersion = VersionInformation.dwMinorVersion;
+            Result.BuildNumber = VersionInformation.dwBuildNumber;
+        }
+
+        SYSTEM_INFO SystemInformation = {};
+        ::GetNativeSystemInfo(&SystemInformation);
+        Result.PageSize = SystemInformation.dwPageSize;
+        Result.LogicalProcessorCount =
+            SystemInformation.dwNumberOfProcessors;
+
+#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP | WINAPI_PARTITION_SYSTEM)
+        Result.LargePageSize = ::GetLargePageMinimum();
+#endif
+
+        // The information covers the processors in all processor groups.
+        Mile::ProbeAndFill<unsigned char, 4096>(
+            [](unsigned char* Buffer, std::size_t& Size) -> bool
+            {
+                DWORD Length = static_cast<DWORD>(Size);
+                if (::GetLogicalProcessorInformationEx(
+                    RelationAll,
+                    reinterpret_cast<
+                        PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(Buffer),
+                    &Length))
+                {
+                    Size = Length;
+                    return true;
+                }
+                if (ERROR_INSUFFICIENT_BUFFER == ::GetLastError())
+                {
+                    Size = Length;
+                }
+                return false;
+            },
+            [&](unsigned char const* Buffer, std::size_t Length) -> bool
+            {
+                std::uint32_t LogicalProcessorCount = 0;
+                std::uint32_t ProcessorCoreCount = 0;
+                std::uint32_t NumaNodeCount = 0;
+                for (std::size_t Offset = 0; Offset < Length;)
+                {
+                    auto Current = reinterpret_cast<
+                        PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(
+                            const_cast<unsigned char*>(Buffer + Offset));
+                    if (RelationProcessorCore == Current->Relationship)
+                    {
+                        ++ProcessorCoreCount;
+                        for (WORD i = 0; i < Current->Processor.GroupCount; ++i)
+                        {
+                            KAFFINITY Mask =
+                                Current->Processor.GroupMask[i].Mask;
+                            while (Mask)
+                            {
+                                Mask &= Mask - 1;
+                                ++LogicalProcessorCount;
+                            }
+                        }
+                    }
+                    else if (RelationNumaNode == Current->Relationship)
+                    {
+                        ++NumaNodeCount;
+                    }
+                    else if (RelationCache == Current->Relationship)
+                    {
+                        if (1 == Current->Cache.Level &&
+                            (CacheData == Current->Cache.Type ||
+                            CacheUnified == Current->Cache.Type) &&
+                            Current->Cache.LineSize)
+                        {
+                            Result.CacheLineSize = Current->Cache.LineSize;
+                        }
+                    }
+                    if (!Current->Size)
+                    {
+                        break;
+                    }
+                    Offset += Current->Size;
+                }
+                if (LogicalProcessorCount)
+                {
+                    Result.LogicalProcessorCount = LogicalProcessorCount;
+                }
+                if (ProcessorCoreCount)
+                {
+                    Result.ProcessorCoreCount = ProcessorCoreCount;
+                }
+                if (NumaNodeCount)
+                {
+                    Result.NumaNodeCount = NumaNodeCount;
+                }
+                return true;
+            });
+#else
+        struct utsname SystemName;
+        if (0 == ::uname(&SystemName))
+        {
+            // The kernel release looks like "6.1.0-13-amd64".
+            unsigned int Versions[3] = {};
+            char const* Current = SystemName.release;
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                char* End = nullptr;
+                Versions[i] = static_cast<unsigned int>(
+                    std::strtoul(Current, &End, 10));
+                if (End == Current || '.' != *End)
+                {
+                    break;
+                }
+                Current = End + 1;
+            }
+            Result.MajorVersion = Versions[0];
+            Result.MinorVersion = Versions[1];
+            Result.BuildNumber = Versions[2];
+        }
+
+        long PageSize = ::sysconf(_SC_PAGESIZE);
+        if (PageSize > 0)
+        {
+            Result.PageSize = static_cast<std::size_t>(PageSize);
+        }
+
+        // The transparent huge pages are not available when they are
+        // disabled with "[never]".
+        std::string HugePageMode = ::ReadSystemFileLine(
+            "/sys/kernel/mm/transparent_hugepage/enabled");
+        if (!HugePageMode.empty() &&
+            std::string::npos == HugePageMode.find("[never]"))
+        {
+            Result.LargePageSize = ::ReadSystemFileNumber(
+                "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+        }
+
+        std::size_t CacheLineSize = ::ReadSystemFileNumber(
+            "/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size");
+        if (CacheLineSize)
+        {
+            Result.CacheLineSize = CacheLineSize;
+        }
+
+        long LogicalProcessorCount = ::sysconf(_SC_NPROCESSORS_ONLN);
+        if (LogicalProcessorCount > 0)
+        {
+            Result.LogicalProcessorCount =
+                static_cast<std::uint32_t>(LogicalProcessorCount);
+        }
+
+        // Each core is counted by its first hardware thread.
+        long ConfiguredCount = ::sysconf(_SC_NPROCESSORS_CONF);
+        std::uint32_t ProcessorCoreCount = 0;
+        for (long i = 0; i < ConfiguredCount; ++i)
+        {
+            char Path[96];
+            std::snprintf(
+                Path,
+                sizeof(Path),
+                "/sys/devices/system/cpu/cpu%ld/topology/thread_siblings_list",
+                i);
+            std::string Siblings = ::ReadSystemFileLine(Path);
+            if (!Siblings.empty() &&
+                static_cast<unsigned long>(i) ==
+                std::strtoul(Siblings.c_str(), nullptr, 10))
+            {
+                ++ProcessorCoreCount;
+            }
+        }
+        if (ProcessorCoreCount)
+        {
+            Result.ProcessorCoreCount = ProcessorCoreCount;
+        }
+
+        std::uint32_t NumaNodeCount = ::CountSystemListItems(
+            ::ReadSystemFileLine("/sys/devices/system/node/online"));
+        if (NumaNodeCount)
+        {
+            Result.NumaNodeCount = NumaNodeCount;
+        }
+#endif
+
+        return Result;
+    }();
+    return Information;
+}
+
+namespace
+{
+    /**
+     * @brief Parks the calling thread while the value equals to the compare
+     *        value. It may return spuriously, and the callers check the value
+     *        again.
+     * @param Address The address of the value.
+     * @param CompareValue The compare value.
+    */
+    static void WaitOnAtomicValue(
+        std::atomic<std::uint32_t>* Address,
+        std::uint32_t CompareValue) noexcept
+    {
+#ifdef _WIN32
+        static const Mile::LazyProc<BOOL WINAPI(
+            volatile VOID*,
+            PVOID,
+            SIZE_T,
+            DWORD)> WaitOnAddressProc(
+                "api-ms-win-core-synch-l1-2-0.dll",
+                "WaitOnAddress");
+        if (WaitOnAddressProc)
+        {
+            WaitOnAddressProc(
+                Address,
+                &CompareValue,
+                sizeof(CompareValue),
+                INFINITE);
+        }
+        else
+        {
+            // Poll on the systems without WaitOnAddress.
+            ::SwitchToThread();
+        }
+#else
+        ::syscall(
+            SYS_futex,
+            reinterpret_cast<std::uint32_t*>(Address),
+            FUTEX_WAIT_PRIVATE,
+            CompareValue,
+            nullptr,
+            nullptr,
+            0);
+#endif
+    }
+
+    /**
+     * @brief Wakes the threads parked on the value.
+     * @param Address The address of the value.
+     * @param Count The maximum number of the threads to wake, INT_MAX wakes
+     *              all threads.
+    */
+    static void WakeAtomicValueWaiters(
+        std::atomic<std::uint32_t>* Address,
+        int Count) noexcept
+    {
+#ifdef _WIN32
+        static const Mile::LazyProc<VOID WINAPI(PVOID)> WakeByAddressSingleProc(
+            "api-ms-win-core-synch-l1-2-0.dll",
+            "WakeByAddressSingle");
+        static const Mile::LazyProc<VOID WINAPI(PVOID)> WakeByAddressAllProc(
+            "api-ms-win-core-synch-l1-2-0.dll",
+            "WakeByAddressAll");
+        if (1 == Count)
+        {
+            if (WakeByAddressSingleProc)
+            {
+                WakeByAddressSingleProc(Address);
+            }
+        }
+        else if (WakeByAddressAllProc)
+        {
+            WakeByAddressAllProc(Address);
+        }
+#else
+        ::syscall(
+            SYS_futex,
+            reinterpret_cast<std::uint32_t*>(Address),
+            FUTEX_WAKE_PRIVATE,
+            Count,
+            nullptr,
+            nullptr,
+            0);
+#endif
+    }
+
+    /**
+     * @brief Hints the processor that the calling thread is spinning.
+    */
+    static void PauseProcessor() noexcept
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        ::_mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM64) || defined(_M_ARM))
+        ::__yield();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#else
+        std::this_thread::yield();
+#endif
+    }
+}
+
+void Mile::AdaptiveMutex::LockContended() noexcept
+{
+    std::uint32_t MaximumSpinCount = this->m_MaximumSpinCount.load(
+        std::memory_order_relaxed);
+    if (Mile::GetPlatformInfo().LogicalProcessorCount < 2)
+    {
+        // Spinning cannot help when the owner needs the only processor.
+        MaximumSpinCount = 0;
+    }
+    if (MaximumSpinCount)
+    {
+        // Spin up to twice the learned budget, and move the budget towards
+        // the number of spins used, like the adaptive mutexes of glibc.
+        std::uint32_t SpinBudget = this->m_SpinBudget.load(
+            std::memory_order_relaxed);
+        std::uint32_t SpinLimit = SpinBudget * 2 + 10;
+        if (SpinLimit > MaximumSpinCount)
+        {
+            SpinLimit = MaximumSpinCount;
+        }
+
+        std::uint32_t SpinCount = 0;
+        bool Acquired = false;
+        while (SpinCount < SpinLimit)
+        {
+            ++SpinCount;
+            ::PauseProcessor();
+            // Only try to acquire when the lock looks free, to avoid bouncing
+            // the cache line between the spinning threads.
+            std::uint32_t State = this->m_State.load(
+                std::memory_order_relaxed);
+            if (0 == State && this->m_State.compare_exchange_weak(
+                State,
+                1,
+                std::memory_order_acquire,
+                std::memory_order_relaxed))
+            {
+                Acquired = true;
+                break;
+            }
+        }
+
+        std::int64_t Delta =
+            (static_cast<std::int64_t>(SpinCount) - SpinBudget) / 8;
+        this->m_SpinBudget.store(
+            static_cast<std::uint32_t>(SpinBudget + Delta),
+            std::memory_order_relaxed);
+
+        if (Acquired)
+        {
+            return;
+        }
+    }
+
+    // The state is set to 2 when parking, so the owner knows it needs to wake
+    // a waiter.
+    while (0 != this->m_State.exchange(2, std::memory_order_acquire))
+    {
+        ::WaitOnAtomicValue(&this->m_State, 2);
+    }
+}
+
+void Mile::AdaptiveMutex::WakeWaiter() noexcept
+{
+    ::WakeAtomicValueWaiters(&this->m_State, 1);
+}
+
+void Mile::DistributedSharedLock::Initialize() noexcept
+{
+    Mile::PlatformInfo const& Information = Mile::GetPlatformInfo();
+
+    // Pad the slots to two cache lines, because the adjacent line prefetchers
+    // fetch the cache lines in pairs.
+    std::size_t CacheLineSize = Information.CacheLineSize;
+    if (CacheLineSize < sizeof(std::atomic<std::uint32_t>))
+    {
+        CacheLineSize = 64;
+    }
+    std::size_t SlotStride = CacheLineSize * 2;
+
+    // Use one slot per logical processor, so every thread on a processor
+    // shares at most one slot with the others when there are more threads.
+    std::size_t SlotCount = 1;
+    while (SlotCount < Information.LogicalProcessorCount && SlotCount < 256)
+    {
+        SlotCount *= 2;
+    }
+
+    // The writer state and the writer waiting flag take the first stride and
+    // the slots the others, and one more stride is reserved for aligning the
+    // start.
+    this->m_Allocation = std::malloc((SlotCount + 2) * SlotStride);
+    if (this->m_Allocation)
+    {
+        std::uintptr_t Base = reinterpret_cast<std::uintptr_t>(
+            this->m_Allocation);
+        Base = (Base + SlotStride - 1) & ~(SlotStride - 1);
+        unsigned char* Storage = reinterpret_cast<unsigned char*>(Base);
+        this->m_WriterState = new (Storage) std::atomic<std::uint32_t>(0);
+        this->m_WriterWaiting = new (Storage + sizeof(std::uint32_t))
+            std::atomic<std::uint32_t>(0);
+        this->m_Slots = Storage + SlotStride;
+        this->m_SlotStride = SlotStride;
+        this->m_SlotMask = SlotCount - 1;
+        for (std::size_t i = 0; i < SlotCount; ++i)
+        {
+            new (this->m_Slots + i * SlotStride) std::atomic<std::uint32_t>(0);
+        }
+    }
+    else
+    {
+        // Fall back to a single slot, which behaves like an ordinary
+        // reader/writer lock.
+        this->m_InlineStorage[0].store(0, std::memory_order_relaxed);
+        this->m_InlineStorage[1].store(0, std::memory_order_relaxed);
+        this->m_InlineStorage[2].store(0, std::memory_order_relaxed);
+        this->m_WriterState = &this->m_InlineStorage[0];
+        this->m_WriterWaiting = &this->m_InlineStorage[1];
+        this->m_Slots = reinterpret_cast<unsigned char*>(
+            &this->m_InlineStorage[2]);
+        this->m_SlotStride = sizeof(std::atomic<std::uint32_t>);
+        this->m_SlotMask = 0;
+    }
+}
+
+Mile::DistributedSharedLock::~DistributedSharedLock() noexcept
+{
+    std::free(this->m_Allocation);
+}
+
+std::size_t Mile::DistributedSharedLock::AllocateThreadSlotIndex() noexcept
+{
+    // Assign the slots round-robin, so the threads running at the same time
+    // are likely to get different slots.
+    static std::atomic<std::size_t> NextIndex(0);
+    return NextIndex.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Mile::DistributedSharedLock::WaitForWriter(
+    std::atomic<std::uint32_t>* Slot) noexcept
+{
+    do
+    {
+        // Withdraw from the slot so the writer does not wait for this thread.
+        this->ReleaseSlot(Slot);
+
+        std::uint32_t State = this->m_WriterState->load(
+            std::memory_order_relaxed);
+        while (0 != State)
+        {
+            // The state is set to 2 when parking, so the writer knows it needs
+            // to wake the readers.
+            if (1 == State && !this->m_WriterState->compare_exchange_weak(
+                State,
+                2,
+                std::memory_order_relaxed,
+                std::memory_order_relaxed))
+            {
+                continue;
+            }
+            ::WaitOnAtomicValue(this->m_WriterState, 2);
+            State = this->m_WriterState->load(std::memory_order_relaxed);
+        }
+
+        Slot->fetch_add(1, std::memory_order_seq_cst);
+    } while (this->m_WriterState->load(std::memory_order_seq_cst));
+}
+
+void Mile::DistributedSharedLock::WaitForReaders() noexcept
+{
+    for (std::size_t i = 0; i <= this->m_SlotMask; ++i)
+    {
+        std::atomic<std::uint32_t>* Slot =
+            reinterpret_cast<std::atomic<std::uint32_t>*>(
+                this->m_Slots + i * this->m_SlotStride);
+        // The shared owners usually leave soon and the new readers back off,
+        // so spin for a while before parking.
+        std::uint32_t SpinCount = 0;
+        bool Waiting = false;
+        std::uint32_t Count = Slot->load(std::memory_order_seq_cst);
+        while (0 != Count)
+        {
+            if (SpinCount < 100)
+            {
+                ++SpinCount;
+                ::PauseProcessor();
+            }
+            else
+            {
+                if (!Waiting)
+                {
+                    // The store and the load of the slot are sequentially
+                    // consistent, pairing with ReleaseSlot.
+                    Waiting = true;
+                    this->m_WriterWaiting->store(1, std::memory_order_seq_cst);
+                    Count = Slot->load(std::memory_order_seq_cst);
+                    if (0 == Count)
+                    {
+                        break;
+                    }
+                }
+                ::WaitOnAtomicValue(Slot, Count);
+            }
+            Count = Slot->load(std::memory_order_seq_cst);
+        }
+        if (Waiting)
+        {
+            this->m_WriterWaiting->store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Mile::DistributedSharedLock::AreReadersDrained() const noexcept
+{
+    for (std::size_t i = 0; i <= this->m_SlotMask; ++i)
+    {
+        std::atomic<std::uint32_t>* Slot =
+            reinterpret_cast<std::atomic<std::uint32_t>*>(
+                this->m_Slots + i * this->m_SlotStride);
+        if (0 != Slot->load(std::memory_order_seq_cst))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Mile::DistributedSharedLock::WakeWriter(
+    std::atomic<std::uint32_t>* Slot) noexcept
+{
+    ::WakeAtomicValueWaiters(Slot, 1);
+}
+
+void Mile::DistributedSharedLock::ReleaseWriterState() noexcept
+{
+    if (2 == this->m_WriterState->exchange(0, std::memory_order_release))
+    {
+        ::WakeAtomicValueWaiters(this->m_WriterState, INT_MAX);
+    }
+}
+
+#ifndef _WIN32
+
+std::string Mile::ReadSymbolicLink(
+    std::string const& Path)
+{
+    std::string Target;
+
+    Mile::ProbeAndFill<char>(
+        [&](char* Buffer, std::size_t& Size) -> bool
+        {
+            ssize_t Length = ::readlink(Path.c_str(), Buffer, Size);
+            if (Length < 0)
+            {
+                return false;
+            }
+            if (static_cast<std::size_t>(Length) == Size)
+            {
+                // The target may be truncated, and readlink does not report
+                // the required size.
+                Size *= 2;
+                return false;
+            }
+            Size = static_cast<std::size_t>(Length);
+            return true;
+        },
+        [&](char const* Buffer, std::size_t Length) -> bool
+        {
+            Target.assign(Buffer, Length);
+            return true;
+        });
+
+    return Target;
+}
+
+std::string Mile::GetCurrentWorkingDirectory()
+{
+    std::string Path;
+
+    Mile::ProbeAndFill<char>(
+        [](char* Buffer, std::size_t& Size) -> bool
+        {
+            if (!::getcwd(Buffer, Size))
+            {
+                if (ERANGE == errno)
+                {
+                    // getcwd does not report the required size.
+                    Size *= 2;
+                }
+                return false;
+            }
+            Size = std::strlen(Buffer);
+            return true;
+        },
+        [&](char const* Buffer, std::size_t Length) -> bool
+        {
+            Path.assign(Buffer, Length);
+            return true;
+        });
+
+    return Path;
+}
+
+std::string Mile::GetConfigurationString(
+    int Name)
+{
+    std::string Value;
+
+    Mile::ProbeAndFill<char>(
+        [=](char* Buffer, std::size_t& Size) -> bool
+        {
+            // The returned length includes the terminating null character.
+            std::size_t Length = ::confstr(Name, Buffer, Size);
+            if (!Length)
+            {
+                return false;
+            }
+            if (Length > Size)
+            {
+                Size = Length;
+                return false;
+            }
+            Size = Length - 1;
+            return true;
+        },
+        [&](char const* Buffer, std::size_t Length) -> bool
+        {
+            Value.assign(Buffer, Length);
+            return true;
+        });
+
+    return Value;
+}
+
+std::string const& Mile::GetCurrentProcessModulePath()
+{
+    // The initialization of the function-local static object is thread-safe,
+    // and only costs a load after that.
+    static const std::string Path = Mile::ReadSymbolicLink("/proc/self/exe");
+    return Path;
+}
+
+std::vector<std::string> const& Mile::GetSystemExecutableDirectories()
+{
+    static const std::vector<std::string> Directories = []()
+    {
+        std::vector<std::string> Result;
+
+        std::string Paths = Mile::GetConfigurationString(_CS_PATH);
+        std::size_t Start = 0;
+        while (Start <= Paths.size())
+        {
+            std::size_t End = Paths.find(':', Start);
+            if (std::string::npos == End)
+            {
+                End = Paths.size();
+            }
+
+            std::string Path = Paths.substr(Start, End - Start);
+            char* CanonicalPath =
+                Path.empty() ? nullptr : ::realpath(Path.c_str(), nullptr);
+            if (CanonicalPath)
+            {
+                if (Result.end() == std::find(
+                    Result.begin(),
+                    Result.end(),
+                    CanonicalPath))
+                {
+                    Result.emplace_back(CanonicalPath);
+                }
+                std::free(CanonicalPath);
+            }
+
+            Start = End + 1;
+        }
+
+        return Result;
+    }();
+    return Directories;
+}
+
+void Mile::CriticalSection::EnterContended(
+    Mile::RawCriticalSection* lpCriticalSection) noexcept
+{
+    // The state is set to 2 when waiting, so the owner knows it needs to wake
+    // a waiter. The state stays at 2 after acquiring, because there may be
+    // other waiters.
+    while (0 != lpCriticalSection->State.exchange(
+        2,
+        std::memory_order_acquire))
+    {
+        ::WaitOnAtomicValue(&lpCriticalSection->State, 2);
+    }
+}
+
+void Mile::CriticalSection::WakeWaiter(
+    Mile::RawCriticalSection* lpCriticalSection) noexcept
+{
+    ::WakeAtomicValueWaiters(&lpCriticalSection->State, 1);
+}
+
+void Mile::SRWLock::AcquireExclusiveContended(
+    Mile::RawSRWLock* SRWLock) noexcept
+{
+    std::uint32_t State = SRWLock->State.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        if (!(State & OwnerMask))
+        {
+            if (SRWLock->State.compare_exchange_weak(
+                State,
+                State | ExclusiveOwned,
+                std::memory_order_acquire,
+                std::memory_order_relaxed))
+            {
+                return;
+            }
+            continue;
+        }
+
+        if (!(State & WritersWaiting))
+        {
+            if (!SRWLock->State.compare_exchange_weak(
+                State,
+                State | WritersWaiting,
+                std::memory_order_relaxed,
+                std::memory_order_relaxed))
+            {
+                continue;
+            }
+            State |= WritersWaiting;
+        }
+
+        ::WaitOnAtomicValue(&SRWLock->State, State);
+        State = SRWLock->State.load(std::memory_order_relaxed);
+    }
+}
+
+void Mile::SRWLock::AcquireSharedContended(
+    Mile::RawSRWLock* SRWLock) noexcept
+{
+    std::uint32_t State = SRWLock->State.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        if (IsSharedAcquirable(State))
+        {
+            if (SRWLock->State.compare_exchange_weak(
+                State,
+                State + 1,
+                std::memory_order_acquire,
+                std::memory_order_relaxed))
+            {
+                return;
+            }
+            continue;
+        }
+
+        if (!(State & OwnerMask))
+        {
+            // The waiting bits are only set when the lock is owned, so this
+            // is a transient state which is cleared by the releasing thread.
+            std::this_thread::yield();
+            State = SRWLock->State.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (!(State & ReadersWaiting))
+        {
+            if (!SRWLock->State.compare_exchange_weak(
+                State,
+                State | ReadersWaiting,
+                std::memory_order_relaxed,
+                std::memory_order_relaxed))
+            {
+                continue;
+            }
+            State |= ReadersWaiting;
+        }
+
+        ::WaitOnAtomicValue(&SRWLock->State, State);
+        State = SRWLock->State.load(std::memory_order_relaxed);
+    }
+}
+
+void Mile::SRWLock::WakeWaiters(
+    Mile::RawSRWLock* SRWLock) noexcept
+{
+    ::WakeAtomicValueWaiters(&SRWLock->State, INT_MAX);
+}
+
+#endif
+
+#ifdef MILE_ENABLE_ALLOCATION_ACCOUNTING
+
+namespace
+{
+    /**
+     * @brief The maximum number of the tagged call sites.
+    */
+    const std::size_t MaximumAllocationSiteCount = 256;
+
+    /**
+     * @brief The number of the events of a call site cached by a thread before
+     *        merging them into the statistics of the call site.
+    */
+    const std::uint32_t AllocationFlushThreshold = 64;
+
+    /**
+     * @brief The statistics of a call site shared by all threads.
+    */
+    struct AllocationSiteCounters
+    {
+        char const* Name = nullptr;
+        bool HandedOff = false;
+        std::atomic<std::uint64_t> AllocationCount{ 0 };
+        std::atomic<std::uint64_t> FreeCount{ 0 };
+        std::atomic<std::uint64_t> AllocatedBytes{ 0 };
+        std::atomic<std::uint64_t> FreedBytes{ 0 };
+        std::atomic<std::int64_t> LiveBytes{ 0 };
+        std::atomic<std::int64_t> PeakLiveBytes{ 0 };
+    };
+
+    /**
+     * @brief The registry of the call sites, which is never destroyed for
+     *        accounting the allocations in the static destructors.
+    */
+    struct AllocationSiteRegistry
+    {
+        std::mutex Mutex;
+        std::atomic<std::size_t> Count{ 0 };
+        AllocationSiteCounters Sites[MaximumAllocationSiteCount];
+    };
+
+    static AllocationSiteRegistry& GetAllocationSiteRegistry()
+    {
+        static AllocationSiteRegistry* Registry = new AllocationSiteRegistry();
+        return *Registry;
+    }
+
+    /**
+     * @brief The events of a call site cached by a thread since the last
+     *        merge.
+    */
+    struct AllocationThreadCounters
+    {
+        std::uint64_t AllocationCount;
+        std::uint64_t FreeCount;
+        std::uint64_t AllocatedBytes;
+        std::uint64_t FreedBytes;
+        std::int64_t LiveBytes;
+        std::int64_t PeakLiveBytes;
+        std::uint32_t PendingCount;
+    };
+
+    static void MergeAllocationThreadCounters(
+        std::size_t Site,
+        AllocationThreadCounters& Counters) noexcept
+    {
+        AllocationSiteCounters& Target =
+            ::GetAllocationSiteRegistry().Sites[Site];
+
+        Target.AllocationCount.fetch_add(
+            Counters.AllocationCount,
+            std::memory_order_relaxed);
+        Target.FreeCount.fetch_add(
+            Counters.FreeCount,
+            std::memory_order_relaxed);
+        Target.AllocatedBytes.fetch_add(
+            Counters.AllocatedBytes,
+            std::memory_order_relaxed);
+        Target.FreedBytes.fetch_add(
+            Counters.FreedBytes,
+            std::memory_order_relaxed);
+
+        if (Target.HandedOff)
+        {
+            // The frees are not recorded, so the live bytes are meaningless.
+            Counters = AllocationThreadCounters();
+            return;
+        }
+
+        // The peak of the batch is applied on top of the live bytes before the
+        // batch, which is exact when only one thread uses the call site.
+        std::int64_t LiveBytes = Target.LiveBytes.fetch_add(
+            Counters.LiveBytes,
+            std::memory_order_relaxed);
+        std::int64_t PeakLiveBytes = LiveBytes + Counters.PeakLiveBytes;
+        std::int64_t Current = Target.PeakLiveBytes.load(
+            std::memory_order_relaxed);
+        while (Current < PeakLiveBytes &&
+            !Target.PeakLiveBytes.compare_exchange_weak(
+                Current,
+                PeakLiveBytes,
+                std::memory_order_relaxed))
+        {
+        }
+
+        Counters = AllocationThreadCounters();
+    }
+
+    /**
+     * @brief The events of all call sites cached by a thread.
+    */
+    struct AllocationThreadCache
+    {
+        AllocationThreadCounters Sites[MaximumAllocationSiteCount] = {};
+
+        void Flush() noexcept
+        {
+            std::size_t Count = ::GetAllocationSiteRegistry().Count.load(
+                std::memory_order_acquire);
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                if (this->Sites[i].PendingCount)
+                {
+                    ::MergeAllocationThreadCounters(i, this->Sites[i]);
+                }
+            }
+        }
+
+        ~AllocationThreadCache();
+    };
+
+    /**
+     * @brief Whether the cache of the current thread is destroyed, the events
+     *        recorded by the destructors of the other thread local objects
+     *        after that are merged directly.
+    */
+    static thread_local bool g_AllocationThreadCacheDestroyed = false;
+
+    AllocationThreadCache::~AllocationThreadCache()
+    {
+        this->Flush();
+        g_AllocationThreadCacheDestroyed = true;
+    }
+
+    static AllocationThreadCache* GetAllocationThreadCache() noexcept
+    {
+        if (g_AllocationThreadCacheDestroyed)
+        {
+            return nullptr;
+        }
+        static thread_local AllocationThreadCache Cache;
+        return &Cache;
+    }
+
+    static void RecordAllocationEvent(
+        std::size_t Site,
+        std::size_t Size,
+        bool Allocation) noexcept
+    {
+        if (Site >= MaximumAllocationSiteCount)
+        {
+            return;
+        }
+
+        AllocationThreadCounters Local = {};
+        AllocationThreadCache* Cache = ::GetAllocationThreadCache();
+        AllocationThreadCounters& Counters =
+            Cache ? Cache->Sites[Site] : Local;
+
+        if (Allocation)
+        {
+            ++Counters.AllocationCount;
+            Counters.AllocatedBytes += Size;
+            Counters.LiveBytes += static_cast<std::int64_t>(Size);
+            if (Counters.PeakLiveBytes < Counters.LiveBytes)
+            {
+                Counters.PeakLiveBytes = Counters.LiveBytes;
+            }
+        }
+        else
+        {
+            ++Counters.FreeCount;
+            Counters.FreedBytes += Size;
+            Counters.LiveBytes -= static_cast<std::int64_t>(Size);
+        }
+
+        if (!Cache || ++Counters.PendingCount >= AllocationFlushThreshold)
+        {
+            ::MergeAllocationThreadCounters(Site, Counters);
+        }
+    }
+}
+
+std::size_t Mile::RegisterAllocationSite(
+    char const* Name,
+    bool HandedOff) noexcept
+{
+    AllocationSiteRegistry& Registry = ::GetAllocationSiteRegistry();
+
+    std::lock_guard<std::mutex> Lock(Registry.Mutex);
+
+    std::size_t Count = Registry.Count.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        if (0 == std::strcmp(Registry.Sites[i].Name, Name))
+        {
+            return i;
+        }
+    }
+
+    if (Count >= MaximumAllocationSiteCount)
+    {
+        return SIZE_MAX;
+    }
+
+    Registry.Sites[Count].Name = Name;
+    Registry.Sites[Count].HandedOff = HandedOff;
+    Registry.Count.store(Count + 1, std::memory_order_release);
+    return Count;
+}
+
+void Mile::RecordAllocation(
+    std::size_t Site,
+    std::size_t Size) noexcept
+{
+    ::RecordAllocationEvent(Site, Size, true);
+}
+
+void Mile::RecordFree(
+    std::size_t Site,
+    std::size_t Size) noexcept
+{
+    ::RecordAllocationEvent(Site, Size, false);
+}
+
+void Mile::FlushAllocationStatistics() noexcept
+{
+    AllocationThreadCache* Cache = ::GetAllocationThreadCache();
+    if (Cache)
+    {
+        Cache->Flush();
+    }
+}
+
+std::vector<Mile::AllocationSiteStatistics> Mile::GetAllocationStatistics()
+{
+    Mile::FlushAllocationStatistics();
+
+    AllocationSiteRegistry& Registry = ::GetAllocationSiteRegistry();
+
+    std::size_t Count = Registry.Count.load(std::memory_order_acquire);
+
+    std::vector<Mile::AllocationSiteStatistics> Statistics;
+    Statistics.reserve(Count);
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        AllocationSiteCounters& Site = Registry.Sites[i];
+
+        Mile::AllocationSiteStatistics Current;
+        Current.Name = Site.Name;
+        Current.IsHandedOff = Site.HandedOff;
+        Current.AllocationCount = Site.AllocationCount.load(
+            std::memory_order_relaxed);
+        Current.FreeCount = Site.FreeCount.load(
+            std::memory_order_relaxed);
+        Current.AllocatedBytes = Site.AllocatedBytes.load(
+            std::memory_order_relaxed);
+        Current.FreedBytes = Site.FreedBytes.load(
+            std::memory_order_relaxed);
+        Current.LiveBytes = Site.LiveBytes.load(
+            std::memory_order_relaxed);
+        Current.PeakLiveBytes = Site.PeakLiveBytes.load(
+            std::memory_order_relaxed);
+        Statistics.push_back(Current);
+    }
+
+    return Statistics;
+}
+
+std::string Mile::DumpAllocationStatistics()
+{
+    std::vector<Mile::AllocationSiteStatistics> Statistics =
+        Mile::GetAllocationStatistics();
+    std::stable_sort(
+        Statistics.begin(),
+        Statistics.end(),
+        [](
+            Mile::AllocationSiteStatistics const& Left,
+            Mile::AllocationSiteStatistics const& Right)
+        {
+            return Left.AllocatedBytes > Right.AllocatedBytes;
+        });
+
+    std::string Result;
+    char Line[512];
+
+    std::snprintf(
+        Line,
+        sizeof(Line),
+        "%-40s %12s %12s %16s %16s %16s %16s\n",
+        "Site",
+        "Allocations",
+        "Frees",
+        "AllocatedBytes",
+        "FreedBytes",
+        "LiveBytes",
+        "PeakLiveBytes");
+    Result.append(Line);
+
+    for (Mile::AllocationSiteStatistics const& Site : Statistics)
+    {
+        if (Site.IsHandedOff)
+        {
+            // The live bytes are not tracked for the handed off memory.
+            std::snprintf(
+                Line,
+                sizeof(Line),
+                "%-40s %12llu %12s %16llu %16s %16s %16s\n",
+                Site.Name,
+                static_cast<unsigned long long>(Site.AllocationCount),
+                "-",
+                static_cast<unsigned long long>(Site.AllocatedBytes),
+                "-",
+                "-",
+                "-");
+        }
+        else
+        {
+            std::snprintf(
+                Line,
+                sizeof(Line),
+                "%-40s %12llu %12llu %16llu %16llu %16lld %16lld\n",
+                Site.Name,
+                static_cast<unsigned long long>(Site.AllocationCount),
+                static_cast<unsigned long long>(Site.FreeCount),
+                static_cast<unsigned long long>(Site.AllocatedBytes),
+                static_cast<unsigned long long>(Site.FreedBytes),
+                static_cast<long long>(Site.LiveBytes),
+                static_cast<long long>(Site.PeakLiveBytes));
+        }
+        Result.append(Line);
+    }
+
+    return Result;
+}
+
+#endif
+
+#if !defined(_MSC_VER) && defined(__GNUC__)
+#ifdef MILE_ENABLE_LOCK_PROFILING
+const int Mile::LockProfilingEnabledBuild = 1;
+#else
+const int Mile::LockProfilingDisabledBuild = 0;
+#endif
+#endif
+
+#ifdef MILE_ENABLE_LOCK_PROFILING
+
+namespace
+{
+    /**
+     * @brief The maximum number of the named locks.
+    */
+    const std::size_t MaximumLockSiteCount = 256;
+
+    /**
+     * @brief The number of the events of a named lock cached by a thread
+     *        before merging them into the statistics of the lock.
+    */
+    const std::uint32_t LockFlushThreshold = 64;
+
+    /**
+     * @brief The statistics of a named lock shared by all threads.
+    */
+    struct LockSiteCounters
+    {
+        char const* Name = nullptr;
+        std::atomic<std::uint64_t> AcquisitionCount{ 0 };
+        std::atomic<std::uint64_t> ContendedCount{ 0 };
+        std::atomic<std::uint64_t> TotalWaitTime{ 0 };
+        std::atomic<std::uint64_t> MaximumWaitTime{ 0 };
+        std::atomic<std::uint64_t> HoldTimeHistogram[
+            Mile::LockHoldTimeBucketCount] = {};
+    };
+
+    /**
+     * @brief The registry of the named locks, which is never destroyed for
+     *        profiling the locks used in the static destructors.
+    */
+    struct LockSiteRegistry
+    {
+        std::mutex Mutex;
+        std::atomic<std::size_t> Count{ 0 };
+        LockSiteCounters Sites[MaximumLockSiteCount];
+    };
+
+    static LockSiteRegistry& GetLockSiteRegistry()
+    {
+        static LockSiteRegistry* Registry = new LockSiteRegistry();
+        return *Registry;
+    }
+
+    /**
+     * @brief The events of a named lock cached by a thread since the last
+     *        merge.
+    */
+    struct LockThreadCounters
+    {
+        std::uint64_t AcquisitionCount;
+        std::uint64_t ContendedCount;
+        std::uint64_t TotalWaitTime;
+        std::uint64_t MaximumWaitTime;
+        std::uint64_t HoldTimeHistogram[Mile::LockHoldTimeBucketCount];
+        std::uint32_t PendingCount;
+    };
+
+    static void MergeLockThreadCounters(
+        std::size_t Site,
+        LockThreadCounters& Counters) noexcept
+    {
+        LockSiteCounters& Target = ::GetLockSiteRegistry().Sites[Site];
+
+        Target.AcquisitionCount.fetch_add(
+            Counters.AcquisitionCount,
+            std::memory_order_relaxed);
+        Target.ContendedCount.fetch_add(
+            Counters.ContendedCount,
+            std::memory_order_relaxed);
+        Target.TotalWaitTime.fetch_add(
+            Counters.TotalWaitTime,
+            std::memory_order_relaxed);
+        std::uint64_t Current = Target.MaximumWaitTime.load(
+            std::memory_order_relaxed);
+        while (Current < Counters.MaximumWaitTime &&
+            !Target.MaximumWaitTime.compare_exchange_weak(
+                Current,
+                Counters.MaximumWaitTime,
+                std::memory_order_relaxed))
+        {
+        }
+        for (std::size_t i = 0; i < Mile::LockHoldTimeBucketCount; ++i)
+        {
+            if (Counters.HoldTimeHistogram[i])
+            {
+                Target.HoldTimeHistogram[i].fetch_add(
+                    Counters.HoldTimeHistogram[i],
+                    std::memory_order_relaxed);
+            }
+        }
+
+        Counters = LockThreadCounters();
+    }
+
+    /**
+     * @brief The events of all named locks cached by a thread.
+    */
+    struct LockThreadCache
+    {
+        LockThreadCounters Sites[MaximumLockSiteCount] = {};
+
+        void Flush() noexcept
+        {
+            std::size_t Count = ::GetLockSiteRegistry().Count.load(
+                std::memory_order_acquire);
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                if (this->Sites[i].PendingCount)
+                {
+                    ::MergeLockThreadCounters(i, this->Sites[i]);
+                }
+            }
+        }
+
+        ~LockThreadCache();
+    };
+
+    /**
+     * @brief Whether the cache of the current thread is destroyed, the events
+     *        recorded by the destructors of the other thread local objects
+     *        after that are merged directly.
+    */
+    static thread_local bool g_LockThreadCacheDestroyed = false;
+
+    LockThreadCache::~LockThreadCache()
+    {
+        this->Flush();
+        g_LockThreadCacheDestroyed = true;
+    }
+
+    static LockThreadCache* GetLockThreadCache() noexcept
+    {
+        if (g_LockThreadCacheDestroyed)
+        {
+            return nullptr;
+        }
+        static thread_local LockThreadCache Cache;
+        return &Cache;
+    }
+
+    static std::size_t GetLockHoldTimeBucket(
+        std::uint64_t HoldTime) noexcept
+    {
+        std::size_t Bucket = 0;
+        std::uint64_t Bound = 128;
+        while (HoldTime >= Bound &&
+            Bucket < Mile::LockHoldTimeBucketCount - 1)
+        {
+            Bound <<= 1;
+            ++Bucket;
+        }
+        return Bucket;
+    }
+
+    static void RecordLockEvent(
+        std::size_t Site,
+        bool Acquisition,
+        bool Contended,
+        std::uint64_t Time) noexcept
+    {
+        if (Site >= MaximumLockSiteCount)
+        {
+            return;
+        }
+
+        LockThreadCounters Local = {};
+        LockThreadCache* Cache = ::GetLockThreadCache();
+        LockThreadCounters& Counters = Cache ? Cache->Sites[Site] : Local;
+
+        if (Acquisition)
+        {
+            ++Counters.AcquisitionCount;
+            if (Contended)
+            {
+                ++Counters.ContendedCount;
+                Counters.TotalWaitTime += Time;
+                if (Counters.MaximumWaitTime < Time)
+                {
+                    Counters.MaximumWaitTime = Time;
+                }
+            }
+        }
+        else
+        {
+            ++Counters.HoldTimeHistogram[::GetLockHoldTimeBucket(Time)];
+        }
+
+        if (!Cache || ++Counters.PendingCount >= LockFlushThreshold)
+        {
+            ::MergeLockThreadCounters(Site, Counters);
+        }
+    }
+
+    /**
+     * @brief Formats the bucket of the hold time histogram which contains a
+     *        percentile of the hold times.
+     * @param Statistics The statistics of the lock.
+     * @param Percent The percentile.
+     * @param Buffer The buffer of the formatted text.
+    */
+    static void FormatLockHoldTimePercentile(
+        Mile::LockStatistics const& Statistics,
+        std::uint64_t Percent,
+        char (&Buffer)[32]) noexcept
+    {
+        std::uint64_t Total = 0;
+        for (std::size_t i = 0; i < Mile::LockHoldTimeBucketCount; ++i)
+        {
+            Total += Statistics.HoldTimeHistogram[i];
+        }
+        if (!Total)
+        {
+            std::snprintf(Buffer, sizeof(Buffer), "-");
+            return;
+        }
+
+        std::uint64_t Target = (Total * Percent + 99) / 100;
+        std::uint64_t Accumulated = 0;
+        std::size_t Bucket = 0;
+        for (; Bucket < Mile::LockHoldTimeBucketCount - 1; ++Bucket)
+        {
+            Accumulated += Statistics.HoldTimeHistogram[Bucket];
+            if (Accumulated >= Target)
+            {
+                break;
+            }
+        }
+
+        if (Mile::LockHoldTimeBucketCount - 1 == Bucket)
+        {
+            std::snprintf(
+                Buffer,
+                sizeof(Buffer),
+                ">=%llu",
+                64ULL << Bucket);
+        }
+        else
+        {
+            std::snprintf(
+                Buffer,
+                sizeof(Buffer),
+                "<%llu",
+                128ULL << Bucket);
+        }
+    }
+}
+
+std::size_t Mile::RegisterLockSite(
+    char const* Name) noexcept
+{
+    LockSiteRegistry& Registry = ::GetLockSiteRegistry();
+
+    std::lock_guard<std::mutex> Lock(Registry.Mutex);
+
+    std::size_t Count = Registry.Count.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        if (0 == std::strcmp(Registry.Sites[i].Name, Name))
+        {
+            return i;
+        }
+    }
+
+    if (Count >= MaximumLockSiteCount)
+    {
+        return SIZE_MAX;
+    }
+
+    Registry.Sites[Count].Name = Name;
+    Registry.Count.store(Count + 1, std::memory_order_release);
+    return Count;
+}
+
+std::uint64_t Mile::GetLockProfilingTimestamp() noexcept
+{
+    return static_cast<std::uint64_t>(::GetSteadyClockNanoseconds());
+}
+
+void Mile::RecordLockAcquisition(
+    std::size_t Site,
+    bool Contended,
+    std::uint64_t WaitTime) noexcept
+{
+    ::RecordLockEvent(Site, true, Contended, WaitTime);
+}
+
+void Mile::RecordLockRelease(
+    std::size_t Site,
+    std::uint64_t HoldTime) noexcept
+{
+    ::RecordLockEvent(Site, false, false, HoldTime);
+}
+
+void Mile::FlushLockStatistics() noexcept
+{
+    LockThreadCache* Cache = ::GetLockThreadCache();
+    if (Cache)
+    {
+        Cache->Flush();
+    }
+}
+
+std::vector<Mile::LockStatistics> Mile::GetLockStatistics()
+{
+    Mile::FlushLockStatistics();
+
+    LockSiteRegistry& Registry = ::GetLockSiteRegistry();
+
+    std::size_t Count = Registry.Count.load(std::memory_order_acquire);
+
+    std::vector<Mile::LockStatistics> Statistics;
+    Statistics.reserve(Count);
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        LockSiteCounters& Site = Registry.Sites[i];
+
+        Mile::LockStatistics Current;
+        Current.Name = Site.Name;
+        Current.AcquisitionCount = Site.AcquisitionCount.load(
+            std::memory_order_relaxed);
+        Current.ContendedCount = Site.ContendedCount.load(
+            std::memory_order_relaxed);
+        Current.TotalWaitTime = Site.TotalWaitTime.load(
+            std::memory_order_relaxed);
+        Current.MaximumWaitTime = Site.MaximumWaitTime.load(
+            std::memory_order_relaxed);
+        for (std::size_t j = 0; j < Mile::LockHoldTimeBucketCount; ++j)
+        {
+            Current.HoldTimeHistogram[j] = Site.HoldTimeHistogram[j].load(
+                std::memory_order_relaxed);
+        }
+        Statistics.push_back(Current);
+    }
+
+    return Statistics;
+}
+
+std::string Mile::DumpLockStatistics(
+    std::size_t Count)
+{
+    std::vector<Mile::LockStatistics> Statistics = Mile::GetLockStatistics();
+    std::stable_sort(
+        Statistics.begin(),
+        Statistics.end(),
+        [](
+            Mile::LockStatistics const& Left,
+            Mile::LockStatistics const& Right)
+        {
+            if (Left.ContendedCount != Right.ContendedCount)
+            {
+                return Left.ContendedCount > Right.ContendedCount;
+            }
+            return Left.TotalWaitTime > Right.TotalWaitTime;
+        });
+    if (Statistics.size() > Count)
+    {
+        Statistics.resize(Count);
+    }
+
+    std::string Result;
+    char Line[512];
+
+    std::snprintf(
+        Line,
+        sizeof(Line),
+        "%-40s %12s %12s %16s %16s %14s %14s\n",
+        "Lock",
+        "Acquisitions",
+        "Contended",
+        "TotalWait(ns)",
+        "MaximumWait(ns)",
+        "HoldP50(ns)",
+        "HoldP99(ns)");
+    Result.append(Line);
+
+    for (Mile::LockStatistics const& Lock : Statistics)
+    {
+        char HoldTimeP50[32];
+        char HoldTimeP99[32];
+        ::FormatLockHoldTimePercentile(Lock, 50, HoldTimeP50);
+        ::FormatLockHoldTimePercentile(Lock, 99, HoldTimeP99);
+
+        std::snprintf(
+            Line,
+            sizeof(Line),
+            "%-40s %12llu %12llu %16llu %16llu %14s %14s\n",
+            Lock.Name,
+            static_cast<unsigned long long>(Lock.AcquisitionCount),
+            static_cast<unsigned long long>(Lock.ContendedCount),
+            static_cast<unsigned long long>(Lock.TotalWaitTime),
+            static_cast<unsigned long long>(Lock.MaximumWaitTime),
+            HoldTimeP50,
+            HoldTimeP99);
+        Result.append(Line);
+    }
+
+    return Result;
+}
+
+#endif
+
+namespace Mile
+{
+    MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(, char)
+    MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(, wchar_t)
+    MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(, char16_t)
+#if defined(MILE_PORTABLE_ENABLE_CHAR8_T)
+    MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(, char8_t)
+#endif
 }
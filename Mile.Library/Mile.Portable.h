@@ -19,11 +19,50 @@
 
 #include <Mile.Helpers.CppBase.h>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <new>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+/*
+ * MILE_ENABLE_LOCK_PROFILING must be defined for the whole project or for none
+ * of it, including Mile.Portable.cpp and Mile.Windows.cpp. It adds a profiler
+ * member to the lock classes, so the translation units which disagree on it
+ * see different layouts of the same classes. The translation units which
+ * disagree with Mile.Portable.cpp fail to link instead of corrupting the
+ * locks at run time.
+*/
+#if defined(_MSC_VER)
+#ifdef MILE_ENABLE_LOCK_PROFILING
+#pragma detect_mismatch("MILE_ENABLE_LOCK_PROFILING", "1")
+#else
+#pragma detect_mismatch("MILE_ENABLE_LOCK_PROFILING", "0")
+#endif
+#elif defined(__GNUC__)
+namespace Mile
+{
+#ifdef MILE_ENABLE_LOCK_PROFILING
+    extern const int LockProfilingEnabledBuild;
+    __attribute__((used)) static int const* const LockProfilingBuild =
+        &LockProfilingEnabledBuild;
+#else
+    extern const int LockProfilingDisabledBuild;
+    __attribute__((used)) static int const* const LockProfilingBuild =
+        &LockProfilingDisabledBuild;
+#endif
+}
+#endif
+
 namespace Mile
 {
     /**
@@ -194,38 +233,6015 @@ namespace Mile
     };
 
     /**
-     * @brief Parses a command line string and get more friendly result.
-     * @param CommandLine A string that contains the full command line. If this
-     *                    parameter is an empty string the function returns an
-     *                    array with only one empty string.
-     * @param OptionPrefixes One or more of the prefixes of option we want to
-     *                       use.
-     * @param OptionParameterSeparators One or more of the separators of option
-     *                                  we want to use.
-     * @param ApplicationName The application name.
-     * @param OptionsAndParameters The options and parameters.
-     * @param UnresolvedCommandLine The unresolved command line.
+     * @brief The reference counter policy for the shared objects which can be
+     *        shared between threads.
     */
-    void SpiltCommandLineEx(
-        std::wstring const& CommandLine,
-        std::vector<std::wstring> const& OptionPrefixes,
-        std::vector<std::wstring> const& OptionParameterSeparators,
-        std::wstring& ApplicationName,
-        std::map<std::wstring, std::wstring>& OptionsAndParameters,
-        std::wstring& UnresolvedCommandLine);
+    class AtomicReferenceCounter
+    {
+    private:
+
+        /**
+         * @brief The number of the references.
+        */
+        std::atomic<std::size_t> m_Count;
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the reference counter.
+         * @param Count The initial number of the references.
+        */
+        explicit AtomicReferenceCounter(std::size_t Count) noexcept :
+            m_Count(Count)
+        {
+        }
+
+        /**
+         * @brief Adds a reference.
+        */
+        void Increment() noexcept
+        {
+            this->m_Count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Releases a reference.
+         * @return true if the last reference is released, otherwise false.
+        */
+        bool Decrement() noexcept
+        {
+            return 1 == this->m_Count.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        /**
+         * @brief Returns the number of the references.
+         * @return The number of the references.
+        */
+        std::size_t Count() const noexcept
+        {
+            return this->m_Count.load(std::memory_order_relaxed);
+        }
+    };
 
     /**
-     * @brief Parses a command arguments string and returns an array of the
-     *        command arguments, along with a count of such arguments, in a way
-     *        that is similar to the standard C run-time.
-     * @param Arguments A string that contains the full command arguments. If
-     *                  this parameter is an empty string the function returns
-     *                  an array with only one empty string.
-     * @return An array of the command arguments, along with a count of such
-     *         arguments.
+     * @brief The reference counter policy for the shared objects which are
+     *        only used by a single thread.
     */
-    std::vector<std::wstring> SpiltCommandArguments(
-        std::wstring const& Arguments);
+    class NonAtomicReferenceCounter
+    {
+    private:
+
+        /**
+         * @brief The number of the references.
+        */
+        std::size_t m_Count;
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the reference counter.
+         * @param Count The initial number of the references.
+        */
+        explicit NonAtomicReferenceCounter(std::size_t Count) noexcept :
+            m_Count(Count)
+        {
+        }
+
+        /**
+         * @brief Adds a reference.
+        */
+        void Increment() noexcept
+        {
+            ++this->m_Count;
+        }
+
+        /**
+         * @brief Releases a reference.
+         * @return true if the last reference is released, otherwise false.
+        */
+        bool Decrement() noexcept
+        {
+            return 0 == --this->m_Count;
+        }
+
+        /**
+         * @brief Returns the number of the references.
+         * @return The number of the references.
+        */
+        std::size_t Count() const noexcept
+        {
+            return this->m_Count;
+        }
+    };
+
+    /**
+     * @brief The template for defining the shared objects, which are the
+     *        reference counted companions of the unique objects with the same
+     *        traits. The reference counter and the value are stored in a
+     *        single allocation, and the value is closed when the last
+     *        reference is released.
+     * @tparam TraitsType A traits type that specifies the kind of shared
+     *                    object being represented.
+     * @tparam CounterType A reference counter policy type, which can be
+     *                     AtomicReferenceCounter or NonAtomicReferenceCounter.
+    */
+    template <
+        typename TraitsType,
+        typename CounterType = AtomicReferenceCounter>
+    class SharedObject
+    {
+    public:
+
+        /**
+         * @brief The object type alias of the shared object.
+        */
+        using ObjectType = typename TraitsType::Type;
+
+    private:
+
+        /**
+         * @brief The allocation which contains the reference counter and the
+         *        value of the shared object.
+        */
+        struct ControlBlock
+        {
+            CounterType Counter;
+            ObjectType Value;
+
+            explicit ControlBlock(ObjectType const& Object) noexcept :
+                Counter(1),
+                Value(Object)
+            {
+            }
+        };
+
+        /**
+         * @brief The control block of the shared object, or nullptr if the
+         *        shared object is empty.
+        */
+        ControlBlock* m_Block = nullptr;
+
+    public:
+
+        /**
+         * @brief Releases the reference to the underlying shared object, and
+         *        closes it if it is the last reference.
+        */
+        void Close() noexcept
+        {
+            if (this->m_Block)
+            {
+                if (this->m_Block->Counter.Decrement())
+                {
+                    TraitsType::Close(this->m_Block->Value);
+                    delete this->m_Block;
+                }
+                this->m_Block = nullptr;
+            }
+        }
+
+        /**
+         * @brief Returns the underlying shared object value, should you need
+         *        to pass it to a function.
+         * @return The underlying shared object value represented by the shared
+         *         object.
+        */
+        ObjectType Get() const noexcept
+        {
+            return this->m_Block ? this->m_Block->Value : TraitsType::Invalid();
+        }
+
+        /**
+         * @brief Attaches to a shared object value, and takes ownership of it.
+         * @param Value A shared object value to attach to.
+        */
+        void Attach(ObjectType Value)
+        {
+            this->Close();
+
+            if (TraitsType::Invalid() != Value)
+            {
+                try
+                {
+                    this->m_Block = new ControlBlock(Value);
+                }
+                catch (...)
+                {
+                    TraitsType::Close(Value);
+                    throw;
+                }
+            }
+        }
+
+        /**
+         * @brief Returns the number of the shared objects which refer to the
+         *        underlying shared object value.
+         * @return The number of the references, or 0 if the shared object is
+         *         empty.
+        */
+        std::size_t UseCount() const noexcept
+        {
+            return this->m_Block ? this->m_Block->Counter.Count() : 0;
+        }
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the shared object.
+        */
+        SharedObject() noexcept = default;
+
+        /**
+         * @brief Initializes a new instance of the shared object.
+         * @param Value A value that initializes the shared object. The value
+         *              is closed if the allocation fails.
+        */
+        explicit SharedObject(ObjectType Value)
+        {
+            this->Attach(Value);
+        }
+
+        /**
+         * @brief Initializes a new instance of the shared object.
+         * @param Other A unique object with the same traits that initializes
+         *              the shared object.
+        */
+        explicit SharedObject(UniqueObject<TraitsType>&& Other)
+        {
+            this->Attach(Other.Detach());
+        }
+
+        /**
+         * @brief Initializes a new instance of the shared object.
+         * @param Other Another shared object that initializes the shared
+         *              object.
+        */
+        SharedObject(SharedObject const& Other) noexcept :
+            m_Block(Other.m_Block)
+        {
+            if (this->m_Block)
+            {
+                this->m_Block->Counter.Increment();
+            }
+        }
+
+        /**
+         * @brief Initializes a new instance of the shared object.
+         * @param Other Another shared object that initializes the shared
+         *              object.
+        */
+        SharedObject(SharedObject&& Other) noexcept :
+            m_Block(Other.m_Block)
+        {
+            Other.m_Block = nullptr;
+        }
+
+        /**
+         * @brief Assigns a value to the shared object.
+         * @param Other A shared object value to assign to the shared object.
+         * @return A reference to the shared object.
+        */
+        SharedObject& operator=(SharedObject const& Other) noexcept
+        {
+            if (this->m_Block != Other.m_Block)
+            {
+                if (Other.m_Block)
+                {
+                    Other.m_Block->Counter.Increment();
+                }
+                this->Close();
+                this->m_Block = Other.m_Block;
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Assigns a value to the shared object.
+         * @param Other A shared object value to assign to the shared object.
+         * @return A reference to the shared object.
+        */
+        SharedObject& operator=(SharedObject&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                this->Close();
+                this->m_Block = Other.m_Block;
+                Other.m_Block = nullptr;
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Uninitializes the instance of the shared object.
+        */
+        ~SharedObject() noexcept
+        {
+            this->Close();
+        }
+
+        /**
+         * @brief Checks whether or not the shared object currently represents
+         *        a valid shared object value.
+         * @return true if the shared object currently represents a valid
+         *         shared object value, otherwise false.
+        */
+        explicit operator bool() const noexcept
+        {
+            return nullptr != this->m_Block;
+        }
+
+        /**
+         * @brief Swaps the contents of the two shared object parameters so
+         *        that they contain one another's shared object.
+         * @param Left A shared object value whose handle to mutually swap with
+         *             that of the other parameter.
+         * @param Right A shared object value whose handle to mutually swap
+         *              with that of the other parameter.
+        */
+        friend void swap(SharedObject& Left, SharedObject& Right) noexcept
+        {
+            std::swap(Left.m_Block, Right.m_Block);
+        }
+    };
+
+    /**
+     * @brief The type-erased entry of the values which are waiting to be
+     *        closed by the deferred close reaper thread.
+    */
+    struct DeferredCloseEntry
+    {
+        /**
+         * @brief The next entry in the queue.
+        */
+        DeferredCloseEntry* Next = nullptr;
+
+        /**
+         * @brief The routine which closes the value and frees the entry.
+        */
+        void (*CloseRoutine)(DeferredCloseEntry* Entry) = nullptr;
+
+        /**
+         * @brief The time when the entry is posted, in nanoseconds of the
+         *        steady clock.
+        */
+        std::int64_t PostTime = 0;
+    };
+
+    /**
+     * @brief The statistics of the deferred close reaper thread.
+    */
+    struct DeferredCloseStatistics
+    {
+        /**
+         * @brief The number of the values which are posted.
+        */
+        std::uint64_t PostedCount;
+
+        /**
+         * @brief The number of the values which are closed.
+        */
+        std::uint64_t ClosedCount;
+
+        /**
+         * @brief The number of the values which are waiting to be closed.
+        */
+        std::uint64_t PendingCount;
+
+        /**
+         * @brief The number of the batches which are closed.
+        */
+        std::uint64_t BatchCount;
+
+        /**
+         * @brief The total time from posting to finishing closing of all
+         *        closed values, in nanoseconds.
+        */
+        std::uint64_t TotalCloseLatency;
+
+        /**
+         * @brief The maximum time from posting to finishing closing of the
+         *        closed values, in nanoseconds.
+        */
+        std::uint64_t MaximumCloseLatency;
+    };
+
+    /**
+     * @brief Posts an entry to the lock-free queue of the deferred close
+     *        reaper thread, which closes the values in batches. The reaper
+     *        thread is started when the first entry is posted. The entry is
+     *        closed on the calling thread if the reaper thread is not
+     *        available.
+     * @param Entry The entry to post.
+    */
+    void PostDeferredClose(
+        DeferredCloseEntry* Entry) noexcept;
+
+    /**
+     * @brief Waits until all values posted before the call are closed.
+    */
+    void FlushDeferredClose() noexcept;
+
+    /**
+     * @brief Stops the deferred close reaper thread and closes all pending
+     *        values on the calling thread. The values posted after the call
+     *        are closed on the posting threads. This function should be
+     *        called before the process exits if the pending values need to
+     *        be closed.
+    */
+    void DrainDeferredClose() noexcept;
+
+    /**
+     * @brief Retrieves the statistics of the deferred close reaper thread.
+     * @return The statistics of the deferred close reaper thread.
+    */
+    DeferredCloseStatistics GetDeferredCloseStatistics() noexcept;
+
+    /**
+     * @brief The traits wrapper for the unique objects and the shared objects
+     *        which close their values on the deferred close reaper thread
+     *        instead of the thread releasing them.
+     * @tparam TraitsType A traits type that specifies how to close the value
+     *                    on the reaper thread.
+    */
+    template<typename TraitsType>
+    struct DeferredCloseTraits
+    {
+        /**
+         * @brief The object type of the traits.
+        */
+        using Type = typename TraitsType::Type;
+
+    private:
+
+        /**
+         * @brief The entry which carries the value to close.
+        */
+        struct Entry : DeferredCloseEntry
+        {
+            Type Value;
+
+            static void Close(DeferredCloseEntry* Base) noexcept
+            {
+                Entry* Self = static_cast<Entry*>(Base);
+                TraitsType::Close(Self->Value);
+                delete Self;
+            }
+        };
+
+    public:
+
+        /**
+         * @brief Returns the invalid value of the object type.
+         * @return The invalid value of the object type.
+        */
+        static Type Invalid() noexcept
+        {
+            return TraitsType::Invalid();
+        }
+
+        /**
+         * @brief Posts the value to the deferred close reaper thread. The
+         *        value is closed synchronously if the allocation fails.
+         * @param Value The value to close.
+        */
+        static void Close(Type Value) noexcept
+        {
+            Entry* Item = new (std::nothrow) Entry();
+            if (!Item)
+            {
+                TraitsType::Close(Value);
+                return;
+            }
+
+            Item->CloseRoutine = &Entry::Close;
+            Item->Value = Value;
+            PostDeferredClose(Item);
+        }
+    };
+
+    /**
+     * @brief The unique objects which close their values on the deferred
+     *        close reaper thread.
+     * @tparam TraitsType A traits type that specifies the kind of unique
+     *                    object being represented.
+    */
+    template<typename TraitsType>
+    using DeferredCloseObject = UniqueObject<DeferredCloseTraits<TraitsType>>;
+
+    /**
+     * @brief The statistics of the unique object pools.
+    */
+    struct UniqueObjectPoolStatistics
+    {
+        /**
+         * @brief The number of the acquisitions which reuse cached values.
+        */
+        std::uint64_t HitCount;
+
+        /**
+         * @brief The number of the acquisitions which create new values.
+        */
+        std::uint64_t MissCount;
+
+        /**
+         * @brief The number of the released values which are cached.
+        */
+        std::uint64_t RecycledCount;
+
+        /**
+         * @brief The number of the released values which are closed because
+         *        they cannot be reset or the free list is full.
+        */
+        std::uint64_t DiscardedCount;
+    };
+
+    /**
+     * @brief The template for defining the pools which recycle the values of
+     *        the unique objects. The pooled unique objects return their values
+     *        to a bounded free list of the releasing thread instead of closing
+     *        them, and the values are closed when the free list is full or
+     *        the thread exits.
+     * @tparam TraitsType A traits type that specifies the kind of unique
+     *                    object being represented. If the traits type has a
+     *                    static bool Reset(Type) function, it is called before
+     *                    the value is cached, and the value is closed if it
+     *                    returns false.
+     * @tparam Capacity The maximum number of the cached values per thread.
+    */
+    template<typename TraitsType, std::size_t Capacity = 16>
+    class UniqueObjectPool
+    {
+    public:
+
+        /**
+         * @brief The raw value type of the pooled unique objects.
+        */
+        using ValueType = typename TraitsType::Type;
+
+    private:
+
+        template<typename Type, typename = void>
+        struct HasReset : std::false_type
+        {
+        };
+
+        template<typename Type>
+        struct HasReset<Type, decltype(void(
+            Type::Reset(std::declval<typename Type::Type>())))> :
+            std::true_type
+        {
+        };
+
+        static bool Reset(ValueType Value, std::true_type)
+        {
+            return TraitsType::Reset(Value);
+        }
+
+        static bool Reset(ValueType, std::false_type)
+        {
+            return true;
+        }
+
+        /**
+         * @brief The indices of the counters.
+        */
+        enum CounterIndex
+        {
+            HitCounter,
+            MissCounter,
+            RecycledCounter,
+            DiscardedCounter,
+            CounterCount
+        };
+
+        /**
+         * @brief The number of the events counted by a thread before they are
+         *        merged into the counters of all threads.
+        */
+        static const std::size_t CounterFlushThreshold = 64;
+
+        struct Counters
+        {
+            std::atomic<std::uint64_t> Values[CounterCount] = {};
+        };
+
+        static Counters& GetCounters() noexcept
+        {
+            static Counters Instance;
+            return Instance;
+        }
+
+        /**
+         * @brief Whether the free list of the current thread is destroyed,
+         *        the values released by the destructors of the other thread
+         *        local objects after that are closed directly.
+        */
+        static bool& IsFreeListDestroyed() noexcept
+        {
+            static thread_local bool Destroyed = false;
+            return Destroyed;
+        }
+
+        /**
+         * @brief The bounded free list and the pending counts of the current
+         *        thread.
+        */
+        struct FreeList
+        {
+            ValueType Values[Capacity];
+            std::size_t Count = 0;
+            std::uint64_t PendingCounts[CounterCount] = {};
+            std::size_t PendingEventCount = 0;
+
+            void Flush() noexcept
+            {
+                Counters& Instance = GetCounters();
+                for (std::size_t i = 0; i < CounterCount; ++i)
+                {
+                    if (this->PendingCounts[i])
+                    {
+                        Instance.Values[i].fetch_add(
+                            this->PendingCounts[i],
+                            std::memory_order_relaxed);
+                        this->PendingCounts[i] = 0;
+                    }
+                }
+                this->PendingEventCount = 0;
+            }
+
+            ~FreeList()
+            {
+                while (this->Count)
+                {
+                    TraitsType::Close(this->Values[--this->Count]);
+                }
+                this->Flush();
+                IsFreeListDestroyed() = true;
+            }
+        };
+
+        static FreeList* GetFreeList() noexcept
+        {
+            if (IsFreeListDestroyed())
+            {
+                return nullptr;
+            }
+            static thread_local FreeList List;
+            return &List;
+        }
+
+        /**
+         * @brief Counts an event in the pending counts of the current thread,
+         *        or in the counters of all threads if the free list of the
+         *        current thread is destroyed.
+         * @param List The free list of the current thread, can be nullptr.
+         * @param Index The index of the counter.
+        */
+        static void Count(
+            FreeList* List,
+            CounterIndex Index) noexcept
+        {
+            if (!List)
+            {
+                GetCounters().Values[Index].fetch_add(
+                    1,
+                    std::memory_order_relaxed);
+                return;
+            }
+
+            ++List->PendingCounts[Index];
+            if (++List->PendingEventCount >= CounterFlushThreshold)
+            {
+                List->Flush();
+            }
+        }
+
+    public:
+
+        /**
+         * @brief The traits type of the pooled unique objects, which returns
+         *        the values to the pool instead of closing them.
+        */
+        struct PooledTraits
+        {
+            using Type = ValueType;
+
+            static Type Invalid() noexcept
+            {
+                return TraitsType::Invalid();
+            }
+
+            static void Close(Type Value) noexcept
+            {
+                UniqueObjectPool::Release(Value);
+            }
+        };
+
+        /**
+         * @brief The type of the pooled unique objects.
+        */
+        using ObjectType = UniqueObject<PooledTraits>;
+
+        /**
+         * @brief Acquires a value from the free list of the current thread,
+         *        or creates a new one if the free list is empty.
+         * @param Create The function which creates a new value, the returned
+         *               value is owned by the pooled unique object.
+         * @return The pooled unique object.
+        */
+        template<typename CreateFunctionType>
+        static ObjectType Acquire(
+            CreateFunctionType&& Create)
+        {
+            FreeList* List = GetFreeList();
+            if (List && List->Count)
+            {
+                Count(List, HitCounter);
+                return ObjectType(List->Values[--List->Count]);
+            }
+
+            Count(List, MissCounter);
+            return ObjectType(std::forward<CreateFunctionType>(Create)());
+        }
+
+        /**
+         * @brief Resets the value and returns it to the free list of the
+         *        current thread, or closes it if it cannot be reset or the
+         *        free list is full or destroyed.
+         * @param Value The value to release.
+        */
+        static void Release(ValueType Value) noexcept
+        {
+            if (TraitsType::Invalid() == Value)
+            {
+                return;
+            }
+
+            FreeList* List = GetFreeList();
+            if (List &&
+                List->Count < Capacity &&
+                Reset(Value, HasReset<TraitsType>()))
+            {
+                List->Values[List->Count++] = Value;
+                Count(List, RecycledCounter);
+                return;
+            }
+
+            TraitsType::Close(Value);
+            Count(List, DiscardedCounter);
+        }
+
+        /**
+         * @brief Closes all cached values of the current thread.
+        */
+        static void Trim() noexcept
+        {
+            FreeList* List = GetFreeList();
+            if (!List)
+            {
+                return;
+            }
+            while (List->Count)
+            {
+                TraitsType::Close(List->Values[--List->Count]);
+            }
+        }
+
+        /**
+         * @brief Retrieves the statistics of the pool of all threads. The
+         *        counts of the current thread are merged first, and the counts
+         *        of the other threads are merged every 64 events and when the
+         *        threads exit.
+         * @return The statistics of the pool.
+        */
+        static UniqueObjectPoolStatistics GetStatistics() noexcept
+        {
+            FreeList* List = GetFreeList();
+            if (List)
+            {
+                List->Flush();
+            }
+
+            Counters& Instance = GetCounters();
+
+            UniqueObjectPoolStatistics Statistics;
+            Statistics.HitCount = Instance.Values[HitCounter].load(
+                std::memory_order_relaxed);
+            Statistics.MissCount = Instance.Values[MissCounter].load(
+                std::memory_order_relaxed);
+            Statistics.RecycledCount = Instance.Values[RecycledCounter].load(
+                std::memory_order_relaxed);
+            Statistics.DiscardedCount = Instance.Values[DiscardedCounter].load(
+                std::memory_order_relaxed);
+            return Statistics;
+        }
+    };
+
+    /**
+     * @brief Allocates a block of memory from the size-class caches of the
+     *        current thread. The small blocks are rounded up to the size
+     *        classes of power of two, and the freed blocks are kept in the
+     *        bounded free lists of the freeing thread for the next
+     *        allocations of the same size class.
+     * @param Size The number of bytes to be allocated.
+     * @return If the function succeeds, the return value is a pointer to the
+     *         allocated memory block, which is aligned for any fundamental
+     *         type. If the function fails, the return value is nullptr.
+    */
+    void* AllocateCachedMemory(
+        std::size_t Size) noexcept;
+
+    /**
+     * @brief Frees a block of memory allocated by AllocateCachedMemory.
+     * @param Block A pointer to the memory block to be freed, can be nullptr.
+    */
+    void FreeCachedMemory(
+        void* Block) noexcept;
+
+    /**
+     * @brief Frees all cached blocks of the current thread. The cached blocks
+     *        are also freed when the thread exits.
+    */
+    void TrimCachedMemory() noexcept;
+
+    /**
+     * @brief The bump-pointer arena for the short-lived allocations. The
+     *        memory is allocated by moving a pointer in the current chunk, and
+     *        is only freed when the arena is reset or destroyed.
+    */
+    class ScopedArena : DisableCopyConstruction, DisableMoveConstruction
+    {
+    private:
+
+        /**
+         * @brief The header of the chunks allocated by the arena.
+        */
+        struct ChunkHeader
+        {
+            ChunkHeader* Previous;
+            std::size_t Size;
+        };
+
+        /**
+         * @brief The buffer provided by the creator of the arena.
+        */
+        void* m_InitialBuffer = nullptr;
+
+        /**
+         * @brief The size of the buffer provided by the creator of the arena.
+        */
+        std::size_t m_InitialSize = 0;
+
+        /**
+         * @brief The next free byte in the current chunk.
+        */
+        std::uintptr_t m_Current = 0;
+
+        /**
+         * @brief The end of the current chunk.
+        */
+        std::uintptr_t m_End = 0;
+
+        /**
+         * @brief The chunks allocated by the arena, the last one first.
+        */
+        ChunkHeader* m_Chunks = nullptr;
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the arena.
+        */
+        ScopedArena() noexcept = default;
+
+        /**
+         * @brief Initializes a new instance of the arena with the buffer
+         *        provided by the creator, which is used before allocating any
+         *        chunk. It is usually a buffer on the stack.
+         * @param Buffer The buffer provided by the creator, which should
+         *               outlive the arena.
+         * @param Size The size of the buffer in bytes.
+        */
+        ScopedArena(
+            void* Buffer,
+            std::size_t Size) noexcept;
+
+        /**
+         * @brief Uninitializes the instance of the arena, and frees all memory
+         *        allocated by the arena.
+        */
+        ~ScopedArena() noexcept;
+
+        /**
+         * @brief Allocates a block of memory from the arena.
+         * @param Size The number of bytes to be allocated.
+         * @param Alignment The alignment of the block, which should be a power
+         *                  of two.
+         * @return If the function succeeds, the return value is a pointer to
+         *         the allocated memory block. If the function fails, the
+         *         return value is nullptr.
+        */
+        void* Allocate(
+            std::size_t Size,
+            std::size_t Alignment = alignof(std::max_align_t)) noexcept;
+
+        /**
+         * @brief Frees all memory allocated by the arena, the arena can be
+         *        used again after the call.
+        */
+        void Reset() noexcept;
+    };
+
+    /**
+     * @brief The bump-pointer arena with an inline buffer, which is usually
+     *        created on the stack so the small allocations never touch the
+     *        heap.
+     * @tparam InlineSize The size of the inline buffer in bytes.
+    */
+    template<std::size_t InlineSize>
+    class InlineScopedArena : public ScopedArena
+    {
+    private:
+
+        /**
+         * @brief The inline buffer of the arena.
+        */
+        alignas(std::max_align_t) unsigned char m_Buffer[InlineSize];
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the arena.
+        */
+        InlineScopedArena() noexcept :
+            ScopedArena(this->m_Buffer, InlineSize)
+        {
+        }
+    };
+
+    /**
+     * @brief Calls an API which fills a buffer provided by the caller and
+     *        reports the required size when the buffer is too small. The
+     *        buffers are allocated from an arena, and the API is only called
+     *        again when the previous buffer is too small.
+     * @tparam ElementType The element type of the buffer.
+     * @tparam FillType The type of the fill function, which is called as
+     *                  bool Fill(ElementType* Buffer, std::size_t& Size), and
+     *                  Size is the capacity of Buffer in elements on input. If
+     *                  the API succeeds, it should return true and set Size to
+     *                  the number of the valid elements. If the buffer is too
+     *                  small, it should return false and set Size to the
+     *                  required capacity, or a larger guess if the API does
+     *                  not report it. Otherwise, it should return false and
+     *                  leave Size unchanged.
+     * @param Arena The arena which the buffers are allocated from, which
+     *              also owns the returned buffer.
+     * @param InitialCapacity The capacity of the first buffer in elements.
+     * @param Fill The fill function.
+     * @param Length The number of the valid elements in the returned buffer.
+     * @return If the function succeeds, the return value is the buffer filled
+     *         by the API. If the function fails, the return value is nullptr.
+    */
+    template<typename ElementType, typename FillType>
+    ElementType* ProbeAndFill(
+        ScopedArena& Arena,
+        std::size_t InitialCapacity,
+        FillType&& Fill,
+        std::size_t& Length)
+    {
+        // The required size may grow between the calls, but a bounded number
+        // of attempts avoids spinning forever on a misbehaving API.
+        const std::size_t MaximumAttempts = 8;
+
+        std::size_t Capacity = InitialCapacity ? InitialCapacity : 1;
+        for (std::size_t i = 0; i < MaximumAttempts; ++i)
+        {
+            if (Capacity > SIZE_MAX / sizeof(ElementType))
+            {
+                break;
+            }
+
+            ElementType* Buffer = static_cast<ElementType*>(
+                Arena.Allocate(Capacity * sizeof(ElementType)));
+            if (!Buffer)
+            {
+                break;
+            }
+
+            std::size_t Size = Capacity;
+            if (Fill(Buffer, Size))
+            {
+                Length = Size;
+                return Buffer;
+            }
+            if (Size <= Capacity)
+            {
+                break;
+            }
+            Capacity = Size;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Calls an API which fills a buffer provided by the caller and
+     *        reports the required size when the buffer is too small. The API
+     *        is called with an inline buffer on the stack first, so most
+     *        calls need neither a second call nor a heap allocation.
+     * @tparam ElementType The element type of the buffer.
+     * @tparam InlineCapacity The capacity of the inline buffer in elements.
+     * @tparam FillType The type of the fill function, see the overload with
+     *                  the arena for more information.
+     * @tparam ConsumeType The type of the consume function, which is called
+     *                     as bool Consume(ElementType* Buffer,
+     *                     std::size_t Length) with the filled buffer, which
+     *                     is only valid during the call.
+     * @param Fill The fill function.
+     * @param Consume The consume function.
+     * @return true if the API and the consume function succeed, otherwise
+     *         false.
+    */
+    template<
+        typename ElementType,
+        std::size_t InlineCapacity = 260,
+        typename FillType,
+        typename ConsumeType>
+    bool ProbeAndFill(
+        FillType&& Fill,
+        ConsumeType&& Consume)
+    {
+        InlineScopedArena<InlineCapacity * sizeof(ElementType)> Arena;
+
+        std::size_t Length = 0;
+        ElementType* Buffer = Mile::ProbeAndFill<ElementType>(
+            Arena,
+            InlineCapacity,
+            std::forward<FillType>(Fill),
+            Length);
+        return Buffer && Consume(Buffer, Length);
+    }
+
+    /**
+     * @brief Resolves an exported symbol of a module. The module is loaded if
+     *        it is not loaded yet, and is kept loaded for the lifetime of the
+     *        process.
+     * @param ModuleName The name of the module. On Windows, the module is
+     *                   loaded from the System32 directory.
+     * @param ExportName The name of the exported symbol.
+     * @return If the function succeeds, the return value is the address of
+     *         the exported symbol. If the function fails, the return value is
+     *         nullptr.
+    */
+    void* ResolveModuleExport(
+        char const* ModuleName,
+        char const* ExportName) noexcept;
+
+    /**
+     * @brief The optional export of a module which is resolved on the first
+     *        use, and called through the cached function pointer after that.
+     *        The constructor is constexpr, so the function-local static
+     *        instances need no initialization guard.
+     * @tparam Signature The function type of the export, which can have a
+     *                   calling convention like WINAPI.
+    */
+    template<typename Signature>
+    class LazyProc : DisableCopyConstruction, DisableMoveConstruction
+    {
+    public:
+
+        /**
+         * @brief The function pointer type of the export.
+        */
+        using ProcType = Signature*;
+
+    private:
+
+        /**
+         * @brief The value of m_Address when the export is not found.
+        */
+        static const std::uintptr_t NotFound = 1;
+
+        /**
+         * @brief The name of the module.
+        */
+        char const* m_ModuleName;
+
+        /**
+         * @brief The name of the export.
+        */
+        char const* m_ExportName;
+
+        /**
+         * @brief The address of the export, 0 if it is not resolved yet, or
+         *        NotFound if it is not found.
+        */
+        mutable std::atomic<std::uintptr_t> m_Address;
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the lazy export.
+         * @param ModuleName The name of the module, which should be a string
+         *                   literal.
+         * @param ExportName The name of the export, which should be a string
+         *                   literal.
+        */
+        constexpr LazyProc(
+            char const* ModuleName,
+            char const* ExportName) noexcept :
+            m_ModuleName(ModuleName),
+            m_ExportName(ExportName),
+            m_Address(0)
+        {
+        }
+
+        /**
+         * @brief Returns the function pointer of the export, and resolves it
+         *        on the first call. Racing threads may resolve it at the same
+         *        time, which is harmless because the result is the same.
+         * @return The function pointer of the export, or nullptr if it is not
+         *         found.
+        */
+        ProcType Get() const noexcept
+        {
+            std::uintptr_t Address = this->m_Address.load(
+                std::memory_order_acquire);
+            if (!Address)
+            {
+                Address = reinterpret_cast<std::uintptr_t>(
+                    Mile::ResolveModuleExport(
+                        this->m_ModuleName,
+                        this->m_ExportName));
+                if (!Address)
+                {
+                    Address = NotFound;
+                }
+                this->m_Address.store(Address, std::memory_order_release);
+            }
+
+            return NotFound == Address
+                ? nullptr
+                : reinterpret_cast<ProcType>(Address);
+        }
+
+        /**
+         * @brief Checks whether the export is found.
+         * @return true if the export is found, otherwise false.
+        */
+        explicit operator bool() const noexcept
+        {
+            return nullptr != this->Get();
+        }
+
+        /**
+         * @brief Calls the export, which should be found.
+         * @param Arguments The arguments of the export.
+         * @return The return value of the export.
+        */
+        template<typename... ArgumentTypes>
+        decltype(auto) operator()(ArgumentTypes&&... Arguments) const
+        {
+            return this->Get()(std::forward<ArgumentTypes>(Arguments)...);
+        }
+    };
+
+    /**
+     * @brief The snapshot of the capabilities of the platform, which never
+     *        change during the lifetime of the process.
+    */
+    struct PlatformInfo
+    {
+        /**
+         * @brief The major version of the operating system. On Linux, it is
+         *        the major version of the kernel.
+        */
+        std::uint32_t MajorVersion;
+
+        /**
+         * @brief The minor version of the operating system. On Linux, it is
+         *        the minor version of the kernel.
+        */
+        std::uint32_t MinorVersion;
+
+        /**
+         * @brief The build number of the operating system. On Linux, it is
+         *        the patch level of the kernel.
+        */
+        std::uint32_t BuildNumber;
+
+        /**
+         * @brief Whether the processor and the operating system support the
+         *        SSE2 instructions.
+        */
+        bool HasSse2;
+
+        /**
+         * @brief Whether the processor and the operating system support the
+         *        AVX2 instructions.
+        */
+        bool HasAvx2;
+
+        /**
+         * @brief Whether the processor supports the NEON instructions.
+        */
+        bool HasNeon;
+
+        /**
+         * @brief The size of the memory page, in bytes.
+        */
+        std::size_t PageSize;
+
+        /**
+         * @brief The size of the large page, in bytes. It is 0 if the large
+         *        pages are not available. On Linux, it is the size of the
+         *        transparent huge page.
+        */
+        std::size_t LargePageSize;
+
+        /**
+         * @brief The size of the cache line, in bytes.
+        */
+        std::size_t CacheLineSize;
+
+        /**
+         * @brief The number of the logical processors.
+        */
+        std::uint32_t LogicalProcessorCount;
+
+        /**
+         * @brief The number of the physical processor cores.
+        */
+        std::uint32_t ProcessorCoreCount;
+
+        /**
+         * @brief The number of the NUMA nodes.
+        */
+        std::uint32_t NumaNodeCount;
+    };
+
+    /**
+     * @brief Retrieves the snapshot of the capabilities of the platform. The
+     *        snapshot is taken once and cached for the lifetime of the
+     *        process, so the SIMD and allocator code paths can dispatch on it
+     *        without probing again.
+     * @return The snapshot of the capabilities of the platform. The values
+     *         which cannot be retrieved are the conservative defaults.
+    */
+    PlatformInfo const& GetPlatformInfo() noexcept;
+
+#ifdef MILE_ENABLE_LOCK_PROFILING
+
+    // See the top of this file, MILE_ENABLE_LOCK_PROFILING changes the layout
+    // of the lock classes and must be defined for the whole project.
+
+    /**
+     * @brief The number of the buckets of the hold time histogram. The bucket
+     *        0 counts the hold times less than 128 nanoseconds, the bucket i
+     *        counts the hold times in [64 << i, 128 << i) nanoseconds, and the
+     *        last bucket counts all longer hold times.
+    */
+    const std::size_t LockHoldTimeBucketCount = 16;
+
+    /**
+     * @brief The contention statistics of a named lock. The locks with the
+     *        same name share the same statistics.
+    */
+    struct LockStatistics
+    {
+        char const* Name;
+        std::uint64_t AcquisitionCount;
+        std::uint64_t ContendedCount;
+        std::uint64_t TotalWaitTime;
+        std::uint64_t MaximumWaitTime;
+        std::uint64_t HoldTimeHistogram[LockHoldTimeBucketCount];
+    };
+
+    /**
+     * @brief Registers a named lock for the lock profiling.
+     * @param Name The name of the lock, which should be a string literal.
+     * @return The index of the lock. If too many locks are registered, the
+     *         return value is SIZE_MAX and the events of the lock are ignored.
+    */
+    std::size_t RegisterLockSite(
+        char const* Name) noexcept;
+
+    /**
+     * @brief Retrieves the timestamp for measuring the wait and hold times.
+     * @return The timestamp in nanoseconds.
+    */
+    std::uint64_t GetLockProfilingTimestamp() noexcept;
+
+    /**
+     * @brief Records an acquisition of the named lock. The events are counted
+     *        in the cache of the current thread, and are merged into the
+     *        statistics of the lock in batches.
+     * @param Site The index of the lock.
+     * @param Contended Whether the lock was owned by another thread.
+     * @param WaitTime The time waited for the lock in nanoseconds.
+    */
+    void RecordLockAcquisition(
+        std::size_t Site,
+        bool Contended,
+        std::uint64_t WaitTime) noexcept;
+
+    /**
+     * @brief Records a release of the named lock owned in exclusive mode. The
+     *        events are counted in the cache of the current thread, and are
+     *        merged into the statistics of the lock in batches.
+     * @param Site The index of the lock.
+     * @param HoldTime The time the lock was owned in nanoseconds.
+    */
+    void RecordLockRelease(
+        std::size_t Site,
+        std::uint64_t HoldTime) noexcept;
+
+    /**
+     * @brief Merges the events cached by the current thread into the
+     *        statistics of the locks. The events cached by the other threads
+     *        are merged when the threads exit.
+    */
+    void FlushLockStatistics() noexcept;
+
+    /**
+     * @brief Retrieves a snapshot of the statistics of all named locks, after
+     *        merging the events cached by the current thread.
+     * @return The statistics of all named locks in the registration order.
+    */
+    std::vector<LockStatistics> GetLockStatistics();
+
+    /**
+     * @brief Formats a snapshot of the statistics of the most contended named
+     *        locks as a table, sorted by the contended acquisitions and the
+     *        total wait time in descending order.
+     * @param Count The maximum number of the locks in the table.
+     * @return The formatted text, one lock per line.
+    */
+    std::string DumpLockStatistics(
+        std::size_t Count = SIZE_MAX);
+
+    /**
+     * @brief Measures the wait and hold times of a named lock. The hold times
+     *        are only measured for the exclusive mode, and the time of the
+     *        recursive acquisitions is included in the outermost one.
+    */
+    class LockProfiler : DisableCopyConstruction, DisableMoveConstruction
+    {
+    private:
+
+        /**
+         * @brief The index of the lock, or SIZE_MAX if the lock is unnamed.
+        */
+        std::size_t m_Site = SIZE_MAX;
+
+        /**
+         * @brief The timestamp of the outermost exclusive acquisition, which
+         *        is only accessed by the owning thread.
+        */
+        std::uint64_t m_AcquireTime = 0;
+
+        /**
+         * @brief The recursion depth of the exclusive acquisitions, which is
+         *        only accessed by the owning thread.
+        */
+        std::uint32_t m_Depth = 0;
+
+    public:
+
+        /**
+         * @brief Initializes the profiler of an unnamed lock, which records
+         *        nothing.
+        */
+        LockProfiler() noexcept = default;
+
+        /**
+         * @brief Initializes the profiler of a named lock.
+         * @param Name The name of the lock, which should be a string literal.
+        */
+        explicit LockProfiler(
+            char const* Name) noexcept :
+            m_Site(Mile::RegisterLockSite(Name))
+        {
+        }
+
+        /**
+         * @brief Acquires the lock and records the acquisition.
+         * @param TryAcquireRoutine The function which tries to acquire the
+         *                          lock without blocking, and returns whether
+         *                          it succeeds.
+         * @param AcquireRoutine The function which acquires the lock.
+         * @param Exclusive Whether the lock is acquired in exclusive mode.
+        */
+        template<typename TryAcquireRoutineType, typename AcquireRoutineType>
+        void Acquire(
+            TryAcquireRoutineType&& TryAcquireRoutine,
+            AcquireRoutineType&& AcquireRoutine,
+            bool Exclusive) noexcept
+        {
+            if (SIZE_MAX == this->m_Site)
+            {
+                AcquireRoutine();
+                return;
+            }
+
+            std::uint64_t WaitTime = 0;
+            bool Contended = !TryAcquireRoutine();
+            if (Contended)
+            {
+                std::uint64_t Start = Mile::GetLockProfilingTimestamp();
+                AcquireRoutine();
+                WaitTime = Mile::GetLockProfilingTimestamp() - Start;
+            }
+            Mile::RecordLockAcquisition(this->m_Site, Contended, WaitTime);
+            if (Exclusive)
+            {
+                this->OnExclusiveAcquired();
+            }
+        }
+
+        /**
+         * @brief Tries to acquire the lock without blocking and records the
+         *        acquisition if it succeeds.
+         * @param TryAcquireRoutine The function which tries to acquire the
+         *                          lock without blocking, and returns whether
+         *                          it succeeds.
+         * @param Exclusive Whether the lock is acquired in exclusive mode.
+         * @return true if the lock is acquired, otherwise false.
+        */
+        template<typename TryAcquireRoutineType>
+        bool TryAcquire(
+            TryAcquireRoutineType&& TryAcquireRoutine,
+            bool Exclusive) noexcept
+        {
+            if (!TryAcquireRoutine())
+            {
+                return false;
+            }
+            if (SIZE_MAX != this->m_Site)
+            {
+                Mile::RecordLockAcquisition(this->m_Site, false, 0);
+                if (Exclusive)
+                {
+                    this->OnExclusiveAcquired();
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Records the hold time before the lock owned in exclusive mode
+         *        is released.
+        */
+        void OnExclusiveReleasing() noexcept
+        {
+            if (SIZE_MAX != this->m_Site && !--this->m_Depth)
+            {
+                Mile::RecordLockRelease(
+                    this->m_Site,
+                    Mile::GetLockProfilingTimestamp() - this->m_AcquireTime);
+            }
+        }
+
+    private:
+
+        /**
+         * @brief Starts measuring the hold time after the lock is acquired in
+         *        exclusive mode.
+        */
+        void OnExclusiveAcquired() noexcept
+        {
+            if (!this->m_Depth++)
+            {
+                this->m_AcquireTime = Mile::GetLockProfilingTimestamp();
+            }
+        }
+    };
+
+#endif
+
+    /**
+     * @brief The mutual exclusion lock which spins for a learned number of
+     *        times before parking the waiting thread, for the short critical
+     *        sections where parking costs more than the work itself. It is
+     *        not recursive.
+    */
+    class AdaptiveMutex : DisableCopyConstruction, DisableMoveConstruction
+    {
+    public:
+
+        /**
+         * @brief The default maximum number of the spins before parking.
+        */
+        static const std::uint32_t DefaultMaximumSpinCount = 100;
+
+    private:
+
+        /**
+         * @brief The lock state, 0 if unlocked, 1 if locked, and 2 if locked
+         *        and there may be parked threads.
+        */
+        std::atomic<std::uint32_t> m_State;
+
+        /**
+         * @brief The moving average of the number of the spins needed for
+         *        acquiring the lock.
+        */
+        std::atomic<std::uint32_t> m_SpinBudget;
+
+        /**
+         * @brief The maximum number of the spins before parking.
+        */
+        std::atomic<std::uint32_t> m_MaximumSpinCount;
+
+#ifdef MILE_ENABLE_LOCK_PROFILING
+        /**
+         * @brief The profiler of the mutex.
+        */
+        LockProfiler m_Profiler;
+#endif
+
+        /**
+         * @brief Spins and parks until the lock is acquired, after the fast
+         *        path fails.
+        */
+        void LockContended() noexcept;
+
+        /**
+         * @brief Wakes one of the parked threads.
+        */
+        void WakeWaiter() noexcept;
+
+        /**
+         * @brief Acquires the lock without the profiling.
+        */
+        void RawLock() noexcept
+        {
+            std::uint32_t Expected = 0;
+            if (!this->m_State.compare_exchange_strong(
+                Expected,
+                1,
+                std::memory_order_acquire,
+                std::memory_order_relaxed))
+            {
+                this->LockContended();
+            }
+        }
+
+        /**
+         * @brief Attempts to acquire the lock without the profiling.
+         * @return true if the lock is acquired, otherwise false.
+        */
+        bool RawTryLock() noexcept
+        {
+            std::uint32_t Expected = 0;
+            return this->m_State.compare_exchange_strong(
+                Expected,
+                1,
+                std::memory_order_acquire,
+                std::memory_order_relaxed);
+        }
+
+    public:
+
+        /**
+         * @brief Initializes the mutex.
+        */
+        AdaptiveMutex() noexcept :
+            m_State(0),
+            m_SpinBudget(0),
+            m_MaximumSpinCount(DefaultMaximumSpinCount)
+        {
+        }
+
+        /**
+         * @brief Initializes the named mutex, the name is used by the lock
+         *        profiling.
+         * @param Name The name of the mutex, which should be a string literal.
+        */
+        explicit AdaptiveMutex(
+            char const* Name) noexcept :
+            m_State(0),
+            m_SpinBudget(0),
+            m_MaximumSpinCount(DefaultMaximumSpinCount)
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            , m_Profiler(Name)
+#endif
+        {
+#ifndef MILE_ENABLE_LOCK_PROFILING
+            UnreferencedParameter(Name);
+#endif
+        }
+
+        /**
+         * @brief Sets the maximum number of the spins before parking.
+         * @param MaximumSpinCount The maximum number of the spins, 0 disables
+         *                         spinning.
+        */
+        void SetMaximumSpinCount(
+            std::uint32_t MaximumSpinCount) noexcept
+        {
+            this->m_MaximumSpinCount.store(
+                MaximumSpinCount,
+                std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Retrieves the learned number of the spins before parking.
+         * @return The learned number of the spins before parking.
+        */
+        std::uint32_t GetSpinBudget() const noexcept
+        {
+            return this->m_SpinBudget.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Waits for ownership of the mutex. The function returns when
+         *        the calling thread is granted ownership.
+        */
+        void Lock() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return this->RawTryLock(); },
+                [this]() { this->RawLock(); },
+                true);
+#else
+            this->RawLock();
+#endif
+        }
+
+        /**
+         * @brief Attempts to acquire the mutex without blocking.
+         * @return If the mutex is successfully acquired, the return value is
+         *         true. If another thread already owns the mutex, the return
+         *         value is false.
+        */
+        bool TryLock() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return this->RawTryLock(); },
+                true);
+#else
+            return this->RawTryLock();
+#endif
+        }
+
+        /**
+         * @brief Releases ownership of the mutex.
+        */
+        void Unlock() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.OnExclusiveReleasing();
+#endif
+            if (2 == this->m_State.exchange(0, std::memory_order_release))
+            {
+                this->WakeWaiter();
+            }
+        }
+    };
+
+    /**
+     * @brief Provides automatic locking and unlocking of an adaptive mutex.
+    */
+    class AutoAdaptiveMutexLock
+    {
+    private:
+
+        /**
+         * @brief The adaptive mutex object.
+        */
+        AdaptiveMutex& m_Object;
+
+    public:
+
+        /**
+         * @brief Lock the adaptive mutex object.
+         * @param Object The adaptive mutex object.
+        */
+        explicit AutoAdaptiveMutexLock(
+            AdaptiveMutex& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_Object.Lock();
+        }
+
+        /**
+         * @brief Unlock the adaptive mutex object.
+        */
+        ~AutoAdaptiveMutexLock() noexcept
+        {
+            this->m_Object.Unlock();
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to locking and unlocking of an adaptive
+     *        mutex.
+    */
+    class AutoAdaptiveMutexTryLock
+    {
+    private:
+
+        /**
+         * @brief The adaptive mutex object.
+        */
+        AdaptiveMutex& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to lock the adaptive mutex object.
+         * @param Object The adaptive mutex object.
+        */
+        explicit AutoAdaptiveMutexTryLock(
+            AdaptiveMutex& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = this->m_Object.TryLock();
+        }
+
+        /**
+         * @brief Try to unlock the adaptive mutex object.
+        */
+        ~AutoAdaptiveMutexTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                this->m_Object.Unlock();
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief The reader/writer lock for the read-mostly data, which keeps the
+     *        shared owners in the reader slots on separate cache lines. The
+     *        threads are spread over the slots, so the shared acquisitions on
+     *        different processors do not write the same cache line, and the
+     *        exclusive acquisitions pay for scanning all slots instead.
+     *        Waiting writers block the new readers, so the shared mode is not
+     *        recursive when there are writers.
+    */
+    class DistributedSharedLock
+        : DisableCopyConstruction, DisableMoveConstruction
+    {
+    private:
+
+        /**
+         * @brief The writer state, 0 if there is no writer, 1 if a writer
+         *        owns or is acquiring the lock, and 2 if there may be parked
+         *        readers too. It is on its own cache line before the slots.
+        */
+        std::atomic<std::uint32_t>* m_WriterState;
+
+        /**
+         * @brief Whether the writer is parked waiting for a reader slot to be
+         *        empty. It is on the cache line of the writer state.
+        */
+        std::atomic<std::uint32_t>* m_WriterWaiting;
+
+        /**
+         * @brief The first reader slot, each slot counts the shared owners
+         *        of the threads assigned to it.
+        */
+        unsigned char* m_Slots;
+
+        /**
+         * @brief The distance between the reader slots in bytes.
+        */
+        std::size_t m_SlotStride;
+
+        /**
+         * @brief The number of the reader slots minus 1, the number of the
+         *        reader slots is a power of two.
+        */
+        std::size_t m_SlotMask;
+
+        /**
+         * @brief The allocation of the writer state and the reader slots, or
+         *        nullptr if the inline storage is used.
+        */
+        void* m_Allocation;
+
+        /**
+         * @brief The storage of the writer state, the writer waiting flag and
+         *        one reader slot, which is used when the allocation fails.
+        */
+        std::atomic<std::uint32_t> m_InlineStorage[3];
+
+        /**
+         * @brief Serializes the writers.
+        */
+        AdaptiveMutex m_WriterMutex;
+
+#ifdef MILE_ENABLE_LOCK_PROFILING
+        /**
+         * @brief The profiler of the lock.
+        */
+        LockProfiler m_Profiler;
+#endif
+
+        /**
+         * @brief Allocates the writer state and the reader slots.
+        */
+        void Initialize() noexcept;
+
+        /**
+         * @brief Assigns a reader slot index to the calling thread.
+         * @return The reader slot index, which is masked by the callers.
+        */
+        static std::size_t AllocateThreadSlotIndex() noexcept;
+
+        /**
+         * @brief Retrieves the reader slot of the calling thread.
+         * @return The reader slot of the calling thread.
+        */
+        std::atomic<std::uint32_t>* GetCurrentThreadSlot() const noexcept
+        {
+            static thread_local std::size_t Index = AllocateThreadSlotIndex();
+            std::size_t Offset =
+                (Index & this->m_SlotMask) * this->m_SlotStride;
+            return reinterpret_cast<std::atomic<std::uint32_t>*>(
+                this->m_Slots + Offset);
+        }
+
+        /**
+         * @brief Wakes the writer parked on the reader slot.
+         * @param Slot The reader slot which became empty.
+        */
+        void WakeWriter(
+            std::atomic<std::uint32_t>* Slot) noexcept;
+
+        /**
+         * @brief Removes a shared owner from the reader slot, and wakes the
+         *        parked writer if the slot becomes empty.
+         * @param Slot The reader slot of the calling thread.
+        */
+        void ReleaseSlot(
+            std::atomic<std::uint32_t>* Slot) noexcept
+        {
+            // The decrement and the load of the writer waiting flag are
+            // sequentially consistent, so the parked writer either sees the
+            // empty slot or is woken.
+            if (1 == Slot->fetch_sub(1, std::memory_order_seq_cst) &&
+                this->m_WriterWaiting->load(std::memory_order_seq_cst))
+            {
+                this->WakeWriter(Slot);
+            }
+        }
+
+        /**
+         * @brief Withdraws the shared acquisition from the reader slot, and
+         *        waits until there is no writer.
+         * @param Slot The reader slot of the calling thread.
+        */
+        void WaitForWriter(
+            std::atomic<std::uint32_t>* Slot) noexcept;
+
+        /**
+         * @brief Waits until all reader slots are empty, after the writer
+         *        state is set.
+        */
+        void WaitForReaders() noexcept;
+
+        /**
+         * @brief Checks whether all reader slots are empty.
+         * @return true if all reader slots are empty, otherwise false.
+        */
+        bool AreReadersDrained() const noexcept;
+
+        /**
+         * @brief Clears the writer state and wakes the parked readers.
+        */
+        void ReleaseWriterState() noexcept;
+
+        /**
+         * @brief Acquires the lock in exclusive mode without the profiling.
+        */
+        void RawLockExclusive() noexcept
+        {
+            this->m_WriterMutex.Lock();
+            // The store and the loads of the reader slots are sequentially
+            // consistent, pairing with the readers.
+            this->m_WriterState->store(1, std::memory_order_seq_cst);
+            this->WaitForReaders();
+        }
+
+        /**
+         * @brief Attempts to acquire the lock in exclusive mode without the
+         *        profiling.
+         * @return true if the lock is acquired, otherwise false.
+        */
+        bool RawTryLockExclusive() noexcept
+        {
+            if (!this->m_WriterMutex.TryLock())
+            {
+                return false;
+            }
+            this->m_WriterState->store(1, std::memory_order_seq_cst);
+            if (!this->AreReadersDrained())
+            {
+                this->ReleaseWriterState();
+                this->m_WriterMutex.Unlock();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Acquires the lock in shared mode without the profiling.
+        */
+        void RawLockShared() noexcept
+        {
+            std::atomic<std::uint32_t>* Slot = this->GetCurrentThreadSlot();
+            // The increment and the load of the writer state are sequentially
+            // consistent, so a writer either sees the reader or the reader
+            // sees the writer.
+            Slot->fetch_add(1, std::memory_order_seq_cst);
+            if (this->m_WriterState->load(std::memory_order_seq_cst))
+            {
+                this->WaitForWriter(Slot);
+            }
+        }
+
+        /**
+         * @brief Attempts to acquire the lock in shared mode without the
+         *        profiling.
+         * @return true if the lock is acquired, otherwise false.
+        */
+        bool RawTryLockShared() noexcept
+        {
+            std::atomic<std::uint32_t>* Slot = this->GetCurrentThreadSlot();
+            Slot->fetch_add(1, std::memory_order_seq_cst);
+            if (this->m_WriterState->load(std::memory_order_seq_cst))
+            {
+                this->ReleaseSlot(Slot);
+                return false;
+            }
+            return true;
+        }
+
+    public:
+
+        /**
+         * @brief Initializes the lock with one reader slot per logical
+         *        processor, rounded up to a power of two.
+        */
+        DistributedSharedLock() noexcept
+        {
+            this->Initialize();
+        }
+
+        /**
+         * @brief Initializes the named lock, the name is used by the lock
+         *        profiling.
+         * @param Name The name of the lock, which should be a string literal.
+        */
+        explicit DistributedSharedLock(
+            char const* Name) noexcept
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            : m_Profiler(Name)
+#endif
+        {
+#ifndef MILE_ENABLE_LOCK_PROFILING
+            UnreferencedParameter(Name);
+#endif
+            this->Initialize();
+        }
+
+        /**
+         * @brief Frees the writer state and the reader slots.
+        */
+        ~DistributedSharedLock() noexcept;
+
+        /**
+         * @brief Acquires the lock in exclusive mode.
+        */
+        void LockExclusive() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return this->RawTryLockExclusive(); },
+                [this]() { this->RawLockExclusive(); },
+                true);
+#else
+            this->RawLockExclusive();
+#endif
+        }
+
+        /**
+         * @brief Attempts to acquire the lock in exclusive mode without
+         *        blocking.
+         * @return If the lock is successfully acquired, the return value is
+         *         true. If the current thread could not acquire the lock, the
+         *         return value is false.
+        */
+        bool TryLockExclusive() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return this->RawTryLockExclusive(); },
+                true);
+#else
+            return this->RawTryLockExclusive();
+#endif
+        }
+
+        /**
+         * @brief Releases the lock that was acquired in exclusive mode.
+        */
+        void UnlockExclusive() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.OnExclusiveReleasing();
+#endif
+            this->ReleaseWriterState();
+            this->m_WriterMutex.Unlock();
+        }
+
+        /**
+         * @brief Acquires the lock in shared mode.
+        */
+        void LockShared() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return this->RawTryLockShared(); },
+                [this]() { this->RawLockShared(); },
+                false);
+#else
+            this->RawLockShared();
+#endif
+        }
+
+        /**
+         * @brief Attempts to acquire the lock in shared mode without blocking.
+         * @return If the lock is successfully acquired, the return value is
+         *         true. If the current thread could not acquire the lock, the
+         *         return value is false.
+        */
+        bool TryLockShared() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return this->RawTryLockShared(); },
+                false);
+#else
+            return this->RawTryLockShared();
+#endif
+        }
+
+        /**
+         * @brief Releases the lock that was acquired in shared mode. It must
+         *        be called on the thread which acquired the lock.
+        */
+        void UnlockShared() noexcept
+        {
+            this->ReleaseSlot(this->GetCurrentThreadSlot());
+        }
+    };
+
+    /**
+     * @brief Provides automatic exclusive locking and unlocking of a
+     *        distributed shared lock.
+    */
+    class AutoDistributedExclusiveLock
+    {
+    private:
+
+        /**
+         * @brief The distributed shared lock object.
+        */
+        DistributedSharedLock& m_Object;
+
+    public:
+
+        /**
+         * @brief Exclusive lock the distributed shared lock object.
+         * @param Object The distributed shared lock object.
+        */
+        explicit AutoDistributedExclusiveLock(
+            DistributedSharedLock& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_Object.LockExclusive();
+        }
+
+        /**
+         * @brief Exclusive unlock the distributed shared lock object.
+        */
+        ~AutoDistributedExclusiveLock() noexcept
+        {
+            this->m_Object.UnlockExclusive();
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to exclusive locking and unlocking of a
+     *        distributed shared lock.
+    */
+    class AutoDistributedExclusiveTryLock
+    {
+    private:
+
+        /**
+         * @brief The distributed shared lock object.
+        */
+        DistributedSharedLock& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to exclusive lock the distributed shared lock object.
+         * @param Object The distributed shared lock object.
+        */
+        explicit AutoDistributedExclusiveTryLock(
+            DistributedSharedLock& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = this->m_Object.TryLockExclusive();
+        }
+
+        /**
+         * @brief Try to exclusive unlock the distributed shared lock object.
+        */
+        ~AutoDistributedExclusiveTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                this->m_Object.UnlockExclusive();
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief Provides automatic shared locking and unlocking of a
+     *        distributed shared lock.
+    */
+    class AutoDistributedSharedLock
+    {
+    private:
+
+        /**
+         * @brief The distributed shared lock object.
+        */
+        DistributedSharedLock& m_Object;
+
+    public:
+
+        /**
+         * @brief Shared lock the distributed shared lock object.
+         * @param Object The distributed shared lock object.
+        */
+        explicit AutoDistributedSharedLock(
+            DistributedSharedLock& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_Object.LockShared();
+        }
+
+        /**
+         * @brief Shared unlock the distributed shared lock object.
+        */
+        ~AutoDistributedSharedLock() noexcept
+        {
+            this->m_Object.UnlockShared();
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to shared locking and unlocking of a
+     *        distributed shared lock.
+    */
+    class AutoDistributedSharedTryLock
+    {
+    private:
+
+        /**
+         * @brief The distributed shared lock object.
+        */
+        DistributedSharedLock& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to shared lock the distributed shared lock object.
+         * @param Object The distributed shared lock object.
+        */
+        explicit AutoDistributedSharedTryLock(
+            DistributedSharedLock& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = this->m_Object.TryLockShared();
+        }
+
+        /**
+         * @brief Try to shared unlock the distributed shared lock object.
+        */
+        ~AutoDistributedSharedTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                this->m_Object.UnlockShared();
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief The sequence lock for the small trivially copyable state which is
+     *        read far more often than written. The readers take consistent
+     *        snapshots without writing the shared memory, and retry when a
+     *        writer changed the state meanwhile. The writers are serialized
+     *        by the sequence counter, which is odd while a writer is active.
+     * @tparam Type The type of the state, which must be trivially copyable.
+    */
+    template<typename Type>
+    class SeqLock : DisableCopyConstruction, DisableMoveConstruction
+    {
+        static_assert(
+            std::is_trivially_copyable<Type>::value,
+            "The type of the state must be trivially copyable.");
+
+    private:
+
+        /**
+         * @brief The number of the words for storing the state.
+        */
+        static const std::size_t WordCount =
+            (sizeof(Type) + sizeof(std::size_t) - 1) / sizeof(std::size_t);
+
+        /**
+         * @brief The sequence counter, which is odd while a writer is active.
+        */
+        std::atomic<std::uint32_t> m_Sequence;
+
+        /**
+         * @brief The state, which is stored in the atomic words so the
+         *        readers racing with a writer do not cause data races.
+        */
+        std::atomic<std::size_t> m_Words[WordCount];
+
+        /**
+         * @brief Copies the state from the words.
+         * @return The state.
+        */
+        Type ReadWords() const noexcept
+        {
+            std::size_t Words[WordCount];
+            for (std::size_t i = 0; i < WordCount; ++i)
+            {
+                Words[i] = this->m_Words[i].load(std::memory_order_relaxed);
+            }
+            Type Value;
+            std::memcpy(&Value, Words, sizeof(Type));
+            return Value;
+        }
+
+        /**
+         * @brief Copies the state to the words.
+         * @param Value The state.
+        */
+        void WriteWords(
+            Type const& Value) noexcept
+        {
+            std::size_t Words[WordCount] = {};
+            std::memcpy(Words, &Value, sizeof(Type));
+            for (std::size_t i = 0; i < WordCount; ++i)
+            {
+                this->m_Words[i].store(Words[i], std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Waits until there is no active writer, and makes the calling
+         *        thread the writer.
+         * @return The odd sequence value of the calling writer.
+        */
+        std::uint32_t BeginWrite() noexcept
+        {
+            std::uint32_t Sequence = this->m_Sequence.load(
+                std::memory_order_relaxed);
+            for (;;)
+            {
+                if (Sequence & 1)
+                {
+                    std::this_thread::yield();
+                    Sequence = this->m_Sequence.load(
+                        std::memory_order_relaxed);
+                }
+                else if (this->m_Sequence.compare_exchange_weak(
+                    Sequence,
+                    Sequence + 1,
+                    std::memory_order_acquire,
+                    std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            // Keep the stores of the words after the odd sequence value.
+            std::atomic_thread_fence(std::memory_order_release);
+            return Sequence + 1;
+        }
+
+        /**
+         * @brief Publishes the state written by the calling writer.
+         * @param Sequence The odd sequence value of the calling writer.
+        */
+        void EndWrite(
+            std::uint32_t Sequence) noexcept
+        {
+            this->m_Sequence.store(Sequence + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Ends the write of the calling writer when leaving the scope,
+         *        even if the routine of Update throws.
+        */
+        class WriteScope
+        {
+        private:
+
+            SeqLock& m_Object;
+            std::uint32_t m_Sequence;
+
+        public:
+
+            explicit WriteScope(
+                SeqLock& Object) noexcept :
+                m_Object(Object),
+                m_Sequence(Object.BeginWrite())
+            {
+            }
+
+            ~WriteScope() noexcept
+            {
+                this->m_Object.EndWrite(this->m_Sequence);
+            }
+
+            WriteScope(WriteScope const&) = delete;
+            WriteScope& operator=(WriteScope const&) = delete;
+        };
+
+    public:
+
+        /**
+         * @brief Initializes the sequence lock.
+         * @param Value The initial state.
+        */
+        explicit SeqLock(
+            Type const& Value = Type()) noexcept :
+            m_Sequence(0)
+        {
+            this->WriteWords(Value);
+        }
+
+        /**
+         * @brief Takes a consistent snapshot of the state.
+         * @return The snapshot of the state.
+        */
+        Type Load() const noexcept
+        {
+            for (;;)
+            {
+                std::uint32_t Sequence = this->m_Sequence.load(
+                    std::memory_order_acquire);
+                if (Sequence & 1)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                Type Value = this->ReadWords();
+                // Keep the loads of the words before checking the sequence
+                // value again.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (Sequence == this->m_Sequence.load(
+                    std::memory_order_relaxed))
+                {
+                    return Value;
+                }
+            }
+        }
+
+        /**
+         * @brief Replaces the state.
+         * @param Value The new state.
+        */
+        void Store(
+            Type const& Value) noexcept
+        {
+            std::uint32_t Sequence = this->BeginWrite();
+            this->WriteWords(Value);
+            this->EndWrite(Sequence);
+        }
+
+        /**
+         * @brief Modifies the state in place. The routine runs while the
+         *        calling thread is the writer, so it should be short. If the
+         *        routine throws, the state is left unchanged and the write
+         *        still ends.
+         * @param Routine The routine which receives a reference of the state.
+        */
+        template<typename RoutineType>
+        void Update(
+            RoutineType&& Routine)
+        {
+            WriteScope Scope(*this);
+            Type Value = this->ReadWords();
+            Routine(Value);
+            this->WriteWords(Value);
+        }
+    };
+
+#ifndef _WIN32
+
+    /**
+     * @brief Reads the target of a symbolic link.
+     * @param Path The path of the symbolic link.
+     * @return The target of the symbolic link. If the function fails, the
+     *         return value is an empty string.
+     * @remark For more information, see readlink.
+    */
+    std::string ReadSymbolicLink(
+        std::string const& Path);
+
+    /**
+     * @brief Retrieves the current working directory of the process.
+     * @return The current working directory. If the function fails, the
+     *         return value is an empty string.
+     * @remark For more information, see getcwd.
+    */
+    std::string GetCurrentWorkingDirectory();
+
+    /**
+     * @brief Retrieves the value of a string-valued configuration variable.
+     * @param Name The configuration variable, such as _CS_PATH.
+     * @return The value of the configuration variable. If the function fails
+     *         or the variable has no value, the return value is an empty
+     *         string.
+     * @remark For more information, see confstr.
+    */
+    std::string GetConfigurationString(
+        int Name);
+
+    /**
+     * @brief Retrieves the path of the executable file of the current process
+     *        from /proc/self/exe. The path is retrieved once and cached for
+     *        the lifetime of the process.
+     * @return The path of the executable file of the current process if
+     *         successful, an empty string otherwise.
+    */
+    std::string const& GetCurrentProcessModulePath();
+
+    /**
+     * @brief Retrieves the canonical paths of the standard system directories
+     *        for the executable files, which are the directories in the
+     *        _CS_PATH configuration variable resolved by realpath without
+     *        duplicates. The paths are retrieved once and cached for the
+     *        lifetime of the process.
+     * @return The canonical paths of the standard system directories for the
+     *         executable files.
+    */
+    std::vector<std::string> const& GetSystemExecutableDirectories();
+
+    /**
+     * @brief The raw critical section object, which is a recursive mutex
+     *        backed by a futex. A zero-initialized object is unlocked.
+    */
+    struct RawCriticalSection
+    {
+        /**
+         * @brief The lock state, 0 if unlocked, 1 if locked, and 2 if locked
+         *        and there may be waiting threads.
+        */
+        std::atomic<std::uint32_t> State;
+
+        /**
+         * @brief The identity of the owning thread, 0 if unowned.
+        */
+        std::atomic<std::uintptr_t> OwningThread;
+
+        /**
+         * @brief The number of times the owning thread has entered.
+        */
+        std::uint32_t RecursionCount;
+    };
+
+    /**
+     * @brief Wraps a critical section object.
+    */
+    class CriticalSection : DisableCopyConstruction, DisableMoveConstruction
+    {
+    private:
+
+        /**
+         * @brief Retrieves the identity of the calling thread, which is the
+         *        address of a thread local variable and is never 0.
+         * @return The identity of the calling thread.
+        */
+        static std::uintptr_t GetCurrentThreadIdentity() noexcept
+        {
+            static thread_local char Identity;
+            return reinterpret_cast<std::uintptr_t>(&Identity);
+        }
+
+        /**
+         * @brief Waits until the lock state is acquired, after the fast path
+         *        fails.
+         * @param lpCriticalSection A pointer to the critical section object.
+        */
+        static void EnterContended(
+            RawCriticalSection* lpCriticalSection) noexcept;
+
+        /**
+         * @brief Wakes one of the threads waiting for the lock state.
+         * @param lpCriticalSection A pointer to the critical section object.
+        */
+        static void WakeWaiter(
+            RawCriticalSection* lpCriticalSection) noexcept;
+
+    public:
+
+        /**
+         * @brief The raw object type which is used by the static functions.
+        */
+        using RawObjectType = RawCriticalSection;
+
+        /**
+         * @brief Initializes a critical section object.
+         * @param lpCriticalSection A pointer to the critical section object.
+         */
+        static void Initialize(
+            RawCriticalSection* lpCriticalSection) noexcept
+        {
+            lpCriticalSection->State.store(0, std::memory_order_relaxed);
+            lpCriticalSection->OwningThread.store(
+                0,
+                std::memory_order_relaxed);
+            lpCriticalSection->RecursionCount = 0;
+        }
+
+        /**
+         * @brief Releases all resources used by an unowned critical section
+         *        object.
+         * @param lpCriticalSection A pointer to the critical section object.
+         */
+        static void Delete(
+            RawCriticalSection* lpCriticalSection) noexcept
+        {
+            // The futex needs no resources.
+            UnreferencedParameter(lpCriticalSection);
+        }
+
+        /**
+         * @brief Waits for ownership of the specified critical section object.
+         *        The function returns when the calling thread is granted
+         *        ownership.
+         * @param lpCriticalSection A pointer to the critical section object.
+         */
+        static void Enter(
+            RawCriticalSection* lpCriticalSection) noexcept
+        {
+            std::uintptr_t CurrentThread = GetCurrentThreadIdentity();
+            if (CurrentThread == lpCriticalSection->OwningThread.load(
+                std::memory_order_relaxed))
+            {
+                ++lpCriticalSection->RecursionCount;
+                return;
+            }
+
+            std::uint32_t Expected = 0;
+            if (!lpCriticalSection->State.compare_exchange_strong(
+                Expected,
+                1,
+                std::memory_order_acquire,
+                std::memory_order_relaxed))
+            {
+                EnterContended(lpCriticalSection);
+            }
+
+            lpCriticalSection->OwningThread.store(
+                CurrentThread,
+                std::memory_order_relaxed);
+            lpCriticalSection->RecursionCount = 1;
+        }
+
+        /**
+         * @brief Attempts to enter a critical section without blocking. If the
+         *        call is successful, the calling thread takes ownership of the
+         *        critical section.
+         * @param lpCriticalSection A pointer to the critical section object.
+         * @return If the critical section is successfully entered or the
+         *         current thread already owns the critical section, the return
+         *         value is true. If another thread already owns the critical
+         *         section, the return value is false.
+         */
+        static bool TryEnter(
+            RawCriticalSection* lpCriticalSection) noexcept
+        {
+            std::uintptr_t CurrentThread = GetCurrentThreadIdentity();
+            if (CurrentThread == lpCriticalSection->OwningThread.load(
+                std::memory_order_relaxed))
+            {
+                ++lpCriticalSection->RecursionCount;
+                return true;
+            }
+
+            std::uint32_t Expected = 0;
+            if (!lpCriticalSection->State.compare_exchange_strong(
+                Expected,
+                1,
+                std::memory_order_acquire,
+                std::memory_order_relaxed))
+            {
+                return false;
+            }
+
+            lpCriticalSection->OwningThread.store(
+                CurrentThread,
+                std::memory_order_relaxed);
+            lpCriticalSection->RecursionCount = 1;
+            return true;
+        }
+
+        /**
+         * @brief Releases ownership of the specified critical section object.
+         * @param lpCriticalSection A pointer to the critical section object.
+         */
+        static void Leave(
+            RawCriticalSection* lpCriticalSection) noexcept
+        {
+            if (--lpCriticalSection->RecursionCount)
+            {
+                return;
+            }
+
+            lpCriticalSection->OwningThread.store(0, std::memory_order_relaxed);
+            if (2 == lpCriticalSection->State.exchange(
+                0,
+                std::memory_order_release))
+            {
+                WakeWaiter(lpCriticalSection);
+            }
+        }
+
+    private:
+
+        /**
+         * @brief The raw critical section object.
+        */
+        RawCriticalSection m_RawObject;
+
+#ifdef MILE_ENABLE_LOCK_PROFILING
+        /**
+         * @brief The profiler of the critical section object.
+        */
+        LockProfiler m_Profiler;
+#endif
+
+    public:
+
+        /**
+         * @brief Initializes the critical section object.
+        */
+        CriticalSection() noexcept
+        {
+            Initialize(&this->m_RawObject);
+        }
+
+        /**
+         * @brief Initializes the named critical section object, the name is
+         *        used by the lock profiling.
+         * @param Name The name of the critical section object, which should be
+         *             a string literal.
+        */
+        explicit CriticalSection(
+            char const* Name) noexcept
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            : m_Profiler(Name)
+#endif
+        {
+#ifndef MILE_ENABLE_LOCK_PROFILING
+            UnreferencedParameter(Name);
+#endif
+            Initialize(&this->m_RawObject);
+        }
+
+        /**
+         * @brief Releases all resources used by the critical section object.
+        */
+        ~CriticalSection() noexcept
+        {
+            Delete(&this->m_RawObject);
+        }
+
+        /**
+         * @brief Waits for ownership of the critical section object. The
+         *        function returns when the calling thread is granted ownership.
+        */
+        void Lock() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return TryEnter(&this->m_RawObject); },
+                [this]() { Enter(&this->m_RawObject); },
+                true);
+#else
+            Enter(&this->m_RawObject);
+#endif
+        }
+
+        /**
+         * @brief Attempts to enter the critical section without blocking. If
+         *        the call is successful, the calling thread takes ownership of
+         *        the critical section.
+         * @return If the critical section is successfully entered or the
+         *         current thread already owns the critical section, the return
+         *         value is true. If another thread already owns the critical
+         *         section, the return value is false.
+        */
+        bool TryLock() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return TryEnter(&this->m_RawObject); },
+                true);
+#else
+            return TryEnter(&this->m_RawObject);
+#endif
+        }
+
+        /**
+         * @brief Releases ownership of the critical section object.
+        */
+        void Unlock() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.OnExclusiveReleasing();
+#endif
+            Leave(&this->m_RawObject);
+        }
+    };
+
+    /**
+     * @brief The raw slim reader/writer (SRW) lock object, which is a single
+     *        word backed by a futex. A zero-initialized object is unlocked.
+     * @remark The low 30 bits are the number of the shared owners, or all
+     *         ones if the lock is owned in exclusive mode. The high 2 bits
+     *         mark the waiting readers and writers, and are only set when the
+     *         lock is owned. Waiting writers block the new readers.
+    */
+    struct RawSRWLock
+    {
+        /**
+         * @brief The lock state.
+        */
+        std::atomic<std::uint32_t> State;
+    };
+
+    /**
+     * @brief Wraps a slim reader/writer (SRW) lock.
+    */
+    class SRWLock : DisableCopyConstruction, DisableMoveConstruction
+    {
+    private:
+
+        /**
+         * @brief The bits of the lock state, see RawSRWLock.
+        */
+        static const std::uint32_t OwnerMask = 0x3FFFFFFF;
+        static const std::uint32_t ExclusiveOwned = OwnerMask;
+        static const std::uint32_t ReadersWaiting = 0x40000000;
+        static const std::uint32_t WritersWaiting = 0x80000000;
+        static const std::uint32_t WaitingMask =
+            ReadersWaiting | WritersWaiting;
+
+        /**
+         * @brief Checks whether a new shared owner can acquire the lock.
+         * @param State The lock state.
+         * @return true if a new shared owner can acquire the lock, otherwise
+         *         false.
+        */
+        static bool IsSharedAcquirable(
+            std::uint32_t State) noexcept
+        {
+            return !(State & WritersWaiting) &&
+                (State & OwnerMask) < ExclusiveOwned - 1;
+        }
+
+        /**
+         * @brief Waits until the lock is acquired in exclusive mode, after the
+         *        fast path fails.
+         * @param SRWLock A pointer to the SRW lock.
+        */
+        static void AcquireExclusiveContended(
+            RawSRWLock* SRWLock) noexcept;
+
+        /**
+         * @brief Waits until the lock is acquired in shared mode, after the
+         *        fast path fails.
+         * @param SRWLock A pointer to the SRW lock.
+        */
+        static void AcquireSharedContended(
+            RawSRWLock* SRWLock) noexcept;
+
+        /**
+         * @brief Wakes all waiting threads after the waiting bits are cleared,
+         *        and they check the lock state again.
+         * @param SRWLock A pointer to the SRW lock.
+        */
+        static void WakeWaiters(
+            RawSRWLock* SRWLock) noexcept;
+
+    public:
+
+        /**
+         * @brief The raw object type which is used by the static functions.
+        */
+        using RawObjectType = RawSRWLock;
+
+        /**
+         * @brief Initialize a slim reader/writer (SRW) lock.
+         * @param SRWLock A pointer to the SRW lock.
+         */
+        static void Initialize(
+            RawSRWLock* SRWLock) noexcept
+        {
+            SRWLock->State.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Acquires a slim reader/writer (SRW) lock in exclusive mode.
+         * @param SRWLock A pointer to the SRW lock.
+         */
+        static void AcquireExclusive(
+            RawSRWLock* SRWLock) noexcept
+        {
+            if (!TryAcquireExclusive(SRWLock))
+            {
+                AcquireExclusiveContended(SRWLock);
+            }
+        }
+
+        /**
+         * @brief Attempts to acquire a slim reader/writer (SRW) lock in
+         *        exclusive mode. If the call is successful, the calling thread
+         *        takes ownership of the lock.
+         * @param SRWLock A pointer to the SRW lock.
+         * @return If the lock is successfully acquired, the return value is
+         *         true. If the current thread could not acquire the lock, the
+         *         return value is false.
+         */
+        static bool TryAcquireExclusive(
+            RawSRWLock* SRWLock) noexcept
+        {
+            std::uint32_t State = SRWLock->State.load(
+                std::memory_order_relaxed);
+            while (!(State & OwnerMask))
+            {
+                if (SRWLock->State.compare_exchange_weak(
+                    State,
+                    State | ExclusiveOwned,
+                    std::memory_order_acquire,
+                    std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Releases a slim reader/writer (SRW) lock that was acquired in
+         *        exclusive mode.
+         *
+         * @param SRWLock A pointer to the SRW lock.
+         */
+        static void ReleaseExclusive(
+            RawSRWLock* SRWLock) noexcept
+        {
+            // Only the waiting bits can change while the lock is owned in
+            // exclusive mode.
+            if (SRWLock->State.exchange(0, std::memory_order_release) &
+                WaitingMask)
+            {
+                WakeWaiters(SRWLock);
+            }
+        }
+
+        /**
+         * @brief Acquires a slim reader/writer (SRW) lock in shared mode.
+         * @param SRWLock A pointer to the SRW lock.
+         */
+        static void AcquireShared(
+            RawSRWLock* SRWLock) noexcept
+        {
+            if (!TryAcquireShared(SRWLock))
+            {
+                AcquireSharedContended(SRWLock);
+            }
+        }
+
+        /**
+         * @brief Attempts to acquire a slim reader/writer (SRW) lock in shared
+         *        mode. If the call is successful, the calling thread takes
+         *        ownership of the lock.
+         * @param SRWLock A pointer to the SRW lock.
+         * @return If the lock is successfully acquired, the return value is
+         *         true. If the current thread could not acquire the lock, the
+         *         return value is false.
+         */
+        static bool TryAcquireShared(
+            RawSRWLock* SRWLock) noexcept
+        {
+            std::uint32_t State = SRWLock->State.load(
+                std::memory_order_relaxed);
+            while (IsSharedAcquirable(State))
+            {
+                if (SRWLock->State.compare_exchange_weak(
+                    State,
+                    State + 1,
+                    std::memory_order_acquire,
+                    std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Releases a slim reader/writer (SRW) lock that was acquired in
+         *        shared mode.
+         * @param SRWLock A pointer to the SRW lock.
+         */
+        static void ReleaseShared(
+            RawSRWLock* SRWLock) noexcept
+        {
+            std::uint32_t State = SRWLock->State.fetch_sub(
+                1,
+                std::memory_order_release) - 1;
+            if (!(State & OwnerMask) && (State & WaitingMask))
+            {
+                // The lock may be acquired again before the waiting bits are
+                // cleared, which only causes the waiting threads to wait again.
+                if (SRWLock->State.fetch_and(
+                    ~WaitingMask,
+                    std::memory_order_relaxed) & WaitingMask)
+                {
+                    WakeWaiters(SRWLock);
+                }
+            }
+        }
+
+    private:
+
+        /**
+         * @brief The raw slim reader/writer (SRW) lock object.
+        */
+        RawSRWLock m_RawObject;
+
+#ifdef MILE_ENABLE_LOCK_PROFILING
+        /**
+         * @brief The profiler of the slim reader/writer (SRW) lock.
+        */
+        LockProfiler m_Profiler;
+#endif
+
+    public:
+
+        /**
+         * @brief Initialize the slim reader/writer (SRW) lock.
+        */
+        SRWLock() noexcept
+        {
+            Initialize(&this->m_RawObject);
+        }
+
+        /**
+         * @brief Initialize the named slim reader/writer (SRW) lock, the name
+         *        is used by the lock profiling.
+         * @param Name The name of the slim reader/writer (SRW) lock, which
+         *             should be a string literal.
+        */
+        explicit SRWLock(
+            char const* Name) noexcept
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            : m_Profiler(Name)
+#endif
+        {
+#ifndef MILE_ENABLE_LOCK_PROFILING
+            UnreferencedParameter(Name);
+#endif
+            Initialize(&this->m_RawObject);
+        }
+
+        /**
+         * @brief Acquires the slim reader/writer (SRW) lock in exclusive mode.
+        */
+        void LockExclusive() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return TryAcquireExclusive(&this->m_RawObject); },
+                [this]() { AcquireExclusive(&this->m_RawObject); },
+                true);
+#else
+            AcquireExclusive(&this->m_RawObject);
+#endif
+        }
+
+        /**
+         * @brief Attempts to acquire the slim reader/writer (SRW) lock in
+         *        exclusive mode. If the call is successful, the calling thread
+         *        takes ownership of the lock.
+         * @return If the lock is successfully acquired, the return value is
+         *         true. If the current thread could not acquire the lock, the
+         *         return value is false.
+        */
+        bool TryLockExclusive() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return TryAcquireExclusive(&this->m_RawObject); },
+                true);
+#else
+            return TryAcquireExclusive(&this->m_RawObject);
+#endif
+        }
+
+        /**
+         * @brief Releases the slim reader/writer (SRW) lock that was acquired
+         *        in exclusive mode.
+        */
+        void UnlockExclusive() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.OnExclusiveReleasing();
+#endif
+            ReleaseExclusive(&this->m_RawObject);
+        }
+
+        /**
+         * @brief Acquires the slim reader/writer (SRW) lock in shared mode.
+        */
+        void LockShared() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return TryAcquireShared(&this->m_RawObject); },
+                [this]() { AcquireShared(&this->m_RawObject); },
+                false);
+#else
+            AcquireShared(&this->m_RawObject);
+#endif
+        }
+
+        /**
+         * @brief Attempts to acquire the slim reader/writer (SRW) lock in
+         *        shared mode. If the call is successful, the calling thread
+         *        takes ownership of the lock.
+         * @return If the lock is successfully acquired, the return value is
+         *         true. If the current thread could not acquire the lock, the
+         *         return value is false.
+        */
+        bool TryLockShared() noexcept
+        {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return TryAcquireShared(&this->m_RawObject); },
+                false);
+#else
+            return TryAcquireShared(&this->m_RawObject);
+#endif
+        }
+
+        /**
+         * @brief Releases the slim reader/writer (SRW) lock that was acquired
+         *        in shared mode.
+        */
+        void UnlockShared() noexcept
+        {
+            ReleaseShared(&this->m_RawObject);
+        }
+    };
+
+#endif
+
+    /**
+     * @brief Wraps a critical section object. It is defined in Mile.Windows.h
+     *        on Windows, and above on the other platforms.
+    */
+    class CriticalSection;
+
+    /**
+     * @brief Wraps a slim reader/writer (SRW) lock. It is defined in
+     *        Mile.Windows.h on Windows, and above on the other platforms.
+    */
+    class SRWLock;
+
+    /**
+     * @brief Provides automatic locking and unlocking of a critical section.
+     * @tparam LockType The critical section type.
+    */
+    template<typename LockType>
+    class BasicAutoCriticalSectionLock
+    {
+    private:
+
+        /**
+         * @brief The critical section object.
+        */
+        LockType& m_Object;
+
+    public:
+
+        /**
+         * @brief Lock the critical section object.
+         * @param Object The critical section object.
+        */
+        explicit BasicAutoCriticalSectionLock(
+            LockType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_Object.Lock();
+        }
+
+        /**
+         * @brief Unlock the critical section object.
+        */
+        ~BasicAutoCriticalSectionLock() noexcept
+        {
+            this->m_Object.Unlock();
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to locking and unlocking of a critical
+     *        section.
+     * @tparam LockType The critical section type.
+    */
+    template<typename LockType>
+    class BasicAutoCriticalSectionTryLock
+    {
+    private:
+
+        /**
+         * @brief The critical section object.
+        */
+        LockType& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to lock the critical section object.
+         * @param Object The critical section object.
+        */
+        explicit BasicAutoCriticalSectionTryLock(
+            LockType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = this->m_Object.TryLock();
+        }
+
+        /**
+         * @brief Try to unlock the critical section object.
+        */
+        ~BasicAutoCriticalSectionTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                this->m_Object.Unlock();
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief Provides automatic locking and unlocking of a raw critical
+     *        section.
+     * @tparam LockType The critical section type.
+    */
+    template<typename LockType>
+    class BasicAutoRawCriticalSectionLock
+    {
+    private:
+
+        /**
+         * @brief The raw critical section object.
+        */
+        typename LockType::RawObjectType& m_Object;
+
+    public:
+
+        /**
+         * @brief Lock the raw critical section object.
+         * @param Object The raw critical section object.
+        */
+        explicit BasicAutoRawCriticalSectionLock(
+            typename LockType::RawObjectType& Object) noexcept :
+            m_Object(Object)
+        {
+            LockType::Enter(&this->m_Object);
+        }
+
+        /**
+         * @brief Unlock the raw critical section object.
+        */
+        ~BasicAutoRawCriticalSectionLock() noexcept
+        {
+            LockType::Leave(&this->m_Object);
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to locking and unlocking of a raw
+     *        critical section.
+     * @tparam LockType The critical section type.
+    */
+    template<typename LockType>
+    class BasicAutoRawCriticalSectionTryLock
+    {
+    private:
+
+        /**
+         * @brief The raw critical section object.
+        */
+        typename LockType::RawObjectType& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to lock the raw critical section object.
+         * @param Object The raw critical section object.
+        */
+        explicit BasicAutoRawCriticalSectionTryLock(
+            typename LockType::RawObjectType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = LockType::TryEnter(&this->m_Object);
+        }
+
+        /**
+         * @brief Try to unlock the raw critical section object.
+        */
+        ~BasicAutoRawCriticalSectionTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                LockType::Leave(&this->m_Object);
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief Provides automatic exclusive locking and unlocking of a slim
+     *        reader/writer (SRW) lock.
+     * @tparam LockType The slim reader/writer (SRW) lock type.
+    */
+    template<typename LockType>
+    class BasicAutoSRWExclusiveLock
+    {
+    private:
+
+        /**
+         * @brief The slim reader/writer (SRW) lock object.
+        */
+        LockType& m_Object;
+
+    public:
+
+        /**
+         * @brief Exclusive lock the slim reader/writer (SRW) lock object.
+         * @param Object The slim reader/writer (SRW) lock object.
+        */
+        explicit BasicAutoSRWExclusiveLock(
+            LockType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_Object.LockExclusive();
+        }
+
+        /**
+         * @brief Exclusive unlock the slim reader/writer (SRW) lock object.
+        */
+        ~BasicAutoSRWExclusiveLock() noexcept
+        {
+            this->m_Object.UnlockExclusive();
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to exclusive locking and unlocking of a
+     *        slim reader/writer (SRW) lock.
+     * @tparam LockType The slim reader/writer (SRW) lock type.
+    */
+    template<typename LockType>
+    class BasicAutoSRWExclusiveTryLock
+    {
+    private:
+
+        /**
+         * @brief The slim reader/writer (SRW) lock object.
+        */
+        LockType& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to exclusive lock the slim reader/writer (SRW) lock
+         *        object.
+         * @param Object The slim reader/writer (SRW) lock object.
+        */
+        explicit BasicAutoSRWExclusiveTryLock(
+            LockType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = this->m_Object.TryLockExclusive();
+        }
+
+        /**
+         * @brief Try to exclusive unlock the slim reader/writer (SRW) lock
+         *        object.
+        */
+        ~BasicAutoSRWExclusiveTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                this->m_Object.UnlockExclusive();
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief Provides automatic shared locking and unlocking of a slim
+     *        reader/writer (SRW) lock.
+     * @tparam LockType The slim reader/writer (SRW) lock type.
+    */
+    template<typename LockType>
+    class BasicAutoSRWSharedLock
+    {
+    private:
+
+        /**
+         * @brief The slim reader/writer (SRW) lock object.
+        */
+        LockType& m_Object;
+
+    public:
+
+        /**
+         * @brief Shared lock the slim reader/writer (SRW) lock object.
+         * @param Object The slim reader/writer (SRW) lock object.
+        */
+        explicit BasicAutoSRWSharedLock(
+            LockType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_Object.LockShared();
+        }
+
+        /**
+         * @brief Shared unlock the slim reader/writer (SRW) lock object.
+        */
+        ~BasicAutoSRWSharedLock() noexcept
+        {
+            this->m_Object.UnlockShared();
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to shared locking and unlocking of a
+     *        slim reader/writer (SRW) lock.
+     * @tparam LockType The slim reader/writer (SRW) lock type.
+    */
+    template<typename LockType>
+    class BasicAutoSRWSharedTryLock
+    {
+    private:
+
+        /**
+         * @brief The slim reader/writer (SRW) lock object.
+        */
+        LockType& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to shared lock the slim reader/writer (SRW) lock object.
+         * @param Object The slim reader/writer (SRW) lock object.
+        */
+        explicit BasicAutoSRWSharedTryLock(
+            LockType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = this->m_Object.TryLockShared();
+        }
+
+        /**
+         * @brief Try to shared unlock the slim reader/writer (SRW) lock
+         *        object.
+        */
+        ~BasicAutoSRWSharedTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                this->m_Object.UnlockShared();
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief Provides automatic exclusive locking and unlocking of a raw slim
+     *        reader/writer (SRW) lock.
+     * @tparam LockType The slim reader/writer (SRW) lock type.
+    */
+    template<typename LockType>
+    class BasicAutoRawSRWExclusiveLock
+    {
+    private:
+
+        /**
+         * @brief The slim reader/writer (SRW) lock object.
+        */
+        typename LockType::RawObjectType& m_Object;
+
+    public:
+
+        /**
+         * @brief Exclusive lock the raw slim reader/writer (SRW) lock object.
+         * @param Object The raw slim reader/writer (SRW) lock object.
+        */
+        explicit BasicAutoRawSRWExclusiveLock(
+            typename LockType::RawObjectType& Object) noexcept :
+            m_Object(Object)
+        {
+            LockType::AcquireExclusive(&this->m_Object);
+        }
+
+        /**
+         * @brief Exclusive unlock the raw slim reader/writer (SRW) lock
+         *        object.
+        */
+        ~BasicAutoRawSRWExclusiveLock() noexcept
+        {
+            LockType::ReleaseExclusive(&this->m_Object);
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to exclusive locking and unlocking of a
+     *        raw slim reader/writer (SRW) lock.
+     * @tparam LockType The slim reader/writer (SRW) lock type.
+    */
+    template<typename LockType>
+    class BasicAutoRawSRWExclusiveTryLock
+    {
+    private:
+
+        /**
+         * @brief The raw slim reader/writer (SRW) lock object.
+        */
+        typename LockType::RawObjectType& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to exclusive lock the raw slim reader/writer (SRW) lock
+         *        object.
+         * @param Object The slim reader/writer (SRW) lock object.
+        */
+        explicit BasicAutoRawSRWExclusiveTryLock(
+            typename LockType::RawObjectType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = LockType::TryAcquireExclusive(&this->m_Object);
+        }
+
+        /**
+         * @brief Try to exclusive unlock the raw slim reader/writer (SRW) lock
+         *        object.
+        */
+        ~BasicAutoRawSRWExclusiveTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                LockType::ReleaseExclusive(&this->m_Object);
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief Provides automatic shared locking and unlocking of a raw slim
+     *        reader/writer (SRW) lock.
+     * @tparam LockType The slim reader/writer (SRW) lock type.
+    */
+    template<typename LockType>
+    class BasicAutoRawSRWSharedLock
+    {
+    private:
+
+        /**
+         * @brief The raw slim reader/writer (SRW) lock object.
+        */
+        typename LockType::RawObjectType& m_Object;
+
+    public:
+
+        /**
+         * @brief Shared lock the raw slim reader/writer (SRW) lock object.
+         * @param Object The raw slim reader/writer (SRW) lock object.
+        */
+        explicit BasicAutoRawSRWSharedLock(
+            typename LockType::RawObjectType& Object) noexcept :
+            m_Object(Object)
+        {
+            LockType::AcquireShared(&this->m_Object);
+        }
+
+        /**
+         * @brief Shared unlock the raw slim reader/writer (SRW) lock object.
+        */
+        ~BasicAutoRawSRWSharedLock() noexcept
+        {
+            LockType::ReleaseShared(&this->m_Object);
+        }
+    };
+
+    /**
+     * @brief Provides automatic trying to shared locking and unlocking of a
+     *        raw slim reader/writer (SRW) lock.
+     * @tparam LockType The slim reader/writer (SRW) lock type.
+    */
+    template<typename LockType>
+    class BasicAutoRawSRWSharedTryLock
+    {
+    private:
+
+        /**
+         * @brief The raw slim reader/writer (SRW) lock object.
+        */
+        typename LockType::RawObjectType& m_Object;
+
+        /**
+         * @brief The lock status.
+        */
+        bool m_IsLocked;
+
+    public:
+
+        /**
+         * @brief Try to shared lock the raw slim reader/writer (SRW) lock
+         *        object.
+         * @param Object The raw slim reader/writer (SRW) lock object.
+        */
+        explicit BasicAutoRawSRWSharedTryLock(
+            typename LockType::RawObjectType& Object) noexcept :
+            m_Object(Object)
+        {
+            this->m_IsLocked = LockType::TryAcquireShared(&this->m_Object);
+        }
+
+        /**
+         * @brief Try to shared unlock the raw slim reader/writer (SRW) lock
+         *        object.
+        */
+        ~BasicAutoRawSRWSharedTryLock() noexcept
+        {
+            if (this->m_IsLocked)
+            {
+                LockType::ReleaseShared(&this->m_Object);
+            }
+        }
+
+        /**
+         * @brief Check the lock status.
+         * @return The lock status.
+        */
+        bool IsLocked() const
+        {
+            return this->m_IsLocked;
+        }
+    };
+
+    /**
+     * @brief Provides automatic locking and unlocking of a critical section.
+    */
+    using AutoCriticalSectionLock =
+        BasicAutoCriticalSectionLock<CriticalSection>;
+
+    /**
+     * @brief Provides automatic trying to locking and unlocking of a critical
+     *        section.
+    */
+    using AutoCriticalSectionTryLock =
+        BasicAutoCriticalSectionTryLock<CriticalSection>;
+
+    /**
+     * @brief Provides automatic locking and unlocking of a raw critical
+     *        section.
+    */
+    using AutoRawCriticalSectionLock =
+        BasicAutoRawCriticalSectionLock<CriticalSection>;
+
+    /**
+     * @brief Provides automatic trying to locking and unlocking of a raw
+     *        critical section.
+    */
+    using AutoRawCriticalSectionTryLock =
+        BasicAutoRawCriticalSectionTryLock<CriticalSection>;
+
+    /**
+     * @brief Provides automatic exclusive locking and unlocking of a slim
+     *        reader/writer (SRW) lock.
+    */
+    using AutoSRWExclusiveLock = BasicAutoSRWExclusiveLock<SRWLock>;
+
+    /**
+     * @brief Provides automatic trying to exclusive locking and unlocking of a
+     *        slim reader/writer (SRW) lock.
+    */
+    using AutoSRWExclusiveTryLock = BasicAutoSRWExclusiveTryLock<SRWLock>;
+
+    /**
+     * @brief Provides automatic shared locking and unlocking of a slim
+     *        reader/writer (SRW) lock.
+    */
+    using AutoSRWSharedLock = BasicAutoSRWSharedLock<SRWLock>;
+
+    /**
+     * @brief Provides automatic trying to shared locking and unlocking of a
+     *        slim reader/writer (SRW) lock.
+    */
+    using AutoSRWSharedTryLock = BasicAutoSRWSharedTryLock<SRWLock>;
+
+    /**
+     * @brief Provides automatic exclusive locking and unlocking of a raw slim
+     *        reader/writer (SRW) lock.
+    */
+    using AutoRawSRWExclusiveLock = BasicAutoRawSRWExclusiveLock<SRWLock>;
+
+    /**
+     * @brief Provides automatic trying to exclusive locking and unlocking of a
+     *        raw slim reader/writer (SRW) lock.
+    */
+    using AutoRawSRWExclusiveTryLock = BasicAutoRawSRWExclusiveTryLock<SRWLock>;
+
+    /**
+     * @brief Provides automatic shared locking and unlocking of a raw slim
+     *        reader/writer (SRW) lock.
+    */
+    using AutoRawSRWSharedLock = BasicAutoRawSRWSharedLock<SRWLock>;
+
+    /**
+     * @brief Provides automatic trying to shared locking and unlocking of a
+     *        raw slim reader/writer (SRW) lock.
+    */
+    using AutoRawSRWSharedTryLock = BasicAutoRawSRWSharedTryLock<SRWLock>;
+
+#ifdef MILE_ENABLE_ALLOCATION_ACCOUNTING
+
+    /**
+     * @brief The allocation statistics of a tagged call site. The memory
+     *        is counted as live until the free is recorded with the same site
+     *        name, except for the call sites which hand the memory off.
+    */
+    struct AllocationSiteStatistics
+    {
+        char const* Name;
+        bool IsHandedOff;
+        std::uint64_t AllocationCount;
+        std::uint64_t FreeCount;
+        std::uint64_t AllocatedBytes;
+        std::uint64_t FreedBytes;
+        std::int64_t LiveBytes;
+        std::int64_t PeakLiveBytes;
+    };
+
+    /**
+     * @brief Registers a tagged call site for the allocation accounting. The
+     *        call sites with the same name share the same statistics.
+     * @param Name The name of the call site, which should be a string literal.
+     * @param HandedOff Whether the memory is handed to the callers, which
+     *                  free it without recording. The live bytes are not
+     *                  tracked for such call sites, and LiveBytes and
+     *                  PeakLiveBytes are always 0.
+     * @return The index of the call site. If too many call sites are
+     *         registered, the return value is SIZE_MAX and the events of the
+     *         call site are ignored.
+    */
+    std::size_t RegisterAllocationSite(
+        char const* Name,
+        bool HandedOff = false) noexcept;
+
+    /**
+     * @brief Records an allocation of the call site. The events are counted
+     *        in the cache of the current thread, and are merged into the
+     *        statistics of the call site in batches.
+     * @param Site The index of the call site.
+     * @param Size The number of bytes allocated.
+    */
+    void RecordAllocation(
+        std::size_t Site,
+        std::size_t Size) noexcept;
+
+    /**
+     * @brief Records a free of the call site. The events are counted in the
+     *        cache of the current thread, and are merged into the statistics
+     *        of the call site in batches.
+     * @param Site The index of the call site.
+     * @param Size The number of bytes freed.
+    */
+    void RecordFree(
+        std::size_t Site,
+        std::size_t Size) noexcept;
+
+    /**
+     * @brief Merges the events cached by the current thread into the
+     *        statistics of the call sites. The events cached by the other
+     *        threads are merged when the threads exit.
+    */
+    void FlushAllocationStatistics() noexcept;
+
+    /**
+     * @brief Retrieves a snapshot of the statistics of all call sites, after
+     *        merging the events cached by the current thread.
+     * @return The statistics of all call sites in the registration order.
+    */
+    std::vector<AllocationSiteStatistics> GetAllocationStatistics();
+
+    /**
+     * @brief Formats a snapshot of the statistics of all call sites as a
+     *        table, sorted by the allocated bytes in descending order.
+     * @return The formatted text, one call site per line.
+    */
+    std::string DumpAllocationStatistics();
+
+    /**
+     * @brief Gets the number of heap bytes owned by a string for the
+     *        allocation accounting, including the terminating null character.
+     *        The strings in the small string buffer own no heap bytes.
+     * @tparam CharType The character type of the string.
+     * @param Value The string.
+     * @return The number of heap bytes owned by the string.
+    */
+    template<typename CharType>
+    std::size_t GetAccountedSize(
+        std::basic_string<CharType> const& Value)
+    {
+        std::uintptr_t Data = reinterpret_cast<std::uintptr_t>(Value.data());
+        std::uintptr_t Object = reinterpret_cast<std::uintptr_t>(&Value);
+        if (Data >= Object && Data < Object + sizeof(Value))
+        {
+            return 0;
+        }
+        return (Value.capacity() + 1) * sizeof(CharType);
+    }
+
+    /**
+     * @brief Gets the number of heap bytes owned by a string list for the
+     *        allocation accounting, including the strings in the list.
+     * @tparam CharType The character type of the strings.
+     * @param Value The string list.
+     * @return The number of heap bytes owned by the string list.
+    */
+    template<typename CharType>
+    std::size_t GetAccountedSize(
+        std::vector<std::basic_string<CharType>> const& Value)
+    {
+        std::size_t Size =
+            Value.capacity() * sizeof(std::basic_string<CharType>);
+        for (std::basic_string<CharType> const& Item : Value)
+        {
+            Size += GetAccountedSize(Item);
+        }
+        return Size;
+    }
+
+/**
+ * @brief Records an allocation of the tagged call site.
+ * @param SiteName The name of the call site, which should be a string literal.
+ * @param Size The number of bytes allocated.
+*/
+#define MILE_ACCOUNT_ALLOCATION(SiteName, Size) \
+    do \
+    { \
+        static const std::size_t MileAllocationSite = \
+            ::Mile::RegisterAllocationSite(SiteName); \
+        ::Mile::RecordAllocation(MileAllocationSite, (Size)); \
+    } while (false)
+
+/**
+ * @brief Records an allocation of the tagged call site which hands the memory
+ *        to the callers, so the free is not recorded.
+ * @param SiteName The name of the call site, which should be a string literal.
+ * @param Size The number of bytes allocated.
+*/
+#define MILE_ACCOUNT_HANDED_OFF_ALLOCATION(SiteName, Size) \
+    do \
+    { \
+        static const std::size_t MileAllocationSite = \
+            ::Mile::RegisterAllocationSite(SiteName, true); \
+        ::Mile::RecordAllocation(MileAllocationSite, (Size)); \
+    } while (false)
+
+/**
+ * @brief Records a free of the tagged call site.
+ * @param SiteName The name of the call site, which should be a string literal.
+ * @param Size The number of bytes freed.
+*/
+#define MILE_ACCOUNT_FREE(SiteName, Size) \
+    do \
+    { \
+        static const std::size_t MileAllocationSite = \
+            ::Mile::RegisterAllocationSite(SiteName); \
+        ::Mile::RecordFree(MileAllocationSite, (Size)); \
+    } while (false)
+
+#else
+
+#define MILE_ACCOUNT_ALLOCATION(SiteName, Size) do { } while (false)
+#define MILE_ACCOUNT_HANDED_OFF_ALLOCATION(SiteName, Size) \
+    do { } while (false)
+#define MILE_ACCOUNT_FREE(SiteName, Size) do { } while (false)
+
+#endif
+
+#if defined(MILE_PORTABLE_ENABLE_CHAR8_T) && !defined(__cpp_char8_t)
+#error MILE_PORTABLE_ENABLE_CHAR8_T requires a compiler with char8_t support.
+#endif
+
+    /**
+     * @brief Checks whether the command line templates are instantiated in
+     *        Mile.Portable.cpp for a character type. They are instantiated for
+     *        char, wchar_t and char16_t. The char8_t instantiations only exist
+     *        if MILE_PORTABLE_ENABLE_CHAR8_T is defined for the whole project,
+     *        including Mile.Portable.cpp, which must then be compiled as
+     *        C++20 or later. Otherwise using char8_t is a compile error.
+     * @tparam CharType The character type to check.
+    */
+    template<typename CharType>
+    struct IsCommandLineCharType : std::false_type
+    {
+    };
+
+    template<>
+    struct IsCommandLineCharType<char> : std::true_type
+    {
+    };
+
+    template<>
+    struct IsCommandLineCharType<wchar_t> : std::true_type
+    {
+    };
+
+    template<>
+    struct IsCommandLineCharType<char16_t> : std::true_type
+    {
+    };
+
+#if defined(MILE_PORTABLE_ENABLE_CHAR8_T)
+    template<>
+    struct IsCommandLineCharType<char8_t> : std::true_type
+    {
+    };
+#endif
+
+    /**
+     * @brief The template for defining the read-only string spans, which
+     *        refer to a contiguous sequence of characters owned by others.
+     * @tparam CharType The character type of the string span.
+    */
+    template<typename CharType>
+    class BasicStringSpan
+    {
+    private:
+
+        /**
+         * @brief The pointer to the first character of the string span.
+        */
+        CharType const* m_Data = nullptr;
+
+        /**
+         * @brief The number of characters in the string span.
+        */
+        std::size_t m_Size = 0;
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the empty string span.
+        */
+        constexpr BasicStringSpan() noexcept = default;
+
+        /**
+         * @brief Initializes a new instance of the string span.
+         * @param Data The pointer to the first character of the string span.
+         * @param Size The number of characters in the string span.
+        */
+        constexpr BasicStringSpan(
+            CharType const* Data,
+            std::size_t Size) noexcept :
+            m_Data(Data),
+            m_Size(Size)
+        {
+        }
+
+        /**
+         * @brief Initializes a new instance of the string span which refers to
+         *        the content of a string.
+         * @param Source The string which the string span refers to.
+        */
+        BasicStringSpan(
+            std::basic_string<CharType> const& Source) noexcept :
+            m_Data(Source.c_str()),
+            m_Size(Source.size())
+        {
+        }
+
+        /**
+         * @brief Returns the pointer to the first character of the string
+         *        span.
+         * @return The pointer to the first character of the string span.
+        */
+        constexpr CharType const* Data() const noexcept
+        {
+            return this->m_Data;
+        }
+
+        /**
+         * @brief Returns the number of characters in the string span.
+         * @return The number of characters in the string span.
+        */
+        constexpr std::size_t Size() const noexcept
+        {
+            return this->m_Size;
+        }
+
+        /**
+         * @brief Checks whether the string span has no characters.
+         * @return true if the string span is empty, otherwise false.
+        */
+        constexpr bool Empty() const noexcept
+        {
+            return 0 == this->m_Size;
+        }
+
+        /**
+         * @brief Returns the pointer to the first character of the string
+         *        span.
+         * @return The pointer to the first character of the string span.
+        */
+        constexpr CharType const* begin() const noexcept
+        {
+            return this->m_Data;
+        }
+
+        /**
+         * @brief Returns the pointer to the character following the last
+         *        character of the string span.
+         * @return The pointer to the character following the last character
+         *         of the string span.
+        */
+        constexpr CharType const* end() const noexcept
+        {
+            return this->m_Data + this->m_Size;
+        }
+
+        /**
+         * @brief Returns the character at the specified location.
+         * @param Index The location of the character to return.
+         * @return The character at the specified location.
+        */
+        constexpr CharType operator[](std::size_t Index) const noexcept
+        {
+            return this->m_Data[Index];
+        }
+
+        /**
+         * @brief Copies the content of the string span to a new string.
+         * @return The string containing the content of the string span.
+        */
+        std::basic_string<CharType> ToString() const
+        {
+            return std::basic_string<CharType>(this->m_Data, this->m_Size);
+        }
+    };
+
+    /**
+     * @brief The read-only string span of narrow characters.
+    */
+    using StringSpan = BasicStringSpan<char>;
+
+    /**
+     * @brief The read-only string span of wide characters.
+    */
+    using WideStringSpan = BasicStringSpan<wchar_t>;
+
+    /**
+     * @brief The template for defining the unique buffers, which own a
+     *        contiguous sequence of elements and also carry its length and
+     *        capacity, so the callers need not rescan or copy the content.
+     * @tparam ElementType The element type of the unique buffer.
+     * @tparam TraitsType A traits type that specifies how to free the
+     *                    buffer, the object type of it should be a pointer to
+     *                    ElementType.
+    */
+    template<typename ElementType, typename TraitsType>
+    class BasicUniqueBuffer : DisableCopyConstruction
+    {
+    private:
+
+        /**
+         * @brief The underlying unique object of the buffer.
+        */
+        UniqueObject<TraitsType> m_Object;
+
+        /**
+         * @brief The number of the valid elements in the buffer.
+        */
+        std::size_t m_Length = 0;
+
+        /**
+         * @brief The number of the elements which the buffer can hold.
+        */
+        std::size_t m_Capacity = 0;
+
+    public:
+
+        /**
+         * @brief Frees the underlying buffer.
+        */
+        void Close() noexcept
+        {
+            this->m_Object.Close();
+            this->m_Length = 0;
+            this->m_Capacity = 0;
+        }
+
+        /**
+         * @brief Returns the pointer to the first element of the buffer.
+         * @return The pointer to the first element of the buffer.
+        */
+        ElementType* Get() const noexcept
+        {
+            return this->m_Object.Get();
+        }
+
+        /**
+         * @brief Returns the number of the valid elements in the buffer.
+         * @return The number of the valid elements in the buffer.
+        */
+        std::size_t Length() const noexcept
+        {
+            return this->m_Length;
+        }
+
+        /**
+         * @brief Returns the number of the elements which the buffer can hold.
+         * @return The number of the elements which the buffer can hold.
+        */
+        std::size_t Capacity() const noexcept
+        {
+            return this->m_Capacity;
+        }
+
+        /**
+         * @brief Checks whether the buffer has no valid element.
+         * @return true if the buffer has no valid element, otherwise false.
+        */
+        bool Empty() const noexcept
+        {
+            return 0 == this->m_Length;
+        }
+
+        /**
+         * @brief Returns a read-only span of the valid elements, which is
+         *        only available for the character element types.
+         * @return The read-only span of the valid elements.
+        */
+        BasicStringSpan<ElementType> View() const noexcept
+        {
+            return BasicStringSpan<ElementType>(
+                this->m_Object.Get(),
+                this->m_Length);
+        }
+
+        /**
+         * @brief Attaches to a buffer, and takes ownership of it.
+         * @param Value The buffer to attach to.
+         * @param Length The number of the valid elements in the buffer.
+         * @param Capacity The number of the elements which the buffer can
+         *                 hold.
+        */
+        void Attach(
+            ElementType* Value,
+            std::size_t Length,
+            std::size_t Capacity) noexcept
+        {
+            this->m_Object.Attach(Value);
+            this->m_Length = Value ? Length : 0;
+            this->m_Capacity = Value ? Capacity : 0;
+        }
+
+        /**
+         * @brief Updates the number of the valid elements in the buffer, which
+         *        should not be greater than the capacity.
+         * @param Length The number of the valid elements in the buffer.
+        */
+        void SetLength(
+            std::size_t Length) noexcept
+        {
+            this->m_Length = Length;
+        }
+
+        /**
+         * @brief Detaches from the underlying buffer.
+         * @return The underlying buffer formerly owned by the unique buffer.
+        */
+        ElementType* Detach() noexcept
+        {
+            this->m_Length = 0;
+            this->m_Capacity = 0;
+            return this->m_Object.Detach();
+        }
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the empty unique buffer.
+        */
+        BasicUniqueBuffer() noexcept = default;
+
+        /**
+         * @brief Initializes a new instance of the unique buffer.
+         * @param Value The buffer to take ownership of.
+         * @param Length The number of the valid elements in the buffer.
+         * @param Capacity The number of the elements which the buffer can
+         *                 hold.
+        */
+        BasicUniqueBuffer(
+            ElementType* Value,
+            std::size_t Length,
+            std::size_t Capacity) noexcept :
+            m_Object(Value),
+            m_Length(Value ? Length : 0),
+            m_Capacity(Value ? Capacity : 0)
+        {
+        }
+
+        /**
+         * @brief Initializes a new instance of the unique buffer.
+         * @param Other Another unique buffer that initializes the unique
+         *        buffer.
+        */
+        BasicUniqueBuffer(BasicUniqueBuffer&& Other) noexcept :
+            m_Object(std::move(Other.m_Object)),
+            m_Length(Other.m_Length),
+            m_Capacity(Other.m_Capacity)
+        {
+            Other.m_Length = 0;
+            Other.m_Capacity = 0;
+        }
+
+        /**
+         * @brief Assigns another unique buffer to the unique buffer.
+         * @param Other Another unique buffer to assign to the unique buffer.
+         * @return A reference to the unique buffer.
+        */
+        BasicUniqueBuffer& operator=(BasicUniqueBuffer&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                std::size_t Length = Other.m_Length;
+                std::size_t Capacity = Other.m_Capacity;
+                this->Attach(Other.Detach(), Length, Capacity);
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Checks whether or not the unique buffer currently owns a
+         *        buffer.
+         * @return true if the unique buffer currently owns a buffer,
+         *         otherwise false.
+        */
+        explicit operator bool() const noexcept
+        {
+            return static_cast<bool>(this->m_Object);
+        }
+
+        /**
+         * @brief Returns a reference to the element at the specified position.
+         * @param Index The position of the element.
+         * @return The reference to the element.
+        */
+        ElementType& operator[](std::size_t Index) const noexcept
+        {
+            return this->m_Object.Get()[Index];
+        }
+
+        /**
+         * @brief Returns an iterator to the first valid element.
+         * @return The iterator to the first valid element.
+        */
+        ElementType* begin() const noexcept
+        {
+            return this->m_Object.Get();
+        }
+
+        /**
+         * @brief Returns an iterator past the last valid element.
+         * @return The iterator past the last valid element.
+        */
+        ElementType* end() const noexcept
+        {
+            return this->m_Object.Get() + this->m_Length;
+        }
+
+        /**
+         * @brief Swaps the contents of the two unique buffer parameters.
+         * @param Left A unique buffer whose content to mutually swap with that
+         *             of the other parameter.
+         * @param Right A unique buffer whose content to mutually swap with
+         *              that of the other parameter.
+        */
+        friend void swap(
+            BasicUniqueBuffer& Left,
+            BasicUniqueBuffer& Right) noexcept
+        {
+            swap(Left.m_Object, Right.m_Object);
+            std::swap(Left.m_Length, Right.m_Length);
+            std::swap(Left.m_Capacity, Right.m_Capacity);
+        }
+    };
+
+    /**
+     * @brief The template for defining the arrays of the command arguments
+     *        which are unescaped into a single allocation. Each argument is
+     *        also terminated with a null character for the interoperability
+     *        with C-style APIs.
+     * @tparam CharType The character type of the command arguments.
+    */
+    template<typename CharType>
+    class BasicCommandArgumentSpans : DisableCopyConstruction
+    {
+        static_assert(
+            IsCommandLineCharType<CharType>::value,
+            "The command line templates are not instantiated for the "
+            "character type, see Mile::IsCommandLineCharType.");
+
+    public:
+
+        /**
+         * @brief The string span type of the command arguments.
+        */
+        using StringSpanType = BasicStringSpan<CharType>;
+
+    private:
+
+        /**
+         * @brief The allocation which contains the array of the argument spans
+         *        followed by the unescaped argument characters.
+        */
+        StringSpanType* m_Arguments = nullptr;
+
+        /**
+         * @brief The number of the arguments.
+        */
+        std::size_t m_Count = 0;
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the empty command arguments.
+        */
+        BasicCommandArgumentSpans() noexcept = default;
+
+        /**
+         * @brief Initializes a new instance of the command arguments.
+         * @param Arguments The allocation which contains the array of the
+         *                  argument spans followed by the unescaped argument
+         *                  characters, it should be allocated by the operator
+         *                  new, and the command arguments will take ownership
+         *                  of it.
+         * @param Count The number of the arguments.
+        */
+        BasicCommandArgumentSpans(
+            StringSpanType* Arguments,
+            std::size_t Count) noexcept :
+            m_Arguments(Arguments),
+            m_Count(Count)
+        {
+        }
+
+        /**
+         * @brief Initializes a new instance of the command arguments.
+         * @param Other Another command arguments that initializes the command
+         *              arguments.
+        */
+        BasicCommandArgumentSpans(BasicCommandArgumentSpans&& Other) noexcept :
+            m_Arguments(Other.m_Arguments),
+            m_Count(Other.m_Count)
+        {
+            Other.m_Arguments = nullptr;
+            Other.m_Count = 0;
+        }
+
+        /**
+         * @brief Assigns a value to the command arguments.
+         * @param Other Another command arguments to assign to the command
+         *              arguments.
+         * @return A reference to the command arguments.
+        */
+        BasicCommandArgumentSpans& operator=(
+            BasicCommandArgumentSpans&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                ::operator delete(this->m_Arguments);
+                this->m_Arguments = Other.m_Arguments;
+                this->m_Count = Other.m_Count;
+                Other.m_Arguments = nullptr;
+                Other.m_Count = 0;
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Uninitializes the instance of the command arguments.
+        */
+        ~BasicCommandArgumentSpans() noexcept
+        {
+            ::operator delete(this->m_Arguments);
+        }
+
+        /**
+         * @brief Returns the number of the arguments.
+         * @return The number of the arguments.
+        */
+        std::size_t Count() const noexcept
+        {
+            return this->m_Count;
+        }
+
+        /**
+         * @brief Returns the argument at the specified location.
+         * @param Index The location of the argument to return.
+         * @return The argument at the specified location.
+        */
+        StringSpanType const& operator[](std::size_t Index) const noexcept
+        {
+            return this->m_Arguments[Index];
+        }
+
+        /**
+         * @brief Returns the pointer to the first argument.
+         * @return The pointer to the first argument.
+        */
+        StringSpanType const* begin() const noexcept
+        {
+            return this->m_Arguments;
+        }
+
+        /**
+         * @brief Returns the pointer to the argument following the last
+         *        argument.
+         * @return The pointer to the argument following the last argument.
+        */
+        StringSpanType const* end() const noexcept
+        {
+            return this->m_Arguments + this->m_Count;
+        }
+    };
+
+    /**
+     * @brief The array of the command arguments of wide characters.
+    */
+    using CommandArgumentSpans = BasicCommandArgumentSpans<wchar_t>;
+
+    /**
+     * @brief The template for defining the lazy ranges of the command
+     *        arguments. The arguments are unescaped one per increment in a way
+     *        that is similar to the standard C run-time, so the callers can
+     *        stop early without decoding the rest of the command arguments.
+     *        The arguments without quotes and backslashes refer to the source
+     *        directly, and the other arguments are unescaped into a buffer
+     *        owned by the range, which is only allocated once when needed.
+     * @tparam CharType The character type of the command arguments.
+     * @remark The argument referred by an iterator is only valid until the
+     *         next increment of any iterator of the same range, and it is not
+     *         null-terminated. The source must outlive the range.
+    */
+    template<typename CharType>
+    class BasicCommandArgumentRange : DisableCopyConstruction
+    {
+        static_assert(
+            IsCommandLineCharType<CharType>::value,
+            "The command line templates are not instantiated for the "
+            "character type, see Mile::IsCommandLineCharType.");
+
+    public:
+
+        /**
+         * @brief The string span type of the command arguments.
+        */
+        using StringSpanType = BasicStringSpan<CharType>;
+
+        /**
+         * @brief The iterator type of the command arguments.
+        */
+        class Iterator
+        {
+        public:
+
+            using iterator_category = std::input_iterator_tag;
+            using value_type = StringSpanType;
+            using difference_type = std::ptrdiff_t;
+            using pointer = StringSpanType const*;
+            using reference = StringSpanType const&;
+
+        private:
+
+            /**
+             * @brief The range which owns the iterator.
+            */
+            BasicCommandArgumentRange* m_Range = nullptr;
+
+            /**
+             * @brief The source of the current argument, or nullptr if the
+             *        iterator is at the end.
+            */
+            CharType const* m_Source = nullptr;
+
+            /**
+             * @brief The source following the current argument.
+            */
+            CharType const* m_Next = nullptr;
+
+            /**
+             * @brief The current argument.
+            */
+            StringSpanType m_Argument;
+
+        public:
+
+            /**
+             * @brief Initializes a new instance of the end iterator.
+            */
+            Iterator() noexcept = default;
+
+            /**
+             * @brief Initializes a new instance of the iterator and decodes
+             *        the first argument from the source.
+             * @param Range The range which owns the iterator.
+             * @param Source The source to decode.
+            */
+            Iterator(
+                BasicCommandArgumentRange* Range,
+                CharType const* Source) :
+                m_Range(Range)
+            {
+                this->m_Range->Decode(
+                    Source,
+                    this->m_Source,
+                    this->m_Next,
+                    this->m_Argument);
+            }
+
+            /**
+             * @brief Returns the current argument.
+             * @return The current argument.
+            */
+            reference operator*() const noexcept
+            {
+                return this->m_Argument;
+            }
+
+            /**
+             * @brief Returns the pointer to the current argument.
+             * @return The pointer to the current argument.
+            */
+            pointer operator->() const noexcept
+            {
+                return &this->m_Argument;
+            }
+
+            /**
+             * @brief Decodes the next argument.
+             * @return A reference to the iterator.
+            */
+            Iterator& operator++()
+            {
+                this->m_Range->Decode(
+                    this->m_Next,
+                    this->m_Source,
+                    this->m_Next,
+                    this->m_Argument);
+                return *this;
+            }
+
+            /**
+             * @brief Decodes the next argument.
+             * @return The iterator before the increment.
+            */
+            Iterator operator++(int)
+            {
+                Iterator Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            /**
+             * @brief Checks whether the iterators refer to the same argument.
+             * @param Other The iterator to compare.
+             * @return true if the iterators are equal, otherwise false.
+            */
+            bool operator==(Iterator const& Other) const noexcept
+            {
+                return this->m_Source == Other.m_Source;
+            }
+
+            /**
+             * @brief Checks whether the iterators refer to different
+             *        arguments.
+             * @param Other The iterator to compare.
+             * @return true if the iterators are not equal, otherwise false.
+            */
+            bool operator!=(Iterator const& Other) const noexcept
+            {
+                return this->m_Source != Other.m_Source;
+            }
+
+            /**
+             * @brief Returns the offset of the current argument in the source.
+             * @return The offset of the current argument in the source.
+            */
+            std::size_t SourceOffset() const noexcept
+            {
+                return this->m_Source - this->m_Range->m_Begin;
+            }
+
+            /**
+             * @brief Returns the length of the current argument in the source,
+             *        including the quotes and the escape characters.
+             * @return The length of the current argument in the source.
+            */
+            std::size_t SourceLength() const noexcept
+            {
+                return this->m_Next - this->m_Source;
+            }
+        };
+
+    private:
+
+        /**
+         * @brief The beginning of the source.
+        */
+        CharType const* m_Begin = nullptr;
+
+        /**
+         * @brief The end of the source.
+        */
+        CharType const* m_End = nullptr;
+
+        /**
+         * @brief The buffer for the arguments which need to be unescaped.
+        */
+        std::unique_ptr<CharType[]> m_Buffer;
+
+        /**
+         * @brief Decodes the argument from the source.
+         * @param Source The source to decode.
+         * @param ArgumentSource The source of the decoded argument, or nullptr
+         *                       if there are no more arguments.
+         * @param Next The source following the decoded argument.
+         * @param Argument The decoded argument.
+        */
+        void Decode(
+            CharType const* Source,
+            CharType const*& ArgumentSource,
+            CharType const*& Next,
+            StringSpanType& Argument);
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the command argument range.
+         * @param Arguments The pointer to the command arguments string.
+         * @param Length The length of the command arguments string.
+        */
+        BasicCommandArgumentRange(
+            CharType const* Arguments,
+            std::size_t Length) noexcept :
+            m_Begin(Arguments),
+            m_End(Arguments + Length)
+        {
+        }
+
+        /**
+         * @brief Initializes a new instance of the command argument range.
+         * @param Arguments The command arguments string.
+        */
+        BasicCommandArgumentRange(
+            StringSpanType const& Arguments) noexcept :
+            m_Begin(Arguments.begin()),
+            m_End(Arguments.end())
+        {
+        }
+
+        /**
+         * @brief Initializes a new instance of the command argument range.
+         * @param Other Another command argument range that initializes the
+         *              command argument range.
+        */
+        BasicCommandArgumentRange(
+            BasicCommandArgumentRange&& Other) noexcept :
+            m_Begin(Other.m_Begin),
+            m_End(Other.m_End),
+            m_Buffer(std::move(Other.m_Buffer))
+        {
+        }
+
+        /**
+         * @brief Returns the iterator to the first argument.
+         * @return The iterator to the first argument.
+        */
+        Iterator begin()
+        {
+            return Iterator(this, this->m_Begin);
+        }
+
+        /**
+         * @brief Returns the iterator following the last argument.
+         * @return The iterator following the last argument.
+        */
+        Iterator end() noexcept
+        {
+            return Iterator();
+        }
+    };
+
+    /**
+     * @brief The lazy range of the command arguments of wide characters.
+    */
+    using CommandArgumentRange = BasicCommandArgumentRange<wchar_t>;
+
+    /**
+     * @brief The template for defining the command arguments of a batch of
+     *        command lines in the columnar layout. The unescaped arguments of
+     *        all command lines are stored in a single character arena, each
+     *        argument is terminated with a null character, and the arguments
+     *        and the lines are indexed by the offset arrays.
+     * @tparam CharType The character type of the command arguments.
+    */
+    template<typename CharType>
+    class BasicCommandArgumentBatch : DisableCopyConstruction
+    {
+        static_assert(
+            IsCommandLineCharType<CharType>::value,
+            "The command line templates are not instantiated for the "
+            "character type, see Mile::IsCommandLineCharType.");
+
+    public:
+
+        /**
+         * @brief The string span type of the command arguments.
+        */
+        using StringSpanType = BasicStringSpan<CharType>;
+
+    private:
+
+        /**
+         * @brief The character arena of the unescaped arguments.
+        */
+        std::unique_ptr<CharType[]> m_Arena;
+
+        /**
+         * @brief The offsets of the arguments in the arena, followed by the
+         *        size of the arena.
+        */
+        std::unique_ptr<std::size_t[]> m_ArgumentOffsets;
+
+        /**
+         * @brief The indices of the first arguments of the lines, followed by
+         *        the number of the arguments.
+        */
+        std::unique_ptr<std::size_t[]> m_LineOffsets;
+
+        /**
+         * @brief The number of the lines.
+        */
+        std::size_t m_LineCount = 0;
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the empty batch.
+        */
+        BasicCommandArgumentBatch() noexcept = default;
+
+        /**
+         * @brief Initializes a new instance of the batch.
+         * @param Arena The character arena of the unescaped arguments.
+         * @param ArgumentOffsets The offsets of the arguments in the arena,
+         *                        followed by the size of the arena.
+         * @param LineOffsets The indices of the first arguments of the lines,
+         *                    followed by the number of the arguments.
+         * @param LineCount The number of the lines.
+        */
+        BasicCommandArgumentBatch(
+            std::unique_ptr<CharType[]>&& Arena,
+            std::unique_ptr<std::size_t[]>&& ArgumentOffsets,
+            std::unique_ptr<std::size_t[]>&& LineOffsets,
+            std::size_t LineCount) noexcept :
+            m_Arena(std::move(Arena)),
+            m_ArgumentOffsets(std::move(ArgumentOffsets)),
+            m_LineOffsets(std::move(LineOffsets)),
+            m_LineCount(LineCount)
+        {
+        }
+
+        /**
+         * @brief Initializes a new instance of the batch.
+         * @param Other Another batch that initializes the batch.
+        */
+        BasicCommandArgumentBatch(
+            BasicCommandArgumentBatch&& Other) noexcept :
+            m_Arena(std::move(Other.m_Arena)),
+            m_ArgumentOffsets(std::move(Other.m_ArgumentOffsets)),
+            m_LineOffsets(std::move(Other.m_LineOffsets)),
+            m_LineCount(Other.m_LineCount)
+        {
+            Other.m_LineCount = 0;
+        }
+
+        /**
+         * @brief Assigns a value to the batch.
+         * @param Other Another batch to assign to the batch.
+         * @return A reference to the batch.
+        */
+        BasicCommandArgumentBatch& operator=(
+            BasicCommandArgumentBatch&& Other) noexcept
+        {
+            if (this != &Other)
+            {
+                this->m_Arena = std::move(Other.m_Arena);
+                this->m_ArgumentOffsets = std::move(Other.m_ArgumentOffsets);
+                this->m_LineOffsets = std::move(Other.m_LineOffsets);
+                this->m_LineCount = Other.m_LineCount;
+                Other.m_LineCount = 0;
+            }
+
+            return *this;
+        }
+
+        /**
+         * @brief Returns the number of the lines.
+         * @return The number of the lines.
+        */
+        std::size_t LineCount() const noexcept
+        {
+            return this->m_LineCount;
+        }
+
+        /**
+         * @brief Returns the number of the arguments of all lines.
+         * @return The number of the arguments of all lines.
+        */
+        std::size_t ArgumentCount() const noexcept
+        {
+            return this->m_LineCount
+                ? this->m_LineOffsets[this->m_LineCount]
+                : 0;
+        }
+
+        /**
+         * @brief Returns the number of the arguments of the line.
+         * @param Line The index of the line.
+         * @return The number of the arguments of the line.
+        */
+        std::size_t ArgumentCount(
+            std::size_t Line) const noexcept
+        {
+            return this->m_LineOffsets[Line + 1] - this->m_LineOffsets[Line];
+        }
+
+        /**
+         * @brief Returns the argument of the line.
+         * @param Line The index of the line.
+         * @param Index The index of the argument in the line.
+         * @return The argument of the line.
+        */
+        StringSpanType Argument(
+            std::size_t Line,
+            std::size_t Index) const noexcept
+        {
+            std::size_t ArgumentIndex = this->m_LineOffsets[Line] + Index;
+            std::size_t Offset = this->m_ArgumentOffsets[ArgumentIndex];
+            return StringSpanType(
+                this->m_Arena.get() + Offset,
+                this->m_ArgumentOffsets[ArgumentIndex + 1] - Offset - 1);
+        }
+
+        /**
+         * @brief Returns the character arena of the unescaped arguments.
+         * @return The character arena of the unescaped arguments.
+        */
+        CharType const* Arena() const noexcept
+        {
+            return this->m_Arena.get();
+        }
+
+        /**
+         * @brief Returns the offsets of the arguments in the arena, which has
+         *        ArgumentCount() + 1 elements and the last one is the size of
+         *        the arena.
+         * @return The offsets of the arguments in the arena.
+        */
+        std::size_t const* ArgumentOffsets() const noexcept
+        {
+            return this->m_ArgumentOffsets.get();
+        }
+
+        /**
+         * @brief Returns the indices of the first arguments of the lines,
+         *        which has LineCount() + 1 elements and the last one is the
+         *        number of the arguments.
+         * @return The indices of the first arguments of the lines.
+        */
+        std::size_t const* LineOffsets() const noexcept
+        {
+            return this->m_LineOffsets.get();
+        }
+    };
+
+    /**
+     * @brief The template for defining the options and parameters parsed from
+     *        a command line. The application name, the options, the
+     *        parameters and the unresolved command line are stored in a single
+     *        buffer owned by the object, and the options are kept in a flat
+     *        array sorted by the case-insensitive option names.
+     * @tparam CharType The character type of the command line.
+    */
+    template<typename CharType>
+    class BasicCommandLineOptions
+    {
+        static_assert(
+            IsCommandLineCharType<CharType>::value,
+            "The command line templates are not instantiated for the "
+            "character type, see Mile::IsCommandLineCharType.");
+
+    public:
+
+        /**
+         * @brief The string span type of the command line.
+        */
+        using StringSpanType = BasicStringSpan<CharType>;
+
+        /**
+         * @brief The option name and parameter pair type.
+        */
+        using EntryType = std::pair<StringSpanType, StringSpanType>;
+
+    private:
+
+        /**
+         * @brief The buffer which contains all strings of the object.
+        */
+        std::unique_ptr<CharType[]> m_Buffer;
+
+        /**
+         * @brief The application name.
+        */
+        StringSpanType m_ApplicationName;
+
+        /**
+         * @brief The options and parameters sorted by the case-insensitive
+         *        option names.
+        */
+        std::vector<EntryType> m_Options;
+
+        /**
+         * @brief The unresolved command line.
+        */
+        StringSpanType m_UnresolvedCommandLine;
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the empty options.
+        */
+        BasicCommandLineOptions() noexcept = default;
+
+        /**
+         * @brief Initializes a new instance of the options.
+         * @param Buffer The buffer which contains all strings of the object.
+         * @param ApplicationName The application name.
+         * @param Options The options and parameters sorted by the
+         *                case-insensitive option names, and each option name
+         *                should be unique.
+         * @param UnresolvedCommandLine The unresolved command line.
+        */
+        BasicCommandLineOptions(
+            std::unique_ptr<CharType[]>&& Buffer,
+            StringSpanType const& ApplicationName,
+            std::vector<EntryType>&& Options,
+            StringSpanType const& UnresolvedCommandLine) noexcept :
+            m_Buffer(std::move(Buffer)),
+            m_ApplicationName(ApplicationName),
+            m_Options(std::move(Options)),
+            m_UnresolvedCommandLine(UnresolvedCommandLine)
+        {
+        }
+
+        /**
+         * @brief Returns the application name.
+         * @return The application name.
+        */
+        StringSpanType const& ApplicationName() const noexcept
+        {
+            return this->m_ApplicationName;
+        }
+
+        /**
+         * @brief Returns the unresolved command line.
+         * @return The unresolved command line.
+        */
+        StringSpanType const& UnresolvedCommandLine() const noexcept
+        {
+            return this->m_UnresolvedCommandLine;
+        }
+
+        /**
+         * @brief Returns the number of the options.
+         * @return The number of the options.
+        */
+        std::size_t Count() const noexcept
+        {
+            return this->m_Options.size();
+        }
+
+        /**
+         * @brief Returns the pointer to the first option.
+         * @return The pointer to the first option.
+        */
+        EntryType const* begin() const noexcept
+        {
+            return this->m_Options.data();
+        }
+
+        /**
+         * @brief Returns the pointer to the option following the last option.
+         * @return The pointer to the option following the last option.
+        */
+        EntryType const* end() const noexcept
+        {
+            return this->m_Options.data() + this->m_Options.size();
+        }
+
+        /**
+         * @brief Finds the parameter of an option, the option name comparison
+         *        is case-insensitive for ASCII letters.
+         * @param Name The option name.
+         * @return The pointer to the parameter of the option if found,
+         *         otherwise nullptr.
+        */
+        StringSpanType const* Find(
+            StringSpanType const& Name) const noexcept;
+
+        /**
+         * @brief Checks whether an option exists, the option name comparison
+         *        is case-insensitive for ASCII letters.
+         * @param Name The option name.
+         * @return true if the option exists, otherwise false.
+        */
+        bool Contains(
+            StringSpanType const& Name) const noexcept
+        {
+            return nullptr != this->Find(Name);
+        }
+    };
+
+    /**
+     * @brief The options and parameters parsed from a command line of wide
+     *        characters.
+    */
+    using CommandLineOptions = BasicCommandLineOptions<wchar_t>;
+
+    /**
+     * @brief Parses a command line string and get more friendly result.
+     * @param CommandLine A string that contains the full command line. If this
+     *                    parameter is an empty string the function returns an
+     *                    array with only one empty string.
+     * @param OptionPrefixes One or more of the prefixes of option we want to
+     *                       use.
+     * @param OptionParameterSeparators One or more of the separators of option
+     *                                  we want to use.
+     * @param ApplicationName The application name.
+     * @param OptionsAndParameters The options and parameters.
+     * @param UnresolvedCommandLine The unresolved command line.
+    */
+    void SpiltCommandLineEx(
+        std::wstring const& CommandLine,
+        std::vector<std::wstring> const& OptionPrefixes,
+        std::vector<std::wstring> const& OptionParameterSeparators,
+        std::wstring& ApplicationName,
+        std::map<std::wstring, std::wstring>& OptionsAndParameters,
+        std::wstring& UnresolvedCommandLine);
+
+    /**
+     * @brief Parses a command line string and get more friendly result.
+     * @tparam CharType The character type of the command line, which can be
+     *                  char, char8_t, char16_t or wchar_t.
+     * @param CommandLine A string that contains the full command line.
+     * @param OptionPrefixes One or more of the prefixes of option we want to
+     *                       use.
+     * @param OptionParameterSeparators One or more of the separators of option
+     *                                  we want to use.
+     * @param ApplicationName The application name.
+     * @param OptionsAndParameters The options and parameters.
+     * @param UnresolvedCommandLine The unresolved command line.
+    */
+    template<typename CharType>
+    void SpiltCommandLineEx(
+        std::basic_string<CharType> const& CommandLine,
+        std::vector<std::basic_string<CharType>> const& OptionPrefixes,
+        std::vector<std::basic_string<CharType>> const&
+            OptionParameterSeparators,
+        std::basic_string<CharType>& ApplicationName,
+        std::map<std::basic_string<CharType>, std::basic_string<CharType>>&
+            OptionsAndParameters,
+        std::basic_string<CharType>& UnresolvedCommandLine);
+
+    /**
+     * @brief Parses a command line string and get more friendly result. This
+     *        function stops parsing at the first non-option argument, and
+     *        only makes a few allocations for the result.
+     * @tparam CharType The character type of the command line, which can be
+     *                  char, char8_t, char16_t or wchar_t.
+     * @param CommandLine A string that contains the full command line.
+     * @param OptionPrefixes One or more of the prefixes of option we want to
+     *                       use.
+     * @param OptionParameterSeparators One or more of the separators of option
+     *                                  we want to use.
+     * @return The application name, the options and parameters, and the
+     *         unresolved command line. If an option is specified more than
+     *         once, the last one is kept.
+    */
+    template<typename CharType>
+    BasicCommandLineOptions<CharType> SpiltCommandLineEx(
+        std::basic_string<CharType> const& CommandLine,
+        std::vector<std::basic_string<CharType>> const& OptionPrefixes,
+        std::vector<std::basic_string<CharType>> const&
+            OptionParameterSeparators);
+
+    /**
+     * @brief Parses a command line string and get more friendly result. This
+     *        function stops parsing at the first non-option argument, and
+     *        only makes a few allocations for the result.
+     * @tparam CharType The character type of the command line, which can be
+     *                  char, char8_t, char16_t or wchar_t.
+     * @param CommandLine A string that contains the full command line.
+     * @param OptionPrefixes An array of the null-terminated prefixes of option
+     *                       we want to use.
+     * @param OptionPrefixCount The number of the prefixes of option.
+     * @param OptionParameterSeparators An array of the null-terminated
+     *                                  separators of option we want to use.
+     * @param OptionParameterSeparatorCount The number of the separators of
+     *                                      option.
+     * @return The application name, the options and parameters, and the
+     *         unresolved command line. If an option is specified more than
+     *         once, the last one is kept.
+    */
+    template<typename CharType>
+    BasicCommandLineOptions<CharType> SpiltCommandLineEx(
+        BasicStringSpan<CharType> const& CommandLine,
+        CharType const* const* OptionPrefixes,
+        std::size_t OptionPrefixCount,
+        CharType const* const* OptionParameterSeparators,
+        std::size_t OptionParameterSeparatorCount);
+
+    /**
+     * @brief Parses a command arguments string and returns an array of the
+     *        command arguments, along with a count of such arguments, in a way
+     *        that is similar to the standard C run-time.
+     * @param Arguments A string that contains the full command arguments. If
+     *                  this parameter is an empty string the function returns
+     *                  an array with only one empty string.
+     * @return An array of the command arguments, along with a count of such
+     *         arguments.
+    */
+    std::vector<std::wstring> SpiltCommandArguments(
+        std::wstring const& Arguments);
+
+    /**
+     * @brief Parses a command arguments string and returns an array of the
+     *        command arguments, along with a count of such arguments, in a way
+     *        that is similar to the standard C run-time.
+     * @tparam CharType The character type of the command arguments, which can
+     *                  be char, char8_t, char16_t or wchar_t.
+     * @param Arguments A string that contains the full command arguments.
+     * @return An array of the command arguments, along with a count of such
+     *         arguments.
+    */
+    template<typename CharType>
+    std::vector<std::basic_string<CharType>> SpiltCommandArguments(
+        std::basic_string<CharType> const& Arguments);
+
+    /**
+     * @brief Parses a command arguments string and returns an array of the
+     *        command arguments in a way that is similar to the standard C
+     *        run-time. All arguments are unescaped into a single allocation
+     *        which is owned by the returned object.
+     * @tparam CharType The character type of the command arguments, which can
+     *                  be char, char8_t, char16_t or wchar_t.
+     * @param Arguments The pointer to the command arguments string.
+     * @param Length The length of the command arguments string. The parsing
+     *               will also stop at the first null character.
+     * @return An array of the command arguments.
+    */
+    template<typename CharType>
+    BasicCommandArgumentSpans<CharType> SpiltCommandArgumentsToSpans(
+        CharType const* Arguments,
+        std::size_t Length);
+
+    /**
+     * @brief Parses a command arguments string and returns an array of the
+     *        command arguments in a way that is similar to the standard C
+     *        run-time. All arguments are unescaped into a single allocation
+     *        which is owned by the returned object.
+     * @tparam CharType The character type of the command arguments, which can
+     *                  be char, char8_t, char16_t or wchar_t.
+     * @param Arguments A string that contains the full command arguments.
+     * @return An array of the command arguments.
+    */
+    template<typename CharType>
+    BasicCommandArgumentSpans<CharType> SpiltCommandArgumentsToSpans(
+        std::basic_string<CharType> const& Arguments)
+    {
+        return SpiltCommandArgumentsToSpans(
+            Arguments.c_str(),
+            Arguments.size());
+    }
+
+    /**
+     * @brief Parses a batch of command arguments strings in parallel, in a way
+     *        that is similar to SpiltCommandArguments. The lines are split
+     *        into the chunks of at least 256K characters, which are parsed by
+     *        the calling thread and a pool of the worker threads. The worker
+     *        threads are created on the first use and kept for reuse.
+     * @tparam CharType The character type of the command arguments, which can
+     *                  be char, char8_t, char16_t or wchar_t.
+     * @param CommandLines The pointer to the command arguments strings.
+     * @param Count The number of the command arguments strings.
+     * @param ThreadCount The number of the threads for parsing, or 0 for the
+     *                    number of the hardware threads.
+     * @return The command arguments of all command lines in the columnar
+     *         layout.
+    */
+    template<typename CharType>
+    BasicCommandArgumentBatch<CharType> SpiltCommandArgumentsInBatch(
+        BasicStringSpan<CharType> const* CommandLines,
+        std::size_t Count,
+        std::size_t ThreadCount = 0);
+
+    /**
+     * @brief Builds a command line string from the command arguments, which
+     *        is the inverse of SpiltCommandArguments. The arguments are
+     *        quoted only if they are empty or contain spaces or tabs, and the
+     *        quotes and backslashes are escaped with the rules of the standard
+     *        C run-time.
+     * @tparam CharType The character type of the command arguments, which can
+     *                  be char, char8_t, char16_t or wchar_t.
+     * @param Arguments The pointer to the command arguments.
+     * @param Count The number of the command arguments.
+     * @param Buffer The buffer which receives the null-terminated command
+     *               line, can be nullptr if BufferLength is 0.
+     * @param BufferLength The length of the buffer in characters.
+     * @return The length of the command line, not including the terminating
+     *         null character. If the buffer is not large enough for the
+     *         command line and the terminating null character, nothing is
+     *         written to the buffer.
+    */
+    template<typename CharType>
+    std::size_t BuildCommandLine(
+        BasicStringSpan<CharType> const* Arguments,
+        std::size_t Count,
+        CharType* Buffer,
+        std::size_t BufferLength);
+
+    /**
+     * @brief Builds a command line string from the command arguments, which
+     *        is the inverse of SpiltCommandArguments.
+     * @tparam CharType The character type of the command arguments, which can
+     *                  be char, char8_t, char16_t or wchar_t.
+     * @param Arguments The pointer to the command arguments.
+     * @param Count The number of the command arguments.
+     * @return The command line string.
+    */
+    template<typename CharType>
+    std::basic_string<CharType> BuildCommandLine(
+        BasicStringSpan<CharType> const* Arguments,
+        std::size_t Count);
+
+    /**
+     * @brief Builds a command line string from the command arguments, which
+     *        is the inverse of SpiltCommandArguments.
+     * @param Arguments An array of the command arguments.
+     * @return The command line string.
+    */
+    std::wstring BuildCommandLine(
+        std::vector<std::wstring> const& Arguments);
+
+    /**
+     * @brief Builds a command line string from the command arguments, which
+     *        is the inverse of SpiltCommandArguments.
+     * @tparam CharType The character type of the command arguments, which can
+     *                  be char, char8_t, char16_t or wchar_t.
+     * @param Arguments An array of the command arguments.
+     * @return The command line string.
+    */
+    template<typename CharType>
+    std::basic_string<CharType> BuildCommandLine(
+        std::vector<std::basic_string<CharType>> const& Arguments);
+
+    /**
+     * @brief Parses a command arguments string like SpiltCommandArguments,
+     *        and expands the response files which are referenced by the
+     *        arguments starting with @. The response files are memory-mapped
+     *        and tokenized line by line with the same quoting rules, and the
+     *        arguments are passed to the callback one by one, so the whole
+     *        expanded argument list is never held in memory.
+     * @tparam CharType The character type of the command arguments, which can
+     *                  be char, char8_t, char16_t or wchar_t. The narrow
+     *                  strings are treated as UTF-8.
+     * @param Arguments A string that contains the command arguments.
+     * @param Callback The callback which receives the arguments. The argument
+     *                 is only valid during the call.
+     * @param MaximumDepth The maximum nesting depth of the response files.
+     * @return true if successful, or false if a response file cannot be read
+     *         or the nesting depth exceeds the limit. The arguments before
+     *         the failure have already been passed to the callback.
+     * @remark The response file is UTF-16LE if it starts with the UTF-16LE
+     *         BOM, otherwise it is UTF-8 with an optional BOM. The relative
+     *         paths of the response files are resolved against the current
+     *         directory.
+    */
+    template<typename CharType>
+    bool ExpandCommandArguments(
+        BasicStringSpan<CharType> const& Arguments,
+        std::function<void(BasicStringSpan<CharType> const&)> const& Callback,
+        std::size_t MaximumDepth = 8);
+
+    /**
+     * @brief Parses a flag value of the command line option. The accepted
+     *        values are 1, true, on, yes, 0, false, off and no, and the
+     *        comparison is case-insensitive for ASCII letters.
+     * @tparam CharType The character type of the value.
+     * @param Value The value to parse.
+     * @param Result The parsed flag value.
+     * @return true if successful, otherwise false.
+    */
+    template<typename CharType>
+    bool ParseCommandLineFlag(
+        BasicStringSpan<CharType> const& Value,
+        bool& Result);
+
+    /**
+     * @brief Parses a signed integer value of the command line option. The
+     *        value can be in decimal, or in hexadecimal with the 0x prefix.
+     * @tparam CharType The character type of the value.
+     * @param Value The value to parse.
+     * @param Result The parsed integer value.
+     * @return true if successful, otherwise false.
+    */
+    template<typename CharType>
+    bool ParseCommandLineInteger(
+        BasicStringSpan<CharType> const& Value,
+        std::int64_t& Result);
+
+    /**
+     * @brief Parses a byte size value of the command line option. The value
+     *        is a decimal number followed by an optional unit, which can be
+     *        B, K, KB, KiB, M, MB, MiB, G, GB, GiB, T, TB, TiB, P, PB or PiB,
+     *        all units are binary multiples and the comparison is
+     *        case-insensitive for ASCII letters.
+     * @tparam CharType The character type of the value.
+     * @param Value The value to parse.
+     * @param Result The parsed byte size value.
+     * @return true if successful, otherwise false.
+    */
+    template<typename CharType>
+    bool ParseCommandLineByteSize(
+        BasicStringSpan<CharType> const& Value,
+        std::uint64_t& Result);
+
+/**
+ * @brief Expands to the explicit instantiations of the command line
+ *        templates for a character type. Mile.Portable.cpp defines them, and
+ *        the other translation units declare them with the extern prefix.
+ * @param Prefix The prefix of the explicit instantiations, which is extern
+ *               for the declarations or empty for the definitions.
+ * @param CharType The character type.
+*/
+#define MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(Prefix, CharType) \
+    Prefix template class BasicCommandLineOptions<CharType>; \
+    Prefix template class BasicCommandArgumentRange<CharType>; \
+    Prefix template std::size_t BuildCommandLine<CharType>( \
+        BasicStringSpan<CharType> const*, \
+        std::size_t, \
+        CharType*, \
+        std::size_t); \
+    Prefix template std::basic_string<CharType> BuildCommandLine<CharType>( \
+        BasicStringSpan<CharType> const*, \
+        std::size_t); \
+    Prefix template std::basic_string<CharType> BuildCommandLine<CharType>( \
+        std::vector<std::basic_string<CharType>> const&); \
+    Prefix template BasicCommandArgumentBatch<CharType> \
+    SpiltCommandArgumentsInBatch<CharType>( \
+        BasicStringSpan<CharType> const*, \
+        std::size_t, \
+        std::size_t); \
+    Prefix template void SpiltCommandLineEx<CharType>( \
+        std::basic_string<CharType> const&, \
+        std::vector<std::basic_string<CharType>> const&, \
+        std::vector<std::basic_string<CharType>> const&, \
+        std::basic_string<CharType>&, \
+        std::map<std::basic_string<CharType>, std::basic_string<CharType>>&, \
+        std::basic_string<CharType>&); \
+    Prefix template BasicCommandLineOptions<CharType> \
+    SpiltCommandLineEx<CharType>( \
+        std::basic_string<CharType> const&, \
+        std::vector<std::basic_string<CharType>> const&, \
+        std::vector<std::basic_string<CharType>> const&); \
+    Prefix template std::vector<std::basic_string<CharType>> \
+    SpiltCommandArguments<CharType>( \
+        std::basic_string<CharType> const&); \
+    Prefix template BasicCommandArgumentSpans<CharType> \
+    SpiltCommandArgumentsToSpans<CharType>( \
+        CharType const*, \
+        std::size_t); \
+    Prefix template BasicCommandLineOptions<CharType> \
+    SpiltCommandLineEx<CharType>( \
+        BasicStringSpan<CharType> const&, \
+        CharType const* const*, \
+        std::size_t, \
+        CharType const* const*, \
+        std::size_t); \
+    Prefix template bool ParseCommandLineFlag<CharType>( \
+        BasicStringSpan<CharType> const&, \
+        bool&); \
+    Prefix template bool ParseCommandLineInteger<CharType>( \
+        BasicStringSpan<CharType> const&, \
+        std::int64_t&); \
+    Prefix template bool ParseCommandLineByteSize<CharType>( \
+        BasicStringSpan<CharType> const&, \
+        std::uint64_t&); \
+    Prefix template bool ExpandCommandArguments<CharType>( \
+        BasicStringSpan<CharType> const&, \
+        std::function<void(BasicStringSpan<CharType> const&)> const&, \
+        std::size_t);
+
+    MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(extern, char)
+    MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(extern, wchar_t)
+    MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(extern, char16_t)
+#if defined(MILE_PORTABLE_ENABLE_CHAR8_T)
+    MILE_PORTABLE_COMMAND_LINE_INSTANTIATIONS(extern, char8_t)
+#endif
+
+#if defined(__cpp_char8_t) && !defined(MILE_PORTABLE_ENABLE_CHAR8_T)
+    // The function templates which do not return the class templates checked
+    // by IsCommandLineCharType are deleted for char8_t, so using them is a
+    // compile error instead of a link error.
+
+    template<>
+    std::size_t BuildCommandLine<char8_t>(
+        BasicStringSpan<char8_t> const* Arguments,
+        std::size_t Count,
+        char8_t* Buffer,
+        std::size_t BufferLength) = delete;
+
+    template<>
+    std::u8string BuildCommandLine<char8_t>(
+        BasicStringSpan<char8_t> const* Arguments,
+        std::size_t Count) = delete;
+
+    template<>
+    std::u8string BuildCommandLine<char8_t>(
+        std::vector<std::u8string> const& Arguments) = delete;
+
+    template<>
+    void SpiltCommandLineEx<char8_t>(
+        std::u8string const& CommandLine,
+        std::vector<std::u8string> const& OptionPrefixes,
+        std::vector<std::u8string> const& OptionParameterSeparators,
+        std::u8string& ApplicationName,
+        std::map<std::u8string, std::u8string>& OptionsAndParameters,
+        std::u8string& UnresolvedCommandLine) = delete;
+
+    template<>
+    std::vector<std::u8string> SpiltCommandArguments<char8_t>(
+        std::u8string const& Arguments) = delete;
+
+    template<>
+    bool ParseCommandLineFlag<char8_t>(
+        BasicStringSpan<char8_t> const& Value,
+        bool& Result) = delete;
+
+    template<>
+    bool ParseCommandLineInteger<char8_t>(
+        BasicStringSpan<char8_t> const& Value,
+        std::int64_t& Result) = delete;
+
+    template<>
+    bool ParseCommandLineByteSize<char8_t>(
+        BasicStringSpan<char8_t> const& Value,
+        std::uint64_t& Result) = delete;
+
+    template<>
+    bool ExpandCommandArguments<char8_t>(
+        BasicStringSpan<char8_t> const& Arguments,
+        std::function<void(BasicStringSpan<char8_t> const&)> const& Callback,
+        std::size_t MaximumDepth) = delete;
+#endif
+
+    /**
+     * @brief The value types of the command line options.
+    */
+    enum class CommandLineOptionType
+    {
+        Flag,
+        Integer,
+        ByteSize,
+        String,
+    };
+
+    /**
+     * @brief Computes the hash of an option name at compile time if possible,
+     *        the hash is case-insensitive for ASCII letters.
+     * @tparam CharType The character type of the option name.
+     * @param Name The pointer to the option name.
+     * @param Length The length of the option name.
+     * @return The FNV-1a hash of the ASCII lower case option name.
+    */
+    template<typename CharType>
+    constexpr std::uint32_t HashCommandLineOptionName(
+        CharType const* Name,
+        std::size_t Length) noexcept
+    {
+        std::uint32_t Hash = 2166136261u;
+        for (std::size_t i = 0; i < Length; ++i)
+        {
+            std::uint32_t Character = static_cast<std::uint32_t>(
+                static_cast<typename std::make_unsigned<CharType>::type>(
+                    Name[i]));
+            if (Character >= 'A' && Character <= 'Z')
+            {
+                Character += 'a' - 'A';
+            }
+            Hash = (Hash ^ Character) * 16777619u;
+        }
+        return Hash;
+    }
+
+    /**
+     * @brief The template for defining the command line options which are
+     *        parsed into the member of a user-defined structure. Define
+     *        another option for the same member to add an alias.
+     * @tparam StructType The structure type which receives the options.
+     * @tparam CharType The character type of the command line.
+    */
+    template<typename StructType, typename CharType>
+    class CommandLineOptionDefinition
+    {
+    private:
+
+        static constexpr std::size_t GetLength(
+            CharType const* Value) noexcept
+        {
+            std::size_t Length = 0;
+            while (Value[Length])
+            {
+                ++Length;
+            }
+            return Length;
+        }
+
+    public:
+
+        /**
+         * @brief The option name.
+        */
+        CharType const* Name;
+
+        /**
+         * @brief The length of the option name.
+        */
+        std::size_t NameLength;
+
+        /**
+         * @brief The case-insensitive hash of the option name.
+        */
+        std::uint32_t NameHash;
+
+        /**
+         * @brief The value type of the option.
+        */
+        CommandLineOptionType Type;
+
+        /**
+         * @brief The member which receives the option if the type is Flag.
+        */
+        bool StructType::* FlagMember;
+
+        /**
+         * @brief The member which receives the option if the type is Integer.
+        */
+        std::int64_t StructType::* IntegerMember;
+
+        /**
+         * @brief The member which receives the option if the type is
+         *        ByteSize.
+        */
+        std::uint64_t StructType::* ByteSizeMember;
+
+        /**
+         * @brief The member which receives the option if the type is String.
+        */
+        std::basic_string<CharType> StructType::* StringMember;
+
+        /**
+         * @brief The default value of the option, or nullptr if the member
+         *        should be kept as is when the option is not specified.
+        */
+        CharType const* DefaultValue;
+
+    public:
+
+        /**
+         * @brief Defines a flag option.
+         * @param OptionName The option name.
+         * @param Member The member which receives the option.
+         * @param OptionDefaultValue The default value of the option.
+        */
+        constexpr CommandLineOptionDefinition(
+            CharType const* OptionName,
+            bool StructType::* Member,
+            CharType const* OptionDefaultValue = nullptr) noexcept :
+            Name(OptionName),
+            NameLength(GetLength(OptionName)),
+            NameHash(HashCommandLineOptionName(
+                OptionName,
+                GetLength(OptionName))),
+            Type(CommandLineOptionType::Flag),
+            FlagMember(Member),
+            IntegerMember(nullptr),
+            ByteSizeMember(nullptr),
+            StringMember(nullptr),
+            DefaultValue(OptionDefaultValue)
+        {
+        }
+
+        /**
+         * @brief Defines an integer option.
+         * @param OptionName The option name.
+         * @param Member The member which receives the option.
+         * @param OptionDefaultValue The default value of the option.
+        */
+        constexpr CommandLineOptionDefinition(
+            CharType const* OptionName,
+            std::int64_t StructType::* Member,
+            CharType const* OptionDefaultValue = nullptr) noexcept :
+            Name(OptionName),
+            NameLength(GetLength(OptionName)),
+            NameHash(HashCommandLineOptionName(
+                OptionName,
+                GetLength(OptionName))),
+            Type(CommandLineOptionType::Integer),
+            FlagMember(nullptr),
+            IntegerMember(Member),
+            ByteSizeMember(nullptr),
+            StringMember(nullptr),
+            DefaultValue(OptionDefaultValue)
+        {
+        }
+
+        /**
+         * @brief Defines a byte size option.
+         * @param OptionName The option name.
+         * @param Member The member which receives the option.
+         * @param OptionDefaultValue The default value of the option.
+        */
+        constexpr CommandLineOptionDefinition(
+            CharType const* OptionName,
+            std::uint64_t StructType::* Member,
+            CharType const* OptionDefaultValue = nullptr) noexcept :
+            Name(OptionName),
+            NameLength(GetLength(OptionName)),
+            NameHash(HashCommandLineOptionName(
+                OptionName,
+                GetLength(OptionName))),
+            Type(CommandLineOptionType::ByteSize),
+            FlagMember(nullptr),
+            IntegerMember(nullptr),
+            ByteSizeMember(Member),
+            StringMember(nullptr),
+            DefaultValue(OptionDefaultValue)
+        {
+        }
+
+        /**
+         * @brief Defines a string option.
+         * @param OptionName The option name.
+         * @param Member The member which receives the option.
+         * @param OptionDefaultValue The default value of the option.
+        */
+        constexpr CommandLineOptionDefinition(
+            CharType const* OptionName,
+            std::basic_string<CharType> StructType::* Member,
+            CharType const* OptionDefaultValue = nullptr) noexcept :
+            Name(OptionName),
+            NameLength(GetLength(OptionName)),
+            NameHash(HashCommandLineOptionName(
+                OptionName,
+                GetLength(OptionName))),
+            Type(CommandLineOptionType::String),
+            FlagMember(nullptr),
+            IntegerMember(nullptr),
+            ByteSizeMember(nullptr),
+            StringMember(Member),
+            DefaultValue(OptionDefaultValue)
+        {
+        }
+    };
+
+    /**
+     * @brief The template for defining the command line schemas, which parse
+     *        the command line options into the members of a user-defined
+     *        structure with the typed values. The schema can be defined as a
+     *        constexpr object, so the option names are hashed at compile time
+     *        and the matching only compares the hashes in most cases.
+     * @tparam StructType The structure type which receives the options.
+     * @tparam CharType The character type of the command line.
+    */
+    template<typename StructType, typename CharType>
+    class CommandLineSchema
+    {
+    public:
+
+        /**
+         * @brief The option definition type of the schema.
+        */
+        using DefinitionType = CommandLineOptionDefinition<
+            StructType,
+            CharType>;
+
+    private:
+
+        /**
+         * @brief The option definitions.
+        */
+        DefinitionType const* m_Definitions;
+
+        /**
+         * @brief The number of the option definitions.
+        */
+        std::size_t m_DefinitionCount;
+
+        /**
+         * @brief The null-terminated prefixes of option.
+        */
+        CharType const* const* m_OptionPrefixes;
+
+        /**
+         * @brief The number of the prefixes of option.
+        */
+        std::size_t m_OptionPrefixCount;
+
+        /**
+         * @brief The null-terminated separators of option.
+        */
+        CharType const* const* m_OptionParameterSeparators;
+
+        /**
+         * @brief The number of the separators of option.
+        */
+        std::size_t m_OptionParameterSeparatorCount;
+
+        /**
+         * @brief Assigns the value to the member of the option.
+         * @param Definition The option definition.
+         * @param Value The value of the option.
+         * @param Options The structure which receives the options.
+         * @return true if successful, otherwise false.
+        */
+        static bool Assign(
+            DefinitionType const& Definition,
+            BasicStringSpan<CharType> const& Value,
+            StructType& Options)
+        {
+            switch (Definition.Type)
+            {
+            case CommandLineOptionType::Flag:
+                if (Value.Empty())
+                {
+                    Options.*Definition.FlagMember = true;
+                    return true;
+                }
+                return ParseCommandLineFlag(
+                    Value,
+                    Options.*Definition.FlagMember);
+            case CommandLineOptionType::Integer:
+                return ParseCommandLineInteger(
+                    Value,
+                    Options.*Definition.IntegerMember);
+            case CommandLineOptionType::ByteSize:
+                return ParseCommandLineByteSize(
+                    Value,
+                    Options.*Definition.ByteSizeMember);
+            case CommandLineOptionType::String:
+                Options.*Definition.StringMember = Value.ToString();
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * @brief Converts the ASCII upper case letter to lower case.
+         * @param Character The character to convert.
+         * @return The converted character.
+        */
+        static constexpr CharType ToLowerAscii(
+            CharType Character) noexcept
+        {
+            return (Character >= CharType('A') && Character <= CharType('Z'))
+                ? static_cast<CharType>(Character + ('a' - 'A'))
+                : Character;
+        }
+
+    public:
+
+        /**
+         * @brief Initializes a new instance of the command line schema.
+         * @param Definitions The option definitions.
+         * @param OptionPrefixes The null-terminated prefixes of option.
+         * @param OptionParameterSeparators The null-terminated separators of
+         *                                  option.
+        */
+        template<
+            std::size_t DefinitionCount,
+            std::size_t OptionPrefixCount,
+            std::size_t OptionParameterSeparatorCount>
+        constexpr CommandLineSchema(
+            DefinitionType const (&Definitions)[DefinitionCount],
+            CharType const* const (&OptionPrefixes)[OptionPrefixCount],
+            CharType const* const (&OptionParameterSeparators)[
+                OptionParameterSeparatorCount]) noexcept :
+            m_Definitions(Definitions),
+            m_DefinitionCount(DefinitionCount),
+            m_OptionPrefixes(OptionPrefixes),
+            m_OptionPrefixCount(OptionPrefixCount),
+            m_OptionParameterSeparators(OptionParameterSeparators),
+            m_OptionParameterSeparatorCount(OptionParameterSeparatorCount)
+        {
+        }
+
+        /**
+         * @brief Finds the option definition by the option name, the option
+         *        name comparison is case-insensitive for ASCII letters.
+         * @param Name The option name.
+         * @return The pointer to the option definition if found, otherwise
+         *         nullptr.
+        */
+        DefinitionType const* Find(
+            BasicStringSpan<CharType> const& Name) const noexcept
+        {
+            std::uint32_t NameHash = HashCommandLineOptionName(
+                Name.Data(),
+                Name.Size());
+
+            for (std::size_t i = 0; i < this->m_DefinitionCount; ++i)
+            {
+                DefinitionType const& Definition = this->m_Definitions[i];
+                if (Definition.NameHash != NameHash ||
+                    Definition.NameLength != Name.Size())
+                {
+                    continue;
+                }
+
+                std::size_t Index = 0;
+                for (; Index < Name.Size(); ++Index)
+                {
+                    if (ToLowerAscii(Definition.Name[Index]) !=
+                        ToLowerAscii(Name[Index]))
+                    {
+                        break;
+                    }
+                }
+                if (Index == Name.Size())
+                {
+                    return &Definition;
+                }
+            }
+
+            return nullptr;
+        }
+
+        /**
+         * @brief Assigns the default values to the members of the options
+         *        which have the default values.
+         * @param Options The structure which receives the options.
+         * @return true if successful, otherwise false.
+        */
+        bool ApplyDefaults(
+            StructType& Options) const
+        {
+            for (std::size_t i = 0; i < this->m_DefinitionCount; ++i)
+            {
+                DefinitionType const& Definition = this->m_Definitions[i];
+                if (!Definition.DefaultValue)
+                {
+                    continue;
+                }
+
+                if (!Assign(
+                    Definition,
+                    BasicStringSpan<CharType>(
+                        Definition.DefaultValue,
+                        std::char_traits<CharType>::length(
+                            Definition.DefaultValue)),
+                    Options))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Parses a command line string into the structure. The default
+         *        values are assigned before parsing, and the parsing stops at
+         *        the first non-option argument.
+         * @param CommandLine A string that contains the full command line.
+         * @param Options The structure which receives the options.
+         * @param UnresolvedCommandLine The optional string which receives the
+         *                              unresolved command line.
+         * @return true if successful, or false if there is an unknown option
+         *         or an invalid value.
+        */
+        bool Parse(
+            BasicStringSpan<CharType> const& CommandLine,
+            StructType& Options,
+            std::basic_string<CharType>* UnresolvedCommandLine = nullptr) const
+        {
+            if (!this->ApplyDefaults(Options))
+            {
+                return false;
+            }
+
+            BasicCommandLineOptions<CharType> Result = SpiltCommandLineEx(
+                CommandLine,
+                this->m_OptionPrefixes,
+                this->m_OptionPrefixCount,
+                this->m_OptionParameterSeparators,
+                this->m_OptionParameterSeparatorCount);
+
+            for (auto const& Option : Result)
+            {
+                DefinitionType const* Definition = this->Find(Option.first);
+                if (!Definition || !Assign(*Definition, Option.second, Options))
+                {
+                    return false;
+                }
+            }
+
+            if (UnresolvedCommandLine)
+            {
+                *UnresolvedCommandLine =
+                    Result.UnresolvedCommandLine().ToString();
+            }
+
+            return true;
+        }
+    };
 }
 
 #endif // !MILE_PORTABLE
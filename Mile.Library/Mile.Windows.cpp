@@ -12,10 +12,6 @@
 
 #include <strsafe.h>
 
-#if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP | WINAPI_PARTITION_SYSTEM)
-#include <VersionHelpers.h>
-#endif
-
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP | WINAPI_PARTITION_SYSTEM)
 #include <WtsApi32.h>
 #pragma comment(lib, "WtsApi32.lib")
@@ -99,34 +95,20 @@ Mile::HResult Mile::SetCompactOsDeploymentState(
 BOOL Mile::EnableChildWindowDpiMessage(
     _In_ HWND WindowHandle)
 {
-    // This hack is only for Windows 10 only.
-    if (!::IsWindowsVersionOrGreater(10, 0, 0))
-    {
-        return FALSE;
-    }
-
-    // We don't need this hack if the Per Monitor Aware V2 is existed.
-    OSVERSIONINFOEXW OSVersionInfoEx = { 0 };
-    OSVersionInfoEx.dwOSVersionInfoSize = sizeof(OSVERSIONINFOEXW);
-    OSVersionInfoEx.dwBuildNumber = 14393;
-    if (::VerifyVersionInfoW(
-        &OSVersionInfoEx,
-        VER_BUILDNUMBER,
-        ::VerSetConditionMask(0, VER_BUILDNUMBER, VER_GREATER_EQUAL)))
+    // This hack is only for Windows 10, and we don't need it if the Per
+    // Monitor Aware V2 is existed since Windows 10 Version 1607.
+    Mile::PlatformInfo const& PlatformInfo = Mile::GetPlatformInfo();
+    bool IsHackNeeded =
+        PlatformInfo.MajorVersion >= 10 &&
+        PlatformInfo.BuildNumber < 14393;
+    if (!IsHackNeeded)
     {
         return FALSE;
     }
 
-    HMODULE ModuleHandle = ::GetModuleHandleW(L"user32.dll");
-    if (!ModuleHandle)
-    {
-        return FALSE;
-    }
-
-    typedef BOOL(WINAPI* ProcType)(HWND, BOOL);
-
-    ProcType ProcAddress = reinterpret_cast<ProcType>(
-        ::GetProcAddress(ModuleHandle, "EnableChildWindowDpiMessage"));
+    static const Mile::LazyProc<BOOL WINAPI(HWND, BOOL)> ProcAddress(
+        "user32.dll",
+        "EnableChildWindowDpiMessage");
     if (!ProcAddress)
     {
         return FALSE;
@@ -145,35 +127,15 @@ Mile::HResult Mile::GetDpiForMonitor(
     _Out_ UINT* dpiX,
     _Out_ UINT* dpiY)
 {
-    Mile::HResult hr = S_OK;
-
-    HMODULE ModuleHandle = ::LoadLibraryExW(
-        L"SHCore.dll",
-        nullptr,
-        LOAD_LIBRARY_SEARCH_SYSTEM32);
-    if (ModuleHandle)
-    {
-        using ProcType = decltype(::GetDpiForMonitor)*;
-
-        ProcType ProcAddress = reinterpret_cast<ProcType>(
-            ::GetProcAddress(ModuleHandle, "GetDpiForMonitor"));
-        if (ProcAddress)
-        {
-            hr = ProcAddress(hMonitor, dpiType, dpiX, dpiY);
-        }
-        else
-        {
-            hr = Mile::HResultFromLastError(FALSE);
-        }
-
-        ::FreeLibrary(ModuleHandle);
-    }
-    else
+    static const Mile::LazyProc<decltype(::GetDpiForMonitor)> ProcAddress(
+        "SHCore.dll",
+        "GetDpiForMonitor");
+    if (!ProcAddress)
     {
-        hr = Mile::HResultFromLastError(FALSE);
+        return Mile::HResult::FromWin32(ERROR_PROC_NOT_FOUND);
     }
 
-    return hr;
+    return ProcAddress(hMonitor, dpiType, dpiX, dpiY);
 }
 
 #endif
@@ -377,13 +339,20 @@ Mile::HResultFromLastError Mile::GetTokenInformationWithMemory(
         *OutputInformation = ::MileAllocateMemory(Length);
         if (*OutputInformation)
         {
+            DWORD AllocatedLength = Length;
             Result = ::GetTokenInformation(
                 TokenHandle,
                 TokenInformationClass,
                 *OutputInformation,
                 Length,
                 &Length);
-            if (!Result)
+            if (Result)
+            {
+                MILE_ACCOUNT_HANDED_OFF_ALLOCATION(
+                    "Mile.GetTokenInformationWithMemory",
+                    AllocatedLength);
+            }
+            else
             {
                 ::MileFreeMemory(*OutputInformation);
                 *OutputInformation = nullptr;
@@ -398,12 +367,71 @@ Mile::HResultFromLastError Mile::GetTokenInformationWithMemory(
     return Result;
 }
 
+Mile::HResultFromLastError Mile::GetTokenInformationWithMemory(
+    _In_ HANDLE TokenHandle,
+    _In_ TOKEN_INFORMATION_CLASS TokenInformationClass,
+    _Out_ PVOID* OutputInformation,
+    _Inout_ Mile::ScopedArena& Arena)
+{
+    if (!OutputInformation)
+    {
+        ::SetLastError(ERROR_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    // The token information usually fits in 256 bytes, so the buffer is filled
+    // directly without probing the size first. It cannot be filled in a stack
+    // buffer and copied, because some information classes contain pointers to
+    // the buffer itself.
+    DWORD Error = ERROR_NOT_ENOUGH_MEMORY;
+
+    std::size_t Length = 0;
+    *OutputInformation = Mile::ProbeAndFill<unsigned char>(
+        Arena,
+        256,
+        [&](unsigned char* Buffer, std::size_t& Size) -> bool
+        {
+            DWORD ReturnLength = 0;
+            if (::GetTokenInformation(
+                TokenHandle,
+                TokenInformationClass,
+                Buffer,
+                static_cast<DWORD>(Size),
+                &ReturnLength))
+            {
+                Size = ReturnLength;
+                return true;
+            }
+
+            Error = ::GetLastError();
+            if (ERROR_INSUFFICIENT_BUFFER == Error ||
+                ERROR_BAD_LENGTH == Error)
+            {
+                Size = ReturnLength;
+                Error = ERROR_NOT_ENOUGH_MEMORY;
+            }
+            return false;
+        },
+        Length);
+    if (!*OutputInformation)
+    {
+        ::SetLastError(Error);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 Mile::HResult Mile::CreateLUAToken(
     _In_ HANDLE ExistingTokenHandle,
     _Out_ PHANDLE TokenHandle)
 {
     Mile::HResult hr = E_INVALIDARG;
 
+    // The token information and the new default DACL are only needed in this
+    // function, so they are allocated from a local arena.
+    Mile::InlineScopedArena<1024> Arena;
+
     PTOKEN_USER pTokenUser = nullptr;
     TOKEN_OWNER Owner = { 0 };
     PTOKEN_DEFAULT_DACL pTokenDacl = nullptr;
@@ -445,7 +473,8 @@ Mile::HResult Mile::CreateLUAToken(
         hr = Mile::GetTokenInformationWithMemory(
             *TokenHandle,
             TokenUser,
-            reinterpret_cast<PVOID*>(&pTokenUser));
+            reinterpret_cast<PVOID*>(&pTokenUser),
+            Arena);
         if (hr != S_OK)
         {
             break;
@@ -462,7 +491,8 @@ Mile::HResult Mile::CreateLUAToken(
         hr = Mile::GetTokenInformationWithMemory(
             *TokenHandle,
             TokenDefaultDacl,
-            reinterpret_cast<PVOID*>(&pTokenDacl));
+            reinterpret_cast<PVOID*>(&pTokenDacl),
+            Arena);
         if (hr != S_OK)
         {
             break;
@@ -472,9 +502,8 @@ Mile::HResult Mile::CreateLUAToken(
         Length += ::GetLengthSid(pTokenUser->User.Sid);
         Length += sizeof(ACCESS_ALLOWED_ACE);
 
-        NewDefaultDacl = reinterpret_cast<PACL>(
-            ::MileAllocateMemory(Length));
-        if (NewDefaultDacl)
+        NewDefaultDacl = reinterpret_cast<PACL>(Arena.Allocate(Length));
+        if (!NewDefaultDacl)
         {
             hr = Mile::HResult::FromWin32(ERROR_NOT_ENOUGH_MEMORY);
             break;
@@ -540,21 +569,6 @@ Mile::HResult Mile::CreateLUAToken(
 
     } while (false);
 
-    if (NewDefaultDacl)
-    {
-        ::MileFreeMemory(NewDefaultDacl);
-    }
-
-    if (pTokenDacl)
-    {
-        ::MileFreeMemory(pTokenDacl);
-    }
-
-    if (pTokenUser)
-    {
-        ::MileFreeMemory(pTokenUser);
-    }
-
     if (hr != S_OK)
     {
         ::CloseHandle(TokenHandle);
@@ -599,48 +613,137 @@ Mile::HResult Mile::CoCreateInstanceByString(
 
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP | WINAPI_PARTITION_SYSTEM)
 
+namespace
+{
+    /**
+     * @brief Retrieves the string type data for the specified value name
+     *        associated with an open registry key into a buffer, as the fill
+     *        function of Mile::ProbeAndFill. The last element of the buffer
+     *        is reserved for the terminating null character, and the trailing
+     *        null characters of the data are excluded from the length.
+     * @param hKey A handle to an open registry key.
+     * @param lpValueName The name of the registry value.
+     * @param Buffer The buffer that receives the value's data.
+     * @param Size The capacity of the buffer on input, and the length of the
+     *             data or the required capacity on output.
+     * @param hr The error code if the function fails without asking for a
+     *           larger buffer.
+     * @return true if the function succeeds, otherwise false.
+    */
+    static bool RegQueryStringValueFill(
+        _In_ HKEY hKey,
+        _In_opt_ LPCWSTR lpValueName,
+        _Out_ wchar_t* Buffer,
+        _Inout_ std::size_t& Size,
+        _Out_ Mile::HResult& hr)
+    {
+        DWORD Type = 0;
+        DWORD cbData = static_cast<DWORD>((Size - 1) * sizeof(wchar_t));
+        LSTATUS Error = ::RegQueryValueExW(
+            hKey,
+            lpValueName,
+            nullptr,
+            &Type,
+            reinterpret_cast<LPBYTE>(Buffer),
+            &cbData);
+        if (ERROR_MORE_DATA == Error)
+        {
+            Size = (cbData + sizeof(wchar_t) - 1) / sizeof(wchar_t) + 1;
+            return false;
+        }
+
+        hr = Mile::HResult::FromWin32(Error);
+        if (SUCCEEDED(hr) && REG_SZ != Type && REG_EXPAND_SZ != Type)
+            hr = __HRESULT_FROM_WIN32(ERROR_ILLEGAL_ELEMENT_ADDRESS);
+        if (FAILED(hr))
+        {
+            return false;
+        }
+
+        std::size_t Length = cbData / sizeof(wchar_t);
+        while (Length && L'\0' == Buffer[Length - 1])
+        {
+            --Length;
+        }
+        Buffer[Length] = L'\0';
+        Size = Length;
+        return true;
+    }
+}
+
 Mile::HResult Mile::RegQueryStringValue(
     _In_ HKEY hKey,
     _In_opt_ LPCWSTR lpValueName,
     _Out_ LPWSTR* lpData)
 {
-    *lpData = nullptr;
+    Mile::UniqueBuffer<wchar_t> Data;
+    Mile::HResult hr = Mile::RegQueryStringValue(hKey, lpValueName, Data);
+    *lpData = Data.Detach();
+    return hr;
+}
 
-    DWORD cbData = 0;
-    Mile::HResult hr = Mile::HResult::FromWin32(::RegQueryValueExW(
-        hKey,
-        lpValueName,
-        nullptr,
-        nullptr,
-        nullptr,
-        &cbData));
-    if (SUCCEEDED(hr))
-    {
-        *lpData = reinterpret_cast<LPWSTR>(::MileAllocateMemory(
-            cbData * sizeof(wchar_t)));
-        if (*lpData)
+Mile::HResult Mile::RegQueryStringValue(
+    _In_ HKEY hKey,
+    _In_opt_ LPCWSTR lpValueName,
+    _Out_ Mile::UniqueBuffer<wchar_t>& Data)
+{
+    Data.Close();
+
+    Mile::HResult hr = Mile::HResult::FromWin32(ERROR_NOT_ENOUGH_MEMORY);
+    Mile::ProbeAndFill<wchar_t>(
+        [&](wchar_t* Buffer, std::size_t& Size) -> bool
         {
-            DWORD Type = 0;
-            hr = Mile::HResult::FromWin32(::RegQueryValueExW(
+            return ::RegQueryStringValueFill(
                 hKey,
                 lpValueName,
-                nullptr,
-                &Type,
-                reinterpret_cast<LPBYTE>(*lpData),
-                &cbData));
-            if (SUCCEEDED(hr) && REG_SZ != Type && REG_EXPAND_SZ != Type)
-                hr = __HRESULT_FROM_WIN32(ERROR_ILLEGAL_ELEMENT_ADDRESS);
-
-            if (FAILED(hr))
+                Buffer,
+                Size,
+                hr);
+        },
+        [&](wchar_t const* Buffer, std::size_t Length) -> bool
+        {
+            Data.Attach(
+                reinterpret_cast<wchar_t*>(
+                    ::MileAllocateMemory((Length + 1) * sizeof(wchar_t))),
+                Length,
+                Length + 1);
+            if (!Data)
             {
-                ::MileFreeMemory(*lpData);
+                hr = Mile::HResult::FromWin32(ERROR_NOT_ENOUGH_MEMORY);
+                return false;
             }
-        }
-        else
+            ::memcpy(Data.Get(), Buffer, (Length + 1) * sizeof(wchar_t));
+            MILE_ACCOUNT_HANDED_OFF_ALLOCATION(
+                "Mile.RegQueryStringValue",
+                (Length + 1) * sizeof(wchar_t));
+            return true;
+        });
+
+    return hr;
+}
+
+Mile::HResult Mile::RegQueryStringValue(
+    _In_ HKEY hKey,
+    _In_opt_ LPCWSTR lpValueName,
+    _Out_ LPWSTR* lpData,
+    _Inout_ Mile::ScopedArena& Arena)
+{
+    Mile::HResult hr = Mile::HResult::FromWin32(ERROR_NOT_ENOUGH_MEMORY);
+
+    std::size_t Length = 0;
+    *lpData = Mile::ProbeAndFill<wchar_t>(
+        Arena,
+        MAX_PATH,
+        [&](wchar_t* Buffer, std::size_t& Size) -> bool
         {
-            hr = Mile::HResult::FromWin32(ERROR_NOT_ENOUGH_MEMORY);
-        }
-    }
+            return ::RegQueryStringValueFill(
+                hKey,
+                lpValueName,
+                Buffer,
+                Size,
+                hr);
+        },
+        Length);
 
     return hr;
 }
@@ -672,16 +775,20 @@ Mile::HResult Mile::CoCheckInterfaceName(
         nullptr));
     if (SUCCEEDED(hr))
     {
+        Mile::InlineScopedArena<MAX_PATH * sizeof(wchar_t)> Arena;
+
         wchar_t* InterfaceTypeName = nullptr;
-        hr = Mile::RegQueryStringValue(hKey, nullptr, &InterfaceTypeName);
+        hr = Mile::RegQueryStringValue(
+            hKey,
+            nullptr,
+            &InterfaceTypeName,
+            Arena);
         if (SUCCEEDED(hr))
         {
             if (0 != ::_wcsicmp(InterfaceTypeName, InterfaceName))
             {
                 hr = E_NOINTERFACE;
             }
-
-            ::MileFreeMemory(InterfaceTypeName);
         }
 
         ::RegCloseKey(hKey);
@@ -750,8 +857,12 @@ Mile::HResult Mile::AdjustTokenPrivilegesSimple(
         DWORD PSize = sizeof(LUID_AND_ATTRIBUTES) * PrivilegeCount;
         DWORD TPSize = PSize + sizeof(DWORD);
 
+        // Most callers only adjust a few privileges, so the buffer usually
+        // fits in the inline buffer of the arena.
+        Mile::InlineScopedArena<256> Arena;
+
         PTOKEN_PRIVILEGES pTP = reinterpret_cast<PTOKEN_PRIVILEGES>(
-            ::MileAllocateMemory(TPSize));
+            Arena.Allocate(TPSize));
         if (pTP)
         {
             pTP->PrivilegeCount = PrivilegeCount;
@@ -760,8 +871,6 @@ Mile::HResult Mile::AdjustTokenPrivilegesSimple(
             ::AdjustTokenPrivileges(
                 TokenHandle, FALSE, pTP, TPSize, nullptr, nullptr);
             hr = Mile::HResultFromLastError();
-
-            ::MileFreeMemory(pTP);
         }
         else
         {
@@ -776,12 +885,17 @@ Mile::HResult Mile::AdjustTokenAllPrivileges(
     _In_ HANDLE TokenHandle,
     _In_ DWORD Attributes)
 {
+    // The privileges are only needed in this function, so they are allocated
+    // from a local arena.
+    Mile::InlineScopedArena<1024> Arena;
+
     PTOKEN_PRIVILEGES pTokenPrivileges = nullptr;
 
     Mile::HResult hr = Mile::GetTokenInformationWithMemory(
         TokenHandle,
         TokenPrivileges,
-        reinterpret_cast<PVOID*>(&pTokenPrivileges));
+        reinterpret_cast<PVOID*>(&pTokenPrivileges),
+        Arena);
     if (hr == S_OK)
     {
         for (DWORD i = 0; i < pTokenPrivileges->PrivilegeCount; ++i)
@@ -793,8 +907,6 @@ Mile::HResult Mile::AdjustTokenAllPrivileges(
             TokenHandle,
             pTokenPrivileges->Privileges,
             pTokenPrivileges->PrivilegeCount);
-
-        ::MileFreeMemory(pTokenPrivileges);
     }
 
     return hr;
@@ -832,38 +944,68 @@ std::wstring Mile::GetHResultMessage(
         ::LocalFree(RawMessage);
     }
 
+    MILE_ACCOUNT_HANDED_OFF_ALLOCATION(
+        "Mile.GetHResultMessage",
+        Mile::GetAccountedSize(Message));
+
     return Message;
 }
 
-std::wstring Mile::GetSystemDirectoryW()
+namespace
 {
-    std::wstring Path;
-
-    UINT Length = ::GetSystemDirectoryW(nullptr, 0);
-    if (Length)
+    /**
+     * @brief Retrieves a system path with the Win32 functions like
+     *        GetSystemDirectoryW, which return the length of the path if the
+     *        buffer is large enough, otherwise the required capacity.
+     * @param Function The Win32 function to retrieve the path.
+     * @return The system path. If the function fails, the return value is an
+     *         empty string.
+    */
+    static std::wstring GetSystemPath(
+        UINT(WINAPI* Function)(LPWSTR, UINT))
     {
-        Path.resize(Length);
-        Length = ::GetSystemDirectoryW(&Path[0], Length);
-        Path.resize(Length);
+        std::wstring Path;
+
+        Mile::ProbeAndFill<wchar_t>(
+            [&](wchar_t* Buffer, std::size_t& Size) -> bool
+            {
+                UINT Length = Function(Buffer, static_cast<UINT>(Size));
+                if (!Length)
+                {
+                    return false;
+                }
+                if (Length >= Size)
+                {
+                    Size = Length;
+                    return false;
+                }
+                Size = Length;
+                return true;
+            },
+            [&](wchar_t const* Buffer, std::size_t Length) -> bool
+            {
+                Path.assign(Buffer, Length);
+                return true;
+            });
+
+        return Path;
     }
+}
 
+std::wstring const& Mile::GetSystemDirectoryW()
+{
+    // The initialization of the function-local static object is thread-safe,
+    // and only costs a load after that.
+    static const std::wstring Path = ::GetSystemPath(::GetSystemDirectoryW);
     return Path;
 }
 
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP | WINAPI_PARTITION_SYSTEM)
 
-std::wstring Mile::GetWindowsDirectoryW()
+std::wstring const& Mile::GetWindowsDirectoryW()
 {
-    std::wstring Path;
-
-    UINT Length = ::GetSystemWindowsDirectoryW(nullptr, 0);
-    if (Length)
-    {
-        Path.resize(Length);
-        Length = ::GetSystemWindowsDirectoryW(&Path[0], Length);
-        Path.resize(Length);
-    }
-
+    static const std::wstring Path = ::GetSystemPath(
+        ::GetSystemWindowsDirectoryW);
     return Path;
 }
 
@@ -874,29 +1016,74 @@ std::wstring Mile::ExpandEnvironmentStringsW(
 {
     std::wstring DestinationString;
 
-    UINT Length = ::ExpandEnvironmentStringsW(
-        SourceString.c_str(),
-        nullptr,
-        0);
-    if (Length)
-    {
-        DestinationString.resize(Length);
-        Length = ::ExpandEnvironmentStringsW(
-            SourceString.c_str(),
-            &DestinationString[0],
-            Length);
-        DestinationString.resize(Length - 1);
-    }
+    Mile::ProbeAndFill<wchar_t>(
+        [&](wchar_t* Buffer, std::size_t& Size) -> bool
+        {
+            // The returned length includes the terminating null character.
+            DWORD Length = ::ExpandEnvironmentStringsW(
+                SourceString.c_str(),
+                Buffer,
+                static_cast<DWORD>(Size));
+            if (!Length)
+            {
+                return false;
+            }
+            if (Length > Size)
+            {
+                Size = Length;
+                return false;
+            }
+            Size = Length - 1;
+            return true;
+        },
+        [&](wchar_t const* Buffer, std::size_t Length) -> bool
+        {
+            DestinationString.assign(Buffer, Length);
+            return true;
+        });
+
+    MILE_ACCOUNT_HANDED_OFF_ALLOCATION(
+        "Mile.ExpandEnvironmentStringsW",
+        Mile::GetAccountedSize(DestinationString));
 
     return DestinationString;
 }
 
-std::wstring Mile::GetCurrentProcessModulePath()
+std::wstring const& Mile::GetCurrentProcessModulePath()
 {
-    // 32767 is the maximum path length without the terminating null character.
-    std::wstring Path(32767, L'\0');
-    Path.resize(::GetModuleFileNameW(
-        nullptr, &Path[0], static_cast<DWORD>(Path.size())));
+    static const std::wstring Path = []() -> std::wstring
+    {
+        std::wstring Result;
+
+        Mile::ProbeAndFill<wchar_t>(
+            [](wchar_t* Buffer, std::size_t& Size) -> bool
+            {
+                DWORD Length = ::GetModuleFileNameW(
+                    nullptr,
+                    Buffer,
+                    static_cast<DWORD>(Size));
+                if (!Length)
+                {
+                    return false;
+                }
+                if (Length == Size)
+                {
+                    // The path is truncated, and GetModuleFileNameW does not
+                    // report the required size.
+                    Size *= 2;
+                    return false;
+                }
+                Size = Length;
+                return true;
+            },
+            [&](wchar_t const* Buffer, std::size_t Length) -> bool
+            {
+                Result.assign(Buffer, Length);
+                return true;
+            });
+
+        return Result;
+    }();
     return Path;
 }
 
@@ -211,6 +211,12 @@ namespace Mile
         }
     };
 
+    /**
+     * @brief The raw critical section object, which has the same name on all
+     *        platforms.
+    */
+    using RawCriticalSection = CRITICAL_SECTION;
+
     /**
      * @brief Wraps a critical section object.
     */
@@ -218,6 +224,11 @@ namespace Mile
     {
     public:
 
+        /**
+         * @brief The raw object type which is used by the static functions.
+        */
+        using RawObjectType = RawCriticalSection;
+
         /**
          * @brief Initializes a critical section object.
          * @param lpCriticalSection A pointer to the critical section object.
@@ -289,6 +300,13 @@ namespace Mile
         */
         CRITICAL_SECTION m_RawObject;
 
+#ifdef MILE_ENABLE_LOCK_PROFILING
+        /**
+         * @brief The profiler of the critical section object.
+        */
+        LockProfiler m_Profiler;
+#endif
+
     public:
 
         /**
@@ -299,6 +317,24 @@ namespace Mile
             Initialize(&this->m_RawObject);
         }
 
+        /**
+         * @brief Initializes the named critical section object, the name is
+         *        used by the lock profiling.
+         * @param Name The name of the critical section object, which should be
+         *             a string literal.
+        */
+        explicit CriticalSection(
+            char const* Name) noexcept
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            : m_Profiler(Name)
+#endif
+        {
+#ifndef MILE_ENABLE_LOCK_PROFILING
+            UnreferencedParameter(Name);
+#endif
+            Initialize(&this->m_RawObject);
+        }
+
         /**
          * @brief Releases all resources used by the critical section object.
         */
@@ -313,7 +349,14 @@ namespace Mile
         */
         void Lock() noexcept
         {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return TryEnter(&this->m_RawObject); },
+                [this]() { Enter(&this->m_RawObject); },
+                true);
+#else
             Enter(&this->m_RawObject);
+#endif
         }
 
         /**
@@ -327,7 +370,13 @@ namespace Mile
         */
         bool TryLock() noexcept
         {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return TryEnter(&this->m_RawObject); },
+                true);
+#else
             return TryEnter(&this->m_RawObject);
+#endif
         }
 
         /**
@@ -335,188 +384,30 @@ namespace Mile
         */
         void Unlock() noexcept
         {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.OnExclusiveReleasing();
+#endif
             Leave(&this->m_RawObject);
         }
     };
 
     /**
-     * @brief Provides automatic locking and unlocking of a critical section.
-    */
-    class AutoCriticalSectionLock
-    {
-    private:
-
-        /**
-         * @brief The critical section object.
-        */
-        CriticalSection& m_Object;
-
-    public:
-
-        /**
-         * @brief Lock the critical section object.
-         * @param Object The critical section object.
-        */
-        explicit AutoCriticalSectionLock(
-            CriticalSection& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_Object.Lock();
-        }
-
-        /**
-         * @brief Unlock the critical section object.
-        */
-        ~AutoCriticalSectionLock() noexcept
-        {
-            this->m_Object.Unlock();
-        }
-    };
-
-    /**
-     * @brief Provides automatic trying to locking and unlocking of a critical
-     *        section.
+     * @brief The raw slim reader/writer (SRW) lock object, which has the same
+     *        name on all platforms.
     */
-    class AutoCriticalSectionTryLock
-    {
-    private:
-
-        /**
-         * @brief The critical section object.
-        */
-        CriticalSection& m_Object;
-
-        /**
-         * @brief The lock status.
-        */
-        bool m_IsLocked;
-
-    public:
-
-        /**
-         * @brief Try to lock the critical section object.
-         * @param Object The critical section object.
-        */
-        explicit AutoCriticalSectionTryLock(
-            CriticalSection& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_IsLocked = this->m_Object.TryLock();
-        }
-
-        /**
-         * @brief Try to unlock the critical section object.
-        */
-        ~AutoCriticalSectionTryLock() noexcept
-        {
-            if (this->m_IsLocked)
-            {
-                this->m_Object.Unlock();
-            }
-        }
-
-        /**
-         * @brief Check the lock status.
-         * @return The lock status.
-        */
-        bool IsLocked() const
-        {
-            return this->m_IsLocked;
-        }
-    };
+    using RawSRWLock = SRWLOCK;
 
     /**
-     * @brief Provides automatic locking and unlocking of a raw critical section.
+     * @brief Wraps a slim reader/writer (SRW) lock.
     */
-    class AutoRawCriticalSectionLock
+    class SRWLock : DisableCopyConstruction, DisableMoveConstruction
     {
-    private:
-
-        /**
-         * @brief The raw critical section object.
-        */
-        CRITICAL_SECTION& m_Object;
-
     public:
 
         /**
-         * @brief Lock the raw critical section object.
-         * @param Object The raw critical section object.
-        */
-        explicit AutoRawCriticalSectionLock(
-            CRITICAL_SECTION& Object) noexcept :
-            m_Object(Object)
-        {
-            CriticalSection::Enter(&this->m_Object);
-        }
-
-        /**
-         * @brief Unlock the raw critical section object.
-        */
-        ~AutoRawCriticalSectionLock() noexcept
-        {
-            CriticalSection::Leave(&this->m_Object);
-        }
-    };
-
-    /**
-     * @brief Provides automatic trying to locking and unlocking of a raw
-     *        critical section.
-    */
-    class AutoRawCriticalSectionTryLock
-    {
-    private:
-
-        /**
-         * @brief The raw critical section object.
+         * @brief The raw object type which is used by the static functions.
         */
-        CRITICAL_SECTION& m_Object;
-
-        /**
-         * @brief The lock status.
-        */
-        bool m_IsLocked;
-
-    public:
-
-        /**
-         * @brief Try to lock the raw critical section object.
-         * @param Object The raw critical section object.
-        */
-        explicit AutoRawCriticalSectionTryLock(
-            CRITICAL_SECTION& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_IsLocked = CriticalSection::TryEnter(&this->m_Object);
-        }
-
-        /**
-         * @brief Try to unlock the raw critical section object.
-        */
-        ~AutoRawCriticalSectionTryLock() noexcept
-        {
-            if (this->m_IsLocked)
-            {
-                CriticalSection::Leave(&this->m_Object);
-            }
-        }
-
-        /**
-         * @brief Check the lock status.
-         * @return The lock status.
-        */
-        bool IsLocked() const
-        {
-            return this->m_IsLocked;
-        }
-    };
-
-    /**
-     * @brief Wraps a slim reader/writer (SRW) lock.
-    */
-    class SRWLock : DisableCopyConstruction, DisableMoveConstruction
-    {
-    public:
+        using RawObjectType = RawSRWLock;
 
         /**
          * @brief Initialize a slim reader/writer (SRW) lock.
@@ -615,6 +506,13 @@ namespace Mile
         */
         SRWLOCK m_RawObject;
 
+#ifdef MILE_ENABLE_LOCK_PROFILING
+        /**
+         * @brief The profiler of the slim reader/writer (SRW) lock.
+        */
+        LockProfiler m_Profiler;
+#endif
+
     public:
 
         /**
@@ -625,12 +523,37 @@ namespace Mile
             Initialize(&this->m_RawObject);
         }
 
+        /**
+         * @brief Initialize the named slim reader/writer (SRW) lock, the name
+         *        is used by the lock profiling.
+         * @param Name The name of the slim reader/writer (SRW) lock, which
+         *             should be a string literal.
+        */
+        explicit SRWLock(
+            char const* Name) noexcept
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            : m_Profiler(Name)
+#endif
+        {
+#ifndef MILE_ENABLE_LOCK_PROFILING
+            UnreferencedParameter(Name);
+#endif
+            Initialize(&this->m_RawObject);
+        }
+
         /**
          * @brief Acquires the slim reader/writer (SRW) lock in exclusive mode.
         */
         void LockExclusive() noexcept
         {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return TryAcquireExclusive(&this->m_RawObject); },
+                [this]() { AcquireExclusive(&this->m_RawObject); },
+                true);
+#else
             AcquireExclusive(&this->m_RawObject);
+#endif
         }
 
         /**
@@ -643,7 +566,13 @@ namespace Mile
         */
         bool TryLockExclusive() noexcept
         {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return TryAcquireExclusive(&this->m_RawObject); },
+                true);
+#else
             return TryAcquireExclusive(&this->m_RawObject);
+#endif
         }
 
         /**
@@ -652,6 +581,9 @@ namespace Mile
         */
         void UnlockExclusive() noexcept
         {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.OnExclusiveReleasing();
+#endif
             ReleaseExclusive(&this->m_RawObject);
         }
 
@@ -660,7 +592,14 @@ namespace Mile
         */
         void LockShared() noexcept
         {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            this->m_Profiler.Acquire(
+                [this]() { return TryAcquireShared(&this->m_RawObject); },
+                [this]() { AcquireShared(&this->m_RawObject); },
+                false);
+#else
             AcquireShared(&this->m_RawObject);
+#endif
         }
 
         /**
@@ -673,7 +612,13 @@ namespace Mile
         */
         bool TryLockShared() noexcept
         {
+#ifdef MILE_ENABLE_LOCK_PROFILING
+            return this->m_Profiler.TryAcquire(
+                [this]() { return TryAcquireShared(&this->m_RawObject); },
+                false);
+#else
             return TryAcquireShared(&this->m_RawObject);
+#endif
         }
 
         /**
@@ -687,359 +632,34 @@ namespace Mile
     };
 
     /**
-     * @brief Provides automatic exclusive locking and unlocking of a slim
-     *        reader/writer (SRW) lock.
-    */
-    class AutoSRWExclusiveLock
-    {
-    private:
-
-        /**
-         * @brief The slim reader/writer (SRW) lock object.
-        */
-        SRWLock& m_Object;
-
-    public:
-
-        /**
-         * @brief Exclusive lock the slim reader/writer (SRW) lock object.
-         * @param Object The slim reader/writer (SRW) lock object.
-        */
-        explicit AutoSRWExclusiveLock(
-            SRWLock& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_Object.LockExclusive();
-        }
-
-        /**
-         * @brief Exclusive unlock the slim reader/writer (SRW) lock object.
-        */
-        ~AutoSRWExclusiveLock() noexcept
-        {
-            this->m_Object.UnlockExclusive();
-        }
-    };
-
-    /**
-     * @brief Provides automatic trying to exclusive locking and unlocking of a
-     *        slim reader/writer (SRW) lock.
-    */
-    class AutoSRWExclusiveTryLock
-    {
-    private:
-
-        /**
-         * @brief The slim reader/writer (SRW) lock object.
-        */
-        SRWLock& m_Object;
-
-        /**
-         * @brief The lock status.
-        */
-        bool m_IsLocked;
-
-    public:
-
-        /**
-         * @brief Try to exclusive lock the slim reader/writer (SRW) lock
-         *        object.
-         * @param Object The slim reader/writer (SRW) lock object.
-        */
-        explicit AutoSRWExclusiveTryLock(
-            SRWLock& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_IsLocked = this->m_Object.TryLockExclusive();
-        }
-
-        /**
-         * @brief Try to exclusive unlock the slim reader/writer (SRW) lock
-         *        object.
-        */
-        ~AutoSRWExclusiveTryLock() noexcept
-        {
-            if (this->m_IsLocked)
-            {
-                this->m_Object.UnlockExclusive();
-            }
-        }
-
-        /**
-         * @brief Check the lock status.
-         * @return The lock status.
-        */
-        bool IsLocked() const
-        {
-            return this->m_IsLocked;
-        }
-    };
-
-    /**
-     * @brief Provides automatic shared locking and unlocking of a slim
-     *        reader/writer (SRW) lock.
-    */
-    class AutoSRWSharedLock
-    {
-    private:
-
-        /**
-         * @brief The slim reader/writer (SRW) lock object.
-        */
-        SRWLock& m_Object;
-
-    public:
-
-        /**
-         * @brief Shared lock the slim reader/writer (SRW) lock object.
-         * @param Object The slim reader/writer (SRW) lock object.
-        */
-        explicit AutoSRWSharedLock(
-            SRWLock& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_Object.LockShared();
-        }
-
-        /**
-         * @brief Shared unlock the slim reader/writer (SRW) lock object.
-        */
-        ~AutoSRWSharedLock() noexcept
-        {
-            this->m_Object.UnlockShared();
-        }
-    };
-
-    /**
-     * @brief Provides automatic trying to shared locking and unlocking of a
-     *        slim reader/writer (SRW) lock.
-    */
-    class AutoSRWSharedTryLock
-    {
-    private:
-
-        /**
-         * @brief The slim reader/writer (SRW) lock object.
-        */
-        SRWLock& m_Object;
-
-        /**
-         * @brief The lock status.
-        */
-        bool m_IsLocked;
-
-    public:
-
-        /**
-         * @brief Try to shared lock the slim reader/writer (SRW) lock object.
-         * @param Object The slim reader/writer (SRW) lock object.
-        */
-        explicit AutoSRWSharedTryLock(
-            SRWLock& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_IsLocked = this->m_Object.TryLockShared();
-        }
-
-        /**
-         * @brief Try to shared unlock the slim reader/writer (SRW) lock
-         *        object.
-        */
-        ~AutoSRWSharedTryLock() noexcept
-        {
-            if (this->m_IsLocked)
-            {
-                this->m_Object.UnlockShared();
-            }
-        }
-
-        /**
-         * @brief Check the lock status.
-         * @return The lock status.
-        */
-        bool IsLocked() const
-        {
-            return this->m_IsLocked;
-        }
-    };
-
-    /**
-     * @brief Provides automatic exclusive locking and unlocking of a raw slim
-     *        reader/writer (SRW) lock.
+     * @brief The traits of the memory blocks allocated by MileAllocateMemory.
+     * @tparam ElementType The element type of the memory blocks.
     */
-    class AutoRawSRWExclusiveLock
+    template<typename ElementType>
+    struct MileMemoryTraits
     {
-    private:
-
-        /**
-         * @brief The slim reader/writer (SRW) lock object.
-        */
-        SRWLOCK& m_Object;
-
-    public:
+        using Type = ElementType*;
 
-        /**
-         * @brief Exclusive lock the raw slim reader/writer (SRW) lock object.
-         * @param Object The raw slim reader/writer (SRW) lock object.
-        */
-        explicit AutoRawSRWExclusiveLock(
-            SRWLOCK& Object) noexcept :
-            m_Object(Object)
+        static Type Invalid() noexcept
         {
-            SRWLock::AcquireExclusive(&this->m_Object);
+            return nullptr;
         }
 
-        /**
-         * @brief Exclusive unlock the raw slim reader/writer (SRW) lock
-         *        object.
-        */
-        ~AutoRawSRWExclusiveLock() noexcept
+        static void Close(Type Value) noexcept
         {
-            SRWLock::ReleaseExclusive(&this->m_Object);
+            ::MileFreeMemory(Value);
         }
     };
 
     /**
-     * @brief Provides automatic trying to exclusive locking and unlocking of a
-     *        raw slim reader/writer (SRW) lock.
+     * @brief The unique buffer allocated by MileAllocateMemory, which also
+     *        carries its length and capacity.
+     * @tparam ElementType The element type of the unique buffer.
     */
-    class AutoRawSRWExclusiveTryLock
-    {
-    private:
-
-        /**
-         * @brief The raw slim reader/writer (SRW) lock object.
-        */
-        SRWLOCK& m_Object;
-
-        /**
-         * @brief The lock status.
-        */
-        bool m_IsLocked;
-
-    public:
-
-        /**
-         * @brief Try to exclusive lock the raw slim reader/writer (SRW) lock
-         *        object.
-         * @param Object The slim reader/writer (SRW) lock object.
-        */
-        explicit AutoRawSRWExclusiveTryLock(
-            SRWLOCK& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_IsLocked = SRWLock::TryAcquireExclusive(&this->m_Object);
-        }
-
-        /**
-         * @brief Try to exclusive unlock the raw slim reader/writer (SRW) lock
-         *        object.
-        */
-        ~AutoRawSRWExclusiveTryLock() noexcept
-        {
-            if (this->m_IsLocked)
-            {
-                SRWLock::ReleaseExclusive(&this->m_Object);
-            }
-        }
-
-        /**
-         * @brief Check the lock status.
-         * @return The lock status.
-        */
-        bool IsLocked() const
-        {
-            return this->m_IsLocked;
-        }
-    };
-
-    /**
-     * @brief Provides automatic shared locking and unlocking of a raw slim
-     *        reader/writer (SRW) lock.
-    */
-    class AutoRawSRWSharedLock
-    {
-    private:
-
-        /**
-         * @brief The raw slim reader/writer (SRW) lock object.
-        */
-        SRWLOCK& m_Object;
-
-    public:
-
-        /**
-         * @brief Shared lock the raw slim reader/writer (SRW) lock object.
-         * @param Object The raw slim reader/writer (SRW) lock object.
-        */
-        explicit AutoRawSRWSharedLock(
-            SRWLOCK& Object) noexcept :
-            m_Object(Object)
-        {
-            SRWLock::AcquireShared(&this->m_Object);
-        }
-
-        /**
-         * @brief Shared unlock the raw slim reader/writer (SRW) lock object.
-        */
-        ~AutoRawSRWSharedLock() noexcept
-        {
-            SRWLock::ReleaseShared(&this->m_Object);
-        }
-    };
-
-    /**
-     * @brief Provides automatic trying to shared locking and unlocking of a
-     *        raw slim reader/writer (SRW) lock.
-    */
-    class AutoRawSRWSharedTryLock
-    {
-    private:
-
-        /**
-         * @brief The raw slim reader/writer (SRW) lock object.
-        */
-        SRWLOCK& m_Object;
-
-        /**
-         * @brief The lock status.
-        */
-        bool m_IsLocked;
-
-    public:
-
-        /**
-         * @brief Try to shared lock the raw slim reader/writer (SRW) lock object.
-         * @param Object The raw slim reader/writer (SRW) lock object.
-        */
-        explicit AutoRawSRWSharedTryLock(
-            SRWLOCK& Object) noexcept :
-            m_Object(Object)
-        {
-            this->m_IsLocked = SRWLock::TryAcquireShared(&this->m_Object);
-        }
-
-        /**
-         * @brief Try to shared unlock the raw slim reader/writer (SRW) lock
-         *        object.
-        */
-        ~AutoRawSRWSharedTryLock() noexcept
-        {
-            if (this->m_IsLocked)
-            {
-                SRWLock::ReleaseShared(&this->m_Object);
-            }
-        }
-
-        /**
-         * @brief Check the lock status.
-         * @return The lock status.
-        */
-        bool IsLocked() const
-        {
-            return this->m_IsLocked;
-        }
-    };
+    template<typename ElementType>
+    using UniqueBuffer = BasicUniqueBuffer<
+        ElementType,
+        MileMemoryTraits<ElementType>>;
 
 #pragma endregion
 
@@ -1213,6 +833,29 @@ namespace Mile
         _In_ TOKEN_INFORMATION_CLASS TokenInformationClass,
         _Out_ PVOID* OutputInformation);
 
+    /**
+     * @brief Retrieves a specified type of information about an access token
+     *        into the memory allocated from the arena.
+     * @param TokenHandle A handle to an access token from which information is
+     *                    retrieved.
+     * @param TokenInformationClass Specifies a value from the
+     *                              TOKEN_INFORMATION_CLASS enumerated type to
+     *                              identify the type of information the
+     *                              function retrieves.
+     * @param OutputInformation A pointer to a buffer the function fills with
+     *                          the requested information. The buffer is
+     *                          freed with the arena.
+     * @param Arena The arena which the buffer is allocated from.
+     * @return An HResultFromLastError object An containing the HResult object
+     *         containing the error code.
+     * @remark For more information, see GetTokenInformation.
+    */
+    HResultFromLastError GetTokenInformationWithMemory(
+        _In_ HANDLE TokenHandle,
+        _In_ TOKEN_INFORMATION_CLASS TokenInformationClass,
+        _Out_ PVOID* OutputInformation,
+        _Inout_ ScopedArena& Arena);
+
     /**
      * @brief Creates a new access token that is a LUA version of an existing
      *        access token.
@@ -1271,6 +914,37 @@ namespace Mile
         _In_opt_ LPCWSTR lpValueName,
         _Out_ LPWSTR* lpData);
 
+    /**
+     * @brief Retrieves the string type data for the specified value name
+     *        associated with an open registry key into the memory allocated
+     *        from the arena.
+     * @param hKey A handle to an open registry key.
+     * @param lpValueName The name of the registry value.
+     * @param lpData A pointer to a buffer that receives the value's data. The
+     *               buffer is freed with the arena.
+     * @param Arena The arena which the buffer is allocated from.
+     * @return An HResult object containing the error code.
+    */
+    HResult RegQueryStringValue(
+        _In_ HKEY hKey,
+        _In_opt_ LPCWSTR lpValueName,
+        _Out_ LPWSTR* lpData,
+        _Inout_ ScopedArena& Arena);
+
+    /**
+     * @brief Retrieves the string type data for the specified value name
+     *        associated with an open registry key into a unique buffer.
+     * @param hKey A handle to an open registry key.
+     * @param lpValueName The name of the registry value.
+     * @param Data The unique buffer that receives the value's data, the length
+     *             of it excludes the terminating null characters.
+     * @return An HResult object containing the error code.
+    */
+    HResult RegQueryStringValue(
+        _In_ HKEY hKey,
+        _In_opt_ LPCWSTR lpValueName,
+        _Out_ UniqueBuffer<wchar_t>& Data);
+
 #endif
 
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP | WINAPI_PARTITION_SYSTEM)
@@ -1401,20 +1075,23 @@ namespace Mile
     /**
      * @brief Retrieves the path of the system directory. The system directory
      *        contains system files such as dynamic-link libraries and drivers.
+     *        The path is retrieved once and cached for the lifetime of the
+     *        process.
      * @return The path of the system directory if successful, an empty string
      *         otherwise.
     */
-    std::wstring GetSystemDirectoryW();
+    std::wstring const& GetSystemDirectoryW();
 
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP | WINAPI_PARTITION_SYSTEM)
 
     /**
      * @brief Retrieves the path of the shared Windows directory on a
-     *        multi-user system.
+     *        multi-user system. The path is retrieved once and cached for the
+     *        lifetime of the process.
      * @return The path of the shared Windows directory on a multi-user system
      *         if successful, an empty string otherwise.
     */
-    std::wstring GetWindowsDirectoryW();
+    std::wstring const& GetWindowsDirectoryW();
 
 #endif
 
@@ -1432,10 +1109,12 @@ namespace Mile
 
     /**
      * @brief Retrieves the path of the executable file of the current process.
+     *        The path is retrieved once and cached for the lifetime of the
+     *        process.
      * @return The path of the executable file of the current process if
      *         successful, an empty string otherwise.
     */
-    std::wstring GetCurrentProcessModulePath();
+    std::wstring const& GetCurrentProcessModulePath();
 
     /**
      * @brief Converts a numeric value into a UTF-16 string that represents
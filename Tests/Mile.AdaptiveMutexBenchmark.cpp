@@ -0,0 +1,114 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.AdaptiveMutexBenchmark.cpp
+ * PURPOSE:   Benchmark for Mile::AdaptiveMutex across the hold times and
+ *            the thread counts
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <mutex>
+
+namespace
+{
+    /**
+     * @brief The number of the operations per thread.
+    */
+    const std::size_t OperationCount = 100000;
+
+    /**
+     * @brief Measures the time of the lock, the work in the critical section
+     *        and the unlock.
+     * @param ThreadCount The number of the threads.
+     * @param HoldIterations The number of the loop iterations in the
+     *                       critical section.
+     * @return The time per operation in nanoseconds.
+    */
+    template<typename LockRoutineType, typename UnlockRoutineType>
+    static double Measure(
+        std::size_t ThreadCount,
+        std::size_t HoldIterations,
+        LockRoutineType const& LockRoutine,
+        UnlockRoutineType const& UnlockRoutine)
+    {
+        std::uint64_t Value = 0;
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t)
+            {
+                for (std::size_t i = 0; i < OperationCount; ++i)
+                {
+                    LockRoutine();
+                    for (std::size_t j = 0; j < HoldIterations; ++j)
+                    {
+                        Value = Value * 6364136223846793005ULL + 1;
+                    }
+                    ++Value;
+                    UnlockRoutine();
+                }
+            });
+        return Elapsed / (OperationCount * ThreadCount);
+    }
+}
+
+int main()
+{
+    std::printf("Mutex with the hold time, ns per operation\n");
+    std::printf(
+        "%8s %6s %14s %14s %16s %12s\n",
+        "Threads",
+        "Hold",
+        "AdaptiveMutex",
+        "(no spinning)",
+        "CriticalSection",
+        "std::mutex");
+
+    std::size_t const HoldIterations[] = { 0, 20, 200 };
+    for (std::size_t ThreadCount : Mile::Tests::GetThreadCounts())
+    {
+        for (std::size_t Hold : HoldIterations)
+        {
+            Mile::AdaptiveMutex AdaptiveLock;
+            Mile::AdaptiveMutex NonSpinningLock;
+            NonSpinningLock.SetMaximumSpinCount(0);
+            Mile::CriticalSection CriticalSectionLock;
+            std::mutex StandardLock;
+
+            double AdaptiveTime = ::Measure(
+                ThreadCount,
+                Hold,
+                [&]() { AdaptiveLock.Lock(); },
+                [&]() { AdaptiveLock.Unlock(); });
+            double NonSpinningTime = ::Measure(
+                ThreadCount,
+                Hold,
+                [&]() { NonSpinningLock.Lock(); },
+                [&]() { NonSpinningLock.Unlock(); });
+            double CriticalSectionTime = ::Measure(
+                ThreadCount,
+                Hold,
+                [&]() { CriticalSectionLock.Lock(); },
+                [&]() { CriticalSectionLock.Unlock(); });
+            double StandardTime = ::Measure(
+                ThreadCount,
+                Hold,
+                [&]() { StandardLock.lock(); },
+                [&]() { StandardLock.unlock(); });
+
+            std::printf(
+                "%8zu %6zu %14.2f %14.2f %16.2f %12.2f\n",
+                ThreadCount,
+                Hold,
+                AdaptiveTime,
+                NonSpinningTime,
+                CriticalSectionTime,
+                StandardTime);
+        }
+    }
+
+    return 0;
+}
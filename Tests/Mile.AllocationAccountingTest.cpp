@@ -0,0 +1,154 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.AllocationAccountingTest.cpp
+ * PURPOSE:   Tests for the allocation accounting of the tracked call sites
+ *            and the call sites which hand the memory off
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <string>
+
+namespace
+{
+    /**
+     * @brief The length of the generated arguments, which is long enough to
+     *        keep the strings out of the small string buffer.
+    */
+    const std::size_t ArgumentLength = 64;
+
+    /**
+     * @brief The size of the arena allocation, which is larger than the
+     *        default chunk so it always allocates a chunk.
+    */
+    const std::size_t ArenaAllocationSize = 1024 * 1024;
+
+    static bool FindSite(
+        char const* Name,
+        Mile::AllocationSiteStatistics& Site)
+    {
+        for (Mile::AllocationSiteStatistics const& Current
+            : Mile::GetAllocationStatistics())
+        {
+            if (0 == std::strcmp(Current.Name, Name))
+            {
+                Site = Current;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void TestAccountedSize()
+    {
+        std::string Short("Mile");
+        MILE_TEST_CHECK(0 == Mile::GetAccountedSize(Short));
+
+        std::string Long(ArgumentLength, 'M');
+        MILE_TEST_CHECK(Long.capacity() + 1 == Mile::GetAccountedSize(Long));
+
+        std::vector<std::string> List;
+        List.reserve(4);
+        List.push_back(Short);
+        List.push_back(Long);
+        MILE_TEST_CHECK(
+            4 * sizeof(std::string) + Long.capacity() + 1 ==
+            Mile::GetAccountedSize(List));
+    }
+
+    static void TestHandedOffSites()
+    {
+        std::size_t const ThreadCount = 4;
+        std::size_t const Iterations = 1000 * Mile::Tests::GetScale();
+        std::atomic<std::uint64_t> BuiltBytes(0);
+        std::atomic<std::uint64_t> SplitBytes(0);
+
+        // The callers free the returned memory without recording it, and the
+        // events cached by the threads are merged when they exit.
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t Index)
+        {
+            std::vector<std::string> Arguments;
+            Arguments.emplace_back(
+                ArgumentLength,
+                static_cast<char>('a' + Index));
+            Arguments.emplace_back(ArgumentLength, 'z');
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                std::string CommandLine = Mile::BuildCommandLine(Arguments);
+                BuiltBytes.fetch_add(Mile::GetAccountedSize(CommandLine));
+                std::vector<std::string> Split =
+                    Mile::SpiltCommandArguments(CommandLine);
+                SplitBytes.fetch_add(Mile::GetAccountedSize(Split));
+            }
+        });
+
+        Mile::AllocationSiteStatistics Site;
+        MILE_TEST_CHECK(::FindSite("Mile.BuildCommandLine", Site));
+        MILE_TEST_CHECK(Site.IsHandedOff);
+        MILE_TEST_CHECK(ThreadCount * Iterations == Site.AllocationCount);
+        MILE_TEST_CHECK(BuiltBytes.load() == Site.AllocatedBytes);
+        MILE_TEST_CHECK(0 == Site.FreeCount);
+        MILE_TEST_CHECK(0 == Site.LiveBytes);
+        MILE_TEST_CHECK(0 == Site.PeakLiveBytes);
+
+        MILE_TEST_CHECK(::FindSite("Mile.SpiltCommandArguments", Site));
+        MILE_TEST_CHECK(Site.IsHandedOff);
+        MILE_TEST_CHECK(ThreadCount * Iterations == Site.AllocationCount);
+        MILE_TEST_CHECK(SplitBytes.load() == Site.AllocatedBytes);
+        MILE_TEST_CHECK(0 == Site.LiveBytes);
+        MILE_TEST_CHECK(0 == Site.PeakLiveBytes);
+    }
+
+    static void TestTrackedSites()
+    {
+        {
+            Mile::ScopedArena Arena;
+            MILE_TEST_CHECK(Arena.Allocate(ArenaAllocationSize));
+            Arena.Reset();
+            MILE_TEST_CHECK(Arena.Allocate(ArenaAllocationSize));
+        }
+
+        Mile::AllocationSiteStatistics Site;
+        MILE_TEST_CHECK(::FindSite("Mile.ScopedArena", Site));
+        MILE_TEST_CHECK(!Site.IsHandedOff);
+        MILE_TEST_CHECK(2 == Site.AllocationCount);
+        MILE_TEST_CHECK(2 == Site.FreeCount);
+        MILE_TEST_CHECK(Site.AllocatedBytes == Site.FreedBytes);
+        MILE_TEST_CHECK(0 == Site.LiveBytes);
+        MILE_TEST_CHECK(
+            Site.PeakLiveBytes >=
+            static_cast<std::int64_t>(ArenaAllocationSize));
+        MILE_TEST_CHECK(
+            Site.PeakLiveBytes <
+            static_cast<std::int64_t>(2 * ArenaAllocationSize));
+    }
+
+    static void TestDump()
+    {
+        std::string Dump = Mile::DumpAllocationStatistics();
+
+        // The untracked columns of the handed off call sites are "-".
+        std::size_t Start = Dump.find("Mile.BuildCommandLine ");
+        MILE_TEST_CHECK(std::string::npos != Start);
+        std::string Line = Dump.substr(Start, Dump.find('\n', Start) - Start);
+        MILE_TEST_CHECK(std::string::npos != Line.find(" - "));
+
+        Start = Dump.find("Mile.ScopedArena ");
+        MILE_TEST_CHECK(std::string::npos != Start);
+        Line = Dump.substr(Start, Dump.find('\n', Start) - Start);
+        MILE_TEST_CHECK(std::string::npos == Line.find(" - "));
+    }
+}
+
+int main()
+{
+    ::TestAccountedSize();
+    ::TestHandedOffSites();
+    ::TestTrackedSites();
+    ::TestDump();
+    return Mile::Tests::Finish("Mile.AllocationAccountingTest");
+}
@@ -0,0 +1,135 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CachedMemoryBenchmark.cpp
+ * PURPOSE:   Benchmark for Mile::AllocateCachedMemory, Mile::ScopedArena and
+ *            malloc
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cstdlib>
+
+namespace
+{
+    /**
+     * @brief The number of the allocations per thread.
+    */
+    const std::size_t OperationCount = 1000000;
+
+    /**
+     * @brief The number of the blocks which are alive at the same time.
+    */
+    const std::size_t LiveCount = 16;
+
+    /**
+     * @brief Measures allocating LiveCount blocks and freeing them again,
+     *        with the sizes up to MaximumSize.
+    */
+    template<typename AllocateType, typename FreeType>
+    static double MeasureAllocator(
+        std::size_t ThreadCount,
+        std::size_t MaximumSize,
+        AllocateType const& Allocate,
+        FreeType const& Free)
+    {
+        std::size_t const Count = OperationCount * Mile::Tests::GetScale();
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t Index)
+            {
+                Mile::Tests::Random Generator(Index + 1);
+                std::size_t Sizes[LiveCount];
+                for (std::size_t& Size : Sizes)
+                {
+                    Size = 1 + Generator.Next(MaximumSize);
+                }
+                void* Blocks[LiveCount];
+                for (std::size_t i = 0; i < Count; i += LiveCount)
+                {
+                    for (std::size_t j = 0; j < LiveCount; ++j)
+                    {
+                        Blocks[j] = Allocate(Sizes[j]);
+                        *static_cast<unsigned char*>(Blocks[j]) = 0;
+                    }
+                    for (std::size_t j = 0; j < LiveCount; ++j)
+                    {
+                        Free(Blocks[j]);
+                    }
+                }
+            });
+        return Elapsed / (static_cast<double>(Count) * ThreadCount);
+    }
+
+    /**
+     * @brief Measures allocating LiveCount blocks from an arena with an
+     *        inline buffer and resetting it.
+    */
+    static double MeasureArena(
+        std::size_t ThreadCount,
+        std::size_t MaximumSize)
+    {
+        std::size_t const Count = OperationCount * Mile::Tests::GetScale();
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t Index)
+            {
+                Mile::Tests::Random Generator(Index + 1);
+                std::size_t Sizes[LiveCount];
+                for (std::size_t& Size : Sizes)
+                {
+                    Size = 1 + Generator.Next(MaximumSize);
+                }
+                for (std::size_t i = 0; i < Count; i += LiveCount)
+                {
+                    Mile::InlineScopedArena<4096> Arena;
+                    for (std::size_t j = 0; j < LiveCount; ++j)
+                    {
+                        *static_cast<unsigned char*>(
+                            Arena.Allocate(Sizes[j])) = 0;
+                    }
+                }
+            });
+        return Elapsed / (static_cast<double>(Count) * ThreadCount);
+    }
+}
+
+int main()
+{
+    std::size_t const MaximumSizes[] = { 64, 1024, 16384 };
+
+    std::printf("Allocate and free, ns per block\n");
+    std::printf(
+        "%8s %10s %14s %14s %14s\n",
+        "Threads",
+        "Size",
+        "Cached",
+        "malloc",
+        "ScopedArena");
+    for (std::size_t ThreadCount : Mile::Tests::GetThreadCounts())
+    {
+        for (std::size_t MaximumSize : MaximumSizes)
+        {
+            std::printf(
+                "%8zu %10zu %14.2f %14.2f %14.2f\n",
+                ThreadCount,
+                MaximumSize,
+                ::MeasureAllocator(
+                    ThreadCount,
+                    MaximumSize,
+                    Mile::AllocateCachedMemory,
+                    Mile::FreeCachedMemory),
+                ::MeasureAllocator(
+                    ThreadCount,
+                    MaximumSize,
+                    std::malloc,
+                    std::free),
+                ::MeasureArena(ThreadCount, MaximumSize));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CachedMemoryTest.cpp
+ * PURPOSE:   Test for Mile::AllocateCachedMemory and Mile::ScopedArena
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+    /**
+     * @brief The number of the blocks allocated by each thread.
+    */
+    const std::size_t BlockCount = 20000;
+
+    /**
+     * @brief The sizes around the boundaries of the size classes, and a few
+     *        sizes which are not cached.
+    */
+    const std::size_t Sizes[] =
+    {
+        0, 1, 15, 16, 17, 31, 32, 33, 100, 128, 129, 1000, 4096, 4097,
+        16384, 32767, 32768, 32769, 65536, 1024 * 1024,
+    };
+
+    static bool IsAligned(
+        void const* Block,
+        std::size_t Alignment)
+    {
+        return 0 == reinterpret_cast<std::uintptr_t>(Block) % Alignment;
+    }
+
+    static void Fill(
+        void* Block,
+        std::size_t Size,
+        unsigned char Value)
+    {
+        std::memset(Block, Value, Size);
+    }
+
+    static bool Verify(
+        void const* Block,
+        std::size_t Size,
+        unsigned char Value)
+    {
+        unsigned char const* Bytes = static_cast<unsigned char const*>(Block);
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            if (Value != Bytes[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Checks that the blocks of all size classes are usable and
+     *        aligned, and that a freed block is reused for the next
+     *        allocation of the same size class.
+    */
+    static void CheckSizeClasses()
+    {
+        std::vector<void*> Blocks;
+        for (std::size_t Size : Sizes)
+        {
+            void* Block = Mile::AllocateCachedMemory(Size);
+            MILE_TEST_CHECK(nullptr != Block);
+            MILE_TEST_CHECK(::IsAligned(Block, alignof(std::max_align_t)));
+            ::Fill(Block, Size, static_cast<unsigned char>(Size));
+            Blocks.push_back(Block);
+        }
+        for (std::size_t i = 0; i < Blocks.size(); ++i)
+        {
+            MILE_TEST_CHECK(::Verify(
+                Blocks[i],
+                Sizes[i],
+                static_cast<unsigned char>(Sizes[i])));
+            Mile::FreeCachedMemory(Blocks[i]);
+        }
+
+        void* Block = Mile::AllocateCachedMemory(100);
+        Mile::FreeCachedMemory(Block);
+        MILE_TEST_CHECK(Block == Mile::AllocateCachedMemory(120));
+        Mile::FreeCachedMemory(Block);
+
+        // More blocks than the depth of the cache are freed to the heap.
+        Blocks.clear();
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            Blocks.push_back(Mile::AllocateCachedMemory(64));
+        }
+        for (void* Current : Blocks)
+        {
+            Mile::FreeCachedMemory(Current);
+        }
+
+        Mile::FreeCachedMemory(nullptr);
+        MILE_TEST_CHECK(nullptr == Mile::AllocateCachedMemory(SIZE_MAX));
+        Mile::TrimCachedMemory();
+    }
+
+    /**
+     * @brief Checks that the blocks can be freed by the threads which didn't
+     *        allocate them, so they move into the caches of the other
+     *        threads.
+    */
+    static void CheckCrossThreadFrees(
+        std::size_t ThreadCount)
+    {
+        std::vector<std::vector<std::pair<void*, std::size_t>>> Blocks(
+            ThreadCount);
+        std::size_t const Count = BlockCount * Mile::Tests::GetScale();
+
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t Index)
+        {
+            Mile::Tests::Random Generator(Index + 1);
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                std::size_t Size = Generator.Next(4096);
+                void* Block = Mile::AllocateCachedMemory(Size);
+                MILE_TEST_CHECK(nullptr != Block);
+                ::Fill(Block, Size, static_cast<unsigned char>(Index));
+                Blocks[Index].emplace_back(Block, Size);
+            }
+        });
+
+        // Each thread checks and frees the blocks of the next thread, and
+        // then allocates from the blocks it has cached.
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t Index)
+        {
+            std::size_t Owner = (Index + 1) % ThreadCount;
+            for (auto const& Block : Blocks[Owner])
+            {
+                MILE_TEST_CHECK(::Verify(
+                    Block.first,
+                    Block.second,
+                    static_cast<unsigned char>(Owner)));
+                Mile::FreeCachedMemory(Block.first);
+            }
+            for (std::size_t i = 0; i < 64; ++i)
+            {
+                void* Block = Mile::AllocateCachedMemory(i * 64);
+                ::Fill(Block, i * 64, 0xCC);
+                Mile::FreeCachedMemory(Block);
+            }
+        });
+    }
+
+    /**
+     * @brief Checks that the arena uses the inline buffer first, moves to
+     *        the heap when the buffer is full, and goes back to the inline
+     *        buffer after being reset.
+    */
+    static void CheckScopedArena()
+    {
+        Mile::InlineScopedArena<256> Arena;
+        unsigned char const* Begin =
+            reinterpret_cast<unsigned char const*>(&Arena);
+        unsigned char const* End = Begin + sizeof(Arena);
+        auto IsInline = [&](void const* Block)
+        {
+            unsigned char const* Byte =
+                static_cast<unsigned char const*>(Block);
+            return Byte >= Begin && Byte < End;
+        };
+
+        void* First = Arena.Allocate(100);
+        MILE_TEST_CHECK(IsInline(First));
+        void* Second = Arena.Allocate(100);
+        MILE_TEST_CHECK(IsInline(Second));
+        MILE_TEST_CHECK(
+            static_cast<unsigned char*>(Second) >=
+            static_cast<unsigned char*>(First) + 100);
+
+        // The inline buffer can't hold another one.
+        void* Overflow = Arena.Allocate(100);
+        MILE_TEST_CHECK(nullptr != Overflow && !IsInline(Overflow));
+        ::Fill(Overflow, 100, 0x5A);
+
+        void* Aligned = Arena.Allocate(24, 64);
+        MILE_TEST_CHECK(::IsAligned(Aligned, 64));
+        MILE_TEST_CHECK(nullptr == Arena.Allocate(8, 3));
+
+        // The large blocks and many small blocks take more chunks.
+        void* Large = Arena.Allocate(1024 * 1024);
+        MILE_TEST_CHECK(nullptr != Large);
+        ::Fill(Large, 1024 * 1024, 0xA5);
+        for (std::size_t i = 0; i < 10000; ++i)
+        {
+            void* Block = Arena.Allocate(1 + i % 200);
+            MILE_TEST_CHECK(nullptr != Block);
+            ::Fill(Block, 1 + i % 200, 0x3C);
+        }
+        MILE_TEST_CHECK(::Verify(Overflow, 100, 0x5A));
+        MILE_TEST_CHECK(::Verify(Large, 1024 * 1024, 0xA5));
+
+        Arena.Reset();
+        MILE_TEST_CHECK(First == Arena.Allocate(100));
+
+        Mile::ScopedArena HeapArena;
+        void* Block = HeapArena.Allocate(16);
+        MILE_TEST_CHECK(nullptr != Block);
+        MILE_TEST_CHECK(::IsAligned(Block, alignof(std::max_align_t)));
+    }
+}
+
+int main()
+{
+    ::CheckSizeClasses();
+    for (std::size_t ThreadCount : { 2, 4 })
+    {
+        ::CheckCrossThreadFrees(ThreadCount);
+    }
+    ::CheckScopedArena();
+
+    return Mile::Tests::Finish("Mile.CachedMemoryTest");
+}
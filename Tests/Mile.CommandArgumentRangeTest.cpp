@@ -0,0 +1,154 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandArgumentRangeTest.cpp
+ * PURPOSE:   Test for Mile::BasicCommandArgumentRange
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cstring>
+#include <string>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief The number of the generated command lines per character type.
+    */
+    const std::size_t CaseCount = 5000;
+
+    /**
+     * @brief Checks that the range stops decoding when the caller stops, by
+     *        placing the rest of the source on a page which can't be read.
+    */
+    static void CheckEarlyTermination()
+    {
+        std::size_t PageSize =
+            static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        void* Pages = ::mmap(
+            nullptr,
+            PageSize * 2,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1,
+            0);
+        MILE_TEST_CHECK(MAP_FAILED != Pages);
+        if (MAP_FAILED == Pages)
+        {
+            return;
+        }
+
+        char* Source = static_cast<char*>(Pages);
+        static char const Head[] = "app.exe \"quoted first\" second ";
+        for (std::size_t i = 0; i < PageSize; ++i)
+        {
+            Source[i] = (i & 1) ? ' ' : 'x';
+        }
+        std::memcpy(Source, Head, sizeof(Head) - 1);
+        MILE_TEST_CHECK(0 == ::mprotect(
+            Source + PageSize,
+            PageSize,
+            PROT_NONE));
+
+        Mile::BasicCommandArgumentRange<char> Range(Source, PageSize * 2);
+        auto Iterator = Range.begin();
+        MILE_TEST_CHECK(Iterator->ToString() == "app.exe");
+        MILE_TEST_CHECK(0 == Iterator.SourceOffset());
+        MILE_TEST_CHECK(7 == Iterator.SourceLength());
+
+        // The arguments without quotes and backslashes refer to the source.
+        MILE_TEST_CHECK(Source == Iterator->Data());
+
+        ++Iterator;
+        MILE_TEST_CHECK(Iterator->ToString() == "quoted first");
+        MILE_TEST_CHECK(8 == Iterator.SourceOffset());
+        MILE_TEST_CHECK(14 == Iterator.SourceLength());
+        MILE_TEST_CHECK(Source + 9 != Iterator->Data());
+
+        ++Iterator;
+        MILE_TEST_CHECK(Iterator->ToString() == "second");
+        MILE_TEST_CHECK(Source + 23 == Iterator->Data());
+
+        ::munmap(Pages, PageSize * 2);
+    }
+
+    template<typename CharType>
+    static std::basic_string<CharType> GenerateCommandLine(
+        Mile::Tests::Random& Generator)
+    {
+        static char const Alphabet[] = { 'a', 'Z', ' ', '\t', '"', '\\' };
+
+        std::basic_string<CharType> Result;
+        std::size_t Length = Generator.Next(40);
+        for (std::size_t i = 0; i < Length; ++i)
+        {
+            Result.push_back(static_cast<CharType>(
+                Alphabet[Generator.Next(sizeof(Alphabet))]));
+        }
+        return Result;
+    }
+
+    /**
+     * @brief Checks that the range gives the same arguments as
+     *        SpiltCommandArgumentsToSpans, and that the source of each
+     *        argument splits into the argument alone.
+    */
+    template<typename CharType>
+    static void CheckAgreement(
+        std::uint64_t Seed)
+    {
+        Mile::Tests::Random Generator(Seed);
+        std::size_t const Count = CaseCount * Mile::Tests::GetScale();
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+            std::basic_string<CharType> CommandLine =
+                ::GenerateCommandLine<CharType>(Generator);
+            Mile::BasicCommandArgumentSpans<CharType> Expected =
+                Mile::SpiltCommandArgumentsToSpans(CommandLine);
+
+            Mile::BasicCommandArgumentRange<CharType> Range(
+                CommandLine.data(),
+                CommandLine.size());
+            std::size_t Index = 0;
+            for (auto Iterator = Range.begin();
+                Iterator != Range.end();
+                ++Iterator, ++Index)
+            {
+                MILE_TEST_CHECK(Index < Expected.Count());
+                if (Index >= Expected.Count())
+                {
+                    break;
+                }
+                MILE_TEST_CHECK(
+                    Iterator->ToString() == Expected[Index].ToString());
+
+                std::basic_string<CharType> Source = CommandLine.substr(
+                    Iterator.SourceOffset(),
+                    Iterator.SourceLength());
+                Mile::BasicCommandArgumentSpans<CharType> Single =
+                    Mile::SpiltCommandArgumentsToSpans(Source);
+                MILE_TEST_CHECK(1 == Single.Count());
+                MILE_TEST_CHECK(
+                    1 != Single.Count() ||
+                    Single[0].ToString() == Expected[Index].ToString());
+            }
+            MILE_TEST_CHECK(Index == Expected.Count());
+        }
+    }
+}
+
+int main()
+{
+    ::CheckEarlyTermination();
+    ::CheckAgreement<char>(1);
+    ::CheckAgreement<wchar_t>(2);
+    ::CheckAgreement<char16_t>(3);
+
+    return Mile::Tests::Finish("Mile.CommandArgumentRangeTest");
+}
@@ -0,0 +1,151 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandArgumentsBatchBenchmark.cpp
+ * PURPOSE:   Benchmark for splitting a large corpus of command lines in batch
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <string>
+
+namespace
+{
+    /**
+     * @brief The length of the generated corpus in code units for each unit of
+     *        MILE_TESTS_SCALE, use MILE_TESTS_SCALE=64 for a 4 GiB corpus.
+    */
+    const std::size_t CorpusLength = 64 * 1024 * 1024;
+
+    /**
+     * @brief Generates a command line like the ones of the compilers and
+     *        linkers, which are mostly long paths with a few quoted ones.
+    */
+    static std::string GenerateCommandLine(
+        Mile::Tests::Random& Generator)
+    {
+        static char const* const Folders[] =
+        {
+            "C:\\Program Files\\Microsoft Visual Studio\\2022\\Enterprise",
+            "D:\\Projects\\Mile.Cpp\\Output\\Binaries\\Release\\x64",
+            "/usr/lib/gcc/x86_64-linux-gnu/13/include",
+            "/home/builder/src/mile/Mile.Library/Generated/Objects",
+        };
+
+        std::string Result = "cl.exe";
+        std::size_t ArgumentCount = 1 + Generator.Next(16);
+        for (std::size_t i = 0; i < ArgumentCount; ++i)
+        {
+            Result += ' ';
+            char const* Folder = Folders[Generator.Next(4)];
+            bool Quoted = (0 == Generator.Next(4));
+            Result += Quoted ? "/I\"" : "-I";
+            Result += Folder;
+            Result += "/Module";
+            Result += std::to_string(Generator.Next(1000));
+            if (Quoted)
+            {
+                Result += '"';
+            }
+        }
+
+        return Result;
+    }
+
+    static void Print(
+        char const* Name,
+        double Elapsed,
+        std::size_t CodeUnitCount,
+        std::size_t ArgumentCount)
+    {
+        std::printf(
+            "%-24s %14.3f %14.1f %12zu\n",
+            Name,
+            Elapsed / static_cast<double>(CodeUnitCount),
+            static_cast<double>(CodeUnitCount) * 1000.0 / Elapsed,
+            ArgumentCount);
+    }
+}
+
+int main()
+{
+#if defined(MILE_PORTABLE_DISABLE_SIMD)
+    std::printf("SpiltCommandArgumentsInBatch, scalar build\n");
+#else
+    std::printf("SpiltCommandArgumentsInBatch, SIMD build\n");
+#endif
+
+    std::size_t const Length = CorpusLength * Mile::Tests::GetScale();
+    Mile::Tests::Random Generator(1);
+    std::vector<std::string> CommandLines;
+    std::size_t CodeUnitCount = 0;
+    while (CodeUnitCount < Length)
+    {
+        CommandLines.push_back(::GenerateCommandLine(Generator));
+        CodeUnitCount += CommandLines.back().size();
+    }
+    std::vector<Mile::BasicStringSpan<char>> Spans(
+        CommandLines.begin(),
+        CommandLines.end());
+
+    std::printf(
+        "%zu lines, %zu code units\n",
+        CommandLines.size(),
+        CodeUnitCount);
+    std::printf(
+        "%-24s %14s %14s %12s\n",
+        "Method",
+        "ns/CodeUnit",
+        "MB/s",
+        "Arguments");
+
+    {
+        std::size_t ArgumentCount = 0;
+        double Elapsed = Mile::Tests::RunThreads(1, [&](std::size_t)
+        {
+            for (std::string const& CommandLine : CommandLines)
+            {
+                ArgumentCount +=
+                    Mile::SpiltCommandArguments(CommandLine).size();
+            }
+        });
+        ::Print(
+            "SpiltCommandArguments",
+            Elapsed,
+            CodeUnitCount,
+            ArgumentCount);
+    }
+
+    {
+        std::size_t ArgumentCount = 0;
+        double Elapsed = Mile::Tests::RunThreads(1, [&](std::size_t)
+        {
+            for (std::string const& CommandLine : CommandLines)
+            {
+                ArgumentCount +=
+                    Mile::SpiltCommandArgumentsToSpans(CommandLine).Count();
+            }
+        });
+        ::Print("ToSpans", Elapsed, CodeUnitCount, ArgumentCount);
+    }
+
+    for (std::size_t ThreadCount : Mile::Tests::GetThreadCounts())
+    {
+        std::size_t ArgumentCount = 0;
+        double Elapsed = Mile::Tests::RunThreads(1, [&](std::size_t)
+        {
+            ArgumentCount = Mile::SpiltCommandArgumentsInBatch(
+                Spans.data(),
+                Spans.size(),
+                ThreadCount).ArgumentCount();
+        });
+        char Name[32];
+        std::snprintf(Name, sizeof(Name), "InBatch, %zu threads", ThreadCount);
+        ::Print(Name, Elapsed, CodeUnitCount, ArgumentCount);
+    }
+
+    return 0;
+}
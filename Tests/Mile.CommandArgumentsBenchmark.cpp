@@ -0,0 +1,122 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandArgumentsBenchmark.cpp
+ * PURPOSE:   Benchmark for splitting the long path-heavy command lines
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <string>
+
+namespace
+{
+    /**
+     * @brief The number of the generated command lines.
+    */
+    const std::size_t LineCount = 256;
+
+    /**
+     * @brief The number of the passes over the generated command lines.
+    */
+    const std::size_t PassCount = 200;
+
+    /**
+     * @brief Generates a command line like the ones of the compilers and
+     *        linkers, which are mostly long paths with a few quoted ones.
+    */
+    template<typename CharType>
+    static std::basic_string<CharType> GenerateCommandLine(
+        Mile::Tests::Random& Generator)
+    {
+        static char const* const Folders[] =
+        {
+            "C:\\Program Files\\Microsoft Visual Studio\\2022\\Enterprise",
+            "D:\\Projects\\Mile.Cpp\\Output\\Binaries\\Release\\x64",
+            "/usr/lib/gcc/x86_64-linux-gnu/13/include",
+            "/home/builder/src/mile/Mile.Library/Generated/Objects",
+        };
+
+        std::string Result = "\"";
+        Result += Folders[0];
+        Result += "\\VC\\Tools\\MSVC\\bin\\cl.exe\"";
+        std::size_t ArgumentCount = 16 + Generator.Next(16);
+        for (std::size_t i = 0; i < ArgumentCount; ++i)
+        {
+            Result += ' ';
+            char const* Folder = Folders[Generator.Next(4)];
+            bool Quoted = (0 == Generator.Next(4));
+            Result += Quoted ? "/I\"" : "-I";
+            Result += Folder;
+            Result += "/Module";
+            Result += std::to_string(Generator.Next(1000));
+            Result += "/Source.cpp";
+            if (Quoted)
+            {
+                Result += '"';
+            }
+        }
+
+        return std::basic_string<CharType>(Result.begin(), Result.end());
+    }
+
+    template<typename CharType>
+    static void Measure(
+        char const* TypeName)
+    {
+        Mile::Tests::Random Generator(1);
+        std::vector<std::basic_string<CharType>> CommandLines;
+        std::size_t CodeUnitCount = 0;
+        for (std::size_t i = 0; i < LineCount; ++i)
+        {
+            CommandLines.push_back(
+                ::GenerateCommandLine<CharType>(Generator));
+            CodeUnitCount += CommandLines.back().size();
+        }
+
+        std::size_t ArgumentCount = 0;
+        std::size_t const Passes = PassCount * Mile::Tests::GetScale();
+        double Elapsed = Mile::Tests::RunThreads(1, [&](std::size_t)
+        {
+            for (std::size_t Pass = 0; Pass < Passes; ++Pass)
+            {
+                for (std::basic_string<CharType> const& CommandLine
+                    : CommandLines)
+                {
+                    ArgumentCount += Mile::SpiltCommandArgumentsToSpans(
+                        CommandLine).Count();
+                }
+            }
+        });
+
+        std::printf(
+            "%10s %10zu %14.3f %14.1f\n",
+            TypeName,
+            CodeUnitCount / LineCount,
+            Elapsed / (static_cast<double>(CodeUnitCount) * Passes),
+            Elapsed / (static_cast<double>(LineCount) * Passes));
+        static_cast<void>(ArgumentCount);
+    }
+}
+
+int main()
+{
+#if defined(MILE_PORTABLE_DISABLE_SIMD)
+    std::printf("SpiltCommandArgumentsToSpans, scalar build\n");
+#else
+    std::printf("SpiltCommandArgumentsToSpans, SIMD build\n");
+#endif
+    std::printf(
+        "%10s %10s %14s %14s\n",
+        "Type",
+        "Length",
+        "ns/CodeUnit",
+        "ns/Line");
+    ::Measure<char>("char");
+    ::Measure<wchar_t>("wchar_t");
+    ::Measure<char16_t>("char16_t");
+    return 0;
+}
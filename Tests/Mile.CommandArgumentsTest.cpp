@@ -0,0 +1,332 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandArgumentsTest.cpp
+ * PURPOSE:   Differential test for the SIMD and scalar command argument
+ *            scanners, and test for the batch parsing
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <string>
+
+namespace
+{
+    /**
+     * @brief The number of the generated cases per character type.
+    */
+    const std::size_t CaseCount = 2000;
+
+    template<typename CharType>
+    static std::basic_string<CharType> MakeString(
+        char const* Source)
+    {
+        std::basic_string<CharType> Result;
+        for (; *Source; ++Source)
+        {
+            Result.push_back(static_cast<CharType>(*Source));
+        }
+        return Result;
+    }
+
+    template<typename CharType>
+    static void CheckKnownAnswer(
+        char const* CommandLine,
+        std::vector<char const*> const& Expected)
+    {
+        std::vector<std::basic_string<CharType>> Arguments =
+            Mile::SpiltCommandArguments(::MakeString<CharType>(CommandLine));
+        MILE_TEST_CHECK(Arguments.size() == Expected.size());
+        for (std::size_t i = 0; i < Arguments.size(); ++i)
+        {
+            MILE_TEST_CHECK(
+                i < Expected.size() &&
+                Arguments[i] == ::MakeString<CharType>(Expected[i]));
+        }
+    }
+
+    template<typename CharType>
+    static void CheckKnownAnswers()
+    {
+        ::CheckKnownAnswer<CharType>("a b\t\tc", { "a", "b", "c" });
+        ::CheckKnownAnswer<CharType>("\"a b\" c", { "a b", "c" });
+        ::CheckKnownAnswer<CharType>("a\\\\b c", { "a\\\\b", "c" });
+        ::CheckKnownAnswer<CharType>("a\\\\\"b c\"", { "a\\b c" });
+        ::CheckKnownAnswer<CharType>("a\\\\\\\"b", { "a\\\"b" });
+        ::CheckKnownAnswer<CharType>(
+            "C:\\Program\\Mile.exe \"C:\\Some Folder\\\\\" /x",
+            { "C:\\Program\\Mile.exe", "C:\\Some Folder\\", "/x" });
+    }
+
+    /**
+     * @brief Generates a command line which mixes the long runs of the
+     *        ordinary characters with the special characters, and with the
+     *        code units whose bytes look like the special characters.
+    */
+    template<typename CharType>
+    static std::basic_string<CharType> GenerateCommandLine(
+        Mile::Tests::Random& Generator)
+    {
+        static char const Ordinary[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+            "0123456789_-./:=";
+        static char const Special[] = { ' ', '\t', '\\', '"' };
+
+        std::vector<std::uint32_t> LookAlikes = { 0x7F, 0xA0 };
+        if (sizeof(CharType) >= 2)
+        {
+            LookAlikes.insert(
+                LookAlikes.end(),
+                { 0x0120, 0x0920, 0x2020, 0x2209, 0x225C, 0x5C22, 0xFF20 });
+        }
+        if (sizeof(CharType) >= 4)
+        {
+            LookAlikes.insert(
+                LookAlikes.end(),
+                { 0x10020, 0x1005C, 0x2200022, 0x5C000000 });
+        }
+
+        std::basic_string<CharType> Result;
+        std::size_t PieceCount = Generator.Next(24);
+        for (std::size_t i = 0; i < PieceCount; ++i)
+        {
+            std::size_t Kind = Generator.Next(100);
+            if (Kind < 40)
+            {
+                std::size_t Length = Generator.Next(96);
+                for (std::size_t j = 0; j < Length; ++j)
+                {
+                    Result.push_back(static_cast<CharType>(
+                        Ordinary[Generator.Next(sizeof(Ordinary) - 1)]));
+                }
+            }
+            else if (Kind < 70)
+            {
+                Result.push_back(static_cast<CharType>(
+                    Special[Generator.Next(sizeof(Special))]));
+            }
+            else if (Kind < 80)
+            {
+                std::size_t Length = 1 + Generator.Next(6);
+                Result.append(Length, static_cast<CharType>('\\'));
+            }
+            else if (Kind < 99)
+            {
+                Result.push_back(static_cast<CharType>(
+                    LookAlikes[Generator.Next(LookAlikes.size())]));
+            }
+            else
+            {
+                Result.push_back(static_cast<CharType>(0));
+            }
+        }
+        return Result;
+    }
+
+    /**
+     * @brief Computes the FNV-1a hash of the code units.
+    */
+    template<typename CharType>
+    static void HashCodeUnits(
+        std::uint64_t& Hash,
+        CharType const* Data,
+        std::size_t Size)
+    {
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            Hash ^= static_cast<std::uint64_t>(
+                static_cast<typename std::make_unsigned<CharType>::type>(
+                    Data[i]));
+            Hash *= 0x100000001B3ULL;
+        }
+        Hash ^= 0xFFFFFFFFULL;
+        Hash *= 0x100000001B3ULL;
+    }
+
+    template<typename CharType>
+    static void RunDifferentialCases(
+        char const* TypeName,
+        std::uint64_t Seed,
+        std::FILE* Digest)
+    {
+        Mile::Tests::Random Generator(Seed);
+        std::size_t const Count = CaseCount * Mile::Tests::GetScale();
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+            std::basic_string<CharType> CommandLine =
+                ::GenerateCommandLine<CharType>(Generator);
+
+            Mile::BasicCommandArgumentSpans<CharType> Spans =
+                Mile::SpiltCommandArgumentsToSpans(CommandLine);
+            std::vector<std::basic_string<CharType>> Arguments =
+                Mile::SpiltCommandArguments(CommandLine);
+
+            std::uint64_t Hash = 0xCBF29CE484222325ULL;
+            MILE_TEST_CHECK(Spans.Count() == Arguments.size());
+            for (std::size_t j = 0; j < Spans.Count(); ++j)
+            {
+                Mile::BasicStringSpan<CharType> const& Span = Spans[j];
+                MILE_TEST_CHECK(0 == Span.Data()[Span.Size()]);
+                MILE_TEST_CHECK(
+                    j < Arguments.size() &&
+                    Span.ToString() == Arguments[j]);
+                ::HashCodeUnits(Hash, Span.Data(), Span.Size());
+            }
+
+            if (Digest)
+            {
+                std::fprintf(
+                    Digest,
+                    "%s %zu %zu %016llx\n",
+                    TypeName,
+                    i,
+                    Spans.Count(),
+                    static_cast<unsigned long long>(Hash));
+            }
+        }
+    }
+
+    /**
+     * @brief Checks that the columnar batch has the same arguments as parsing
+     *        each line alone, for a corpus which is large enough to be split
+     *        into several chunks.
+    */
+    template<typename CharType>
+    static void CheckBatch(
+        std::uint64_t Seed,
+        std::size_t ThreadCount)
+    {
+        const std::size_t CorpusLength = 2 * 1024 * 1024;
+
+        Mile::Tests::Random Generator(Seed);
+        std::vector<std::basic_string<CharType>> CommandLines;
+        std::size_t TotalLength = 0;
+        while (TotalLength < CorpusLength)
+        {
+            CommandLines.push_back(
+                ::GenerateCommandLine<CharType>(Generator));
+            TotalLength += CommandLines.back().size();
+        }
+        std::vector<Mile::BasicStringSpan<CharType>> Spans(
+            CommandLines.begin(),
+            CommandLines.end());
+
+        Mile::BasicCommandArgumentBatch<CharType> Batch =
+            Mile::SpiltCommandArgumentsInBatch(
+                Spans.data(),
+                Spans.size(),
+                ThreadCount);
+        MILE_TEST_CHECK(Batch.LineCount() == CommandLines.size());
+
+        std::size_t ArgumentCount = 0;
+        for (std::size_t Line = 0; Line < Batch.LineCount(); ++Line)
+        {
+            Mile::BasicCommandArgumentSpans<CharType> Expected =
+                Mile::SpiltCommandArgumentsToSpans(CommandLines[Line]);
+            MILE_TEST_CHECK(Batch.ArgumentCount(Line) == Expected.Count());
+            MILE_TEST_CHECK(Batch.LineOffsets()[Line] == ArgumentCount);
+            if (Batch.ArgumentCount(Line) != Expected.Count())
+            {
+                return;
+            }
+            for (std::size_t i = 0; i < Expected.Count(); ++i)
+            {
+                Mile::BasicStringSpan<CharType> Argument =
+                    Batch.Argument(Line, i);
+                MILE_TEST_CHECK(Argument.ToString() == Expected[i].ToString());
+                MILE_TEST_CHECK(0 == Argument.Data()[Argument.Size()]);
+            }
+            ArgumentCount += Expected.Count();
+        }
+        MILE_TEST_CHECK(Batch.ArgumentCount() == ArgumentCount);
+        MILE_TEST_CHECK(
+            Batch.LineOffsets()[Batch.LineCount()] == ArgumentCount);
+    }
+
+    template<typename CharType>
+    static void CheckEmptyCommandLine(
+        std::basic_string<CharType> const& CommandLine)
+    {
+        // No argument means no allocation.
+        Mile::BasicCommandArgumentSpans<CharType> Spans =
+            Mile::SpiltCommandArgumentsToSpans(CommandLine);
+        MILE_TEST_CHECK(0 == Spans.Count());
+        MILE_TEST_CHECK(nullptr == Spans.begin());
+        MILE_TEST_CHECK(Mile::SpiltCommandArguments(CommandLine).empty());
+    }
+
+    template<typename CharType>
+    static void CheckEmptyCommandLines()
+    {
+        ::CheckEmptyCommandLine(::MakeString<CharType>(""));
+        ::CheckEmptyCommandLine(::MakeString<CharType>(" "));
+        ::CheckEmptyCommandLine(::MakeString<CharType>("\t \t  "));
+
+        // The parsing stops at the first null character.
+        std::basic_string<CharType> CommandLine =
+            ::MakeString<CharType>("  ");
+        CommandLine.push_back(static_cast<CharType>('\0'));
+        CommandLine.push_back(static_cast<CharType>('a'));
+        ::CheckEmptyCommandLine(CommandLine);
+    }
+
+    static void CheckEmptyBatch()
+    {
+        Mile::BasicCommandArgumentBatch<char> Batch =
+            Mile::SpiltCommandArgumentsInBatch<char>(nullptr, 0);
+        MILE_TEST_CHECK(0 == Batch.LineCount());
+        MILE_TEST_CHECK(0 == Batch.ArgumentCount());
+    }
+}
+
+/**
+ * @brief Runs the known answer and self-consistency checks. If a digest file
+ *        is specified, the digests of the parsed generated command lines
+ *        are written to it, and the digests of the SIMD and scalar builds
+ *        must be identical.
+*/
+int main(int argc, char* argv[])
+{
+    std::FILE* Digest = nullptr;
+    if (argc > 1)
+    {
+        Digest = std::fopen(argv[1], "w");
+        if (!Digest)
+        {
+            std::fprintf(stderr, "Failed to open %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    ::CheckKnownAnswers<char>();
+    ::CheckKnownAnswers<wchar_t>();
+    ::CheckKnownAnswers<char16_t>();
+
+    ::RunDifferentialCases<char>("char", 1, Digest);
+    ::RunDifferentialCases<wchar_t>("wchar_t", 2, Digest);
+    ::RunDifferentialCases<char16_t>("char16_t", 3, Digest);
+
+    if (Digest)
+    {
+        std::fclose(Digest);
+    }
+
+    ::CheckEmptyCommandLines<char>();
+    ::CheckEmptyCommandLines<wchar_t>();
+    ::CheckEmptyCommandLines<char16_t>();
+
+    ::CheckEmptyBatch();
+    ::CheckBatch<char>(4, 1);
+    ::CheckBatch<char>(5, 4);
+    ::CheckBatch<wchar_t>(6, 0);
+    ::CheckBatch<char16_t>(7, 3);
+
+#if defined(MILE_PORTABLE_DISABLE_SIMD)
+    return Mile::Tests::Finish("Mile.CommandArgumentsTest (scalar)");
+#else
+    return Mile::Tests::Finish("Mile.CommandArgumentsTest");
+#endif
+}
@@ -0,0 +1,130 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandLineBuildBenchmark.cpp
+ * PURPOSE:   Benchmark for Mile::BuildCommandLine against the quoting by
+ *            string concatenation
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <string>
+
+namespace
+{
+    /**
+     * @brief The number of the built command lines.
+    */
+    const std::size_t IterationCount = 200000;
+
+    /**
+     * @brief Quotes the arguments by appending one character at a time,
+     *        which is the usual way to write the inverse of the C run-time
+     *        parsing rules.
+    */
+    static std::wstring BuildCommandLineByConcatenation(
+        std::vector<std::wstring> const& Arguments)
+    {
+        std::wstring Result;
+        for (std::wstring const& Argument : Arguments)
+        {
+            if (!Result.empty())
+            {
+                Result += L' ';
+            }
+
+            bool Quoted = Argument.empty() ||
+                std::wstring::npos != Argument.find_first_of(L" \t");
+            if (Quoted)
+            {
+                Result += L'"';
+            }
+
+            std::size_t BackslashCount = 0;
+            for (wchar_t Character : Argument)
+            {
+                if (L'\\' == Character)
+                {
+                    ++BackslashCount;
+                    continue;
+                }
+                if (L'"' == Character)
+                {
+                    Result.append(BackslashCount * 2 + 1, L'\\');
+                }
+                else
+                {
+                    Result.append(BackslashCount, L'\\');
+                }
+                BackslashCount = 0;
+                Result += Character;
+            }
+
+            if (Quoted)
+            {
+                Result.append(BackslashCount * 2, L'\\');
+                Result += L'"';
+            }
+            else
+            {
+                Result.append(BackslashCount, L'\\');
+            }
+        }
+        return Result;
+    }
+
+    template<typename RoutineType>
+    static double Measure(
+        RoutineType const& Routine)
+    {
+        std::size_t Length = 0;
+        double Elapsed = Mile::Tests::RunThreads(1, [&](std::size_t)
+        {
+            std::size_t const Count =
+                IterationCount * Mile::Tests::GetScale();
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                Length += Routine().size();
+            }
+        });
+        static_cast<void>(Length);
+        return Elapsed / (IterationCount * Mile::Tests::GetScale());
+    }
+}
+
+int main()
+{
+    std::vector<std::wstring> const Arguments =
+    {
+        L"C:\\Program Files\\Mile\\Mile.Tool.exe",
+        L"/Input:C:\\Users\\Mile\\Documents\\Source Files\\Main.cpp",
+        L"/Output:D:\\Build\\Output\\",
+        L"/Define:VERSION=\"1.0 Preview\"",
+        L"--verbose",
+        L"",
+    };
+
+    if (Mile::BuildCommandLine(Arguments) !=
+        ::BuildCommandLineByConcatenation(Arguments))
+    {
+        std::printf("The implementations disagree.\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Building a six-argument command line, ns per line\n");
+    std::printf(
+        "%20s %14.1f\n",
+        "BuildCommandLine",
+        ::Measure([&]() { return Mile::BuildCommandLine(Arguments); }));
+    std::printf(
+        "%20s %14.1f\n",
+        "Concatenation",
+        ::Measure([&]()
+        {
+            return ::BuildCommandLineByConcatenation(Arguments);
+        }));
+    return 0;
+}
@@ -0,0 +1,157 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandLineBuildTest.cpp
+ * PURPOSE:   Property test for Mile::BuildCommandLine
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <string>
+
+namespace
+{
+    /**
+     * @brief The number of the generated argument lists per character type.
+    */
+    const std::size_t CaseCount = 20000;
+
+    template<typename CharType>
+    static std::basic_string<CharType> MakeString(
+        char const* Source)
+    {
+        std::basic_string<CharType> Result;
+        for (; *Source; ++Source)
+        {
+            Result.push_back(static_cast<CharType>(*Source));
+        }
+        return Result;
+    }
+
+    template<typename CharType>
+    static void CheckKnownAnswer(
+        std::vector<char const*> const& Arguments,
+        char const* Expected)
+    {
+        std::vector<std::basic_string<CharType>> Source;
+        for (char const* Argument : Arguments)
+        {
+            Source.push_back(::MakeString<CharType>(Argument));
+        }
+        MILE_TEST_CHECK(
+            Mile::BuildCommandLine(Source) ==
+            ::MakeString<CharType>(Expected));
+    }
+
+    template<typename CharType>
+    static void CheckKnownAnswers()
+    {
+        ::CheckKnownAnswer<CharType>({ "a", "b" }, "a b");
+        ::CheckKnownAnswer<CharType>({ "" }, "\"\"");
+        ::CheckKnownAnswer<CharType>({ "a b", "c" }, "\"a b\" c");
+        ::CheckKnownAnswer<CharType>({ "a\"b" }, "a\\\"b");
+        ::CheckKnownAnswer<CharType>({ "a\\\\b" }, "a\\\\b");
+        ::CheckKnownAnswer<CharType>({ "a\\\"b" }, "a\\\\\\\"b");
+        ::CheckKnownAnswer<CharType>({ "a b\\" }, "\"a b\\\\\"");
+        ::CheckKnownAnswer<CharType>({ "a\tb\\\\" }, "\"a\tb\\\\\\\\\"");
+    }
+
+    /**
+     * @brief Generates an argument over an alphabet which is dense with the
+     *        characters that need quoting or escaping.
+    */
+    template<typename CharType>
+    static std::basic_string<CharType> GenerateArgument(
+        Mile::Tests::Random& Generator)
+    {
+        static char const Alphabet[] = { 'a', 'Z', ' ', '\t', '"', '\\' };
+
+        std::basic_string<CharType> Result;
+        if (0 == Generator.Next(8))
+        {
+            // A long ordinary run reaches the bulk copy path.
+            Result.append(
+                16 + Generator.Next(80),
+                static_cast<CharType>('p'));
+        }
+        std::size_t Length = Generator.Next(12);
+        for (std::size_t i = 0; i < Length; ++i)
+        {
+            Result.push_back(static_cast<CharType>(
+                Alphabet[Generator.Next(sizeof(Alphabet))]));
+        }
+        return Result;
+    }
+
+    template<typename CharType>
+    static void CheckRoundTrip(
+        std::uint64_t Seed)
+    {
+        Mile::Tests::Random Generator(Seed);
+        std::size_t const Count = CaseCount * Mile::Tests::GetScale();
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+            std::vector<std::basic_string<CharType>> Arguments;
+            std::size_t ArgumentCount = 1 + Generator.Next(8);
+            for (std::size_t j = 0; j < ArgumentCount; ++j)
+            {
+                Arguments.push_back(
+                    ::GenerateArgument<CharType>(Generator));
+            }
+            std::vector<Mile::BasicStringSpan<CharType>> Spans(
+                Arguments.begin(),
+                Arguments.end());
+
+            std::basic_string<CharType> CommandLine =
+                Mile::BuildCommandLine(Arguments);
+            MILE_TEST_CHECK(
+                Mile::SpiltCommandArguments(CommandLine) == Arguments);
+
+            // The measured length must be exact, and a buffer which is one
+            // character too small must be left untouched.
+            std::size_t Length = Mile::BuildCommandLine<CharType>(
+                Spans.data(),
+                Spans.size(),
+                nullptr,
+                0);
+            MILE_TEST_CHECK(Length == CommandLine.size());
+
+            std::basic_string<CharType> Buffer(
+                Length + 1,
+                static_cast<CharType>('#'));
+            MILE_TEST_CHECK(Length == Mile::BuildCommandLine<CharType>(
+                Spans.data(),
+                Spans.size(),
+                &Buffer[0],
+                Length));
+            MILE_TEST_CHECK(
+                Buffer == std::basic_string<CharType>(
+                    Length + 1,
+                    static_cast<CharType>('#')));
+
+            MILE_TEST_CHECK(Length == Mile::BuildCommandLine<CharType>(
+                Spans.data(),
+                Spans.size(),
+                &Buffer[0],
+                Length + 1));
+            MILE_TEST_CHECK(0 == Buffer[Length]);
+            MILE_TEST_CHECK(0 == Buffer.compare(0, Length, CommandLine));
+        }
+    }
+}
+
+int main()
+{
+    ::CheckKnownAnswers<char>();
+    ::CheckKnownAnswers<wchar_t>();
+    ::CheckKnownAnswers<char16_t>();
+
+    ::CheckRoundTrip<char>(1);
+    ::CheckRoundTrip<wchar_t>(2);
+    ::CheckRoundTrip<char16_t>(3);
+
+    return Mile::Tests::Finish("Mile.CommandLineBuildTest");
+}
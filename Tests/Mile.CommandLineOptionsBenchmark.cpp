@@ -0,0 +1,137 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandLineOptionsBenchmark.cpp
+ * PURPOSE:   Benchmark for the overloads of Mile::SpiltCommandLineEx
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <map>
+#include <string>
+
+namespace
+{
+    /**
+     * @brief The number of the parsed command lines.
+    */
+    const std::size_t IterationCount = 100000;
+
+    /**
+     * @brief The number of the lookups for each parsed command line.
+    */
+    const std::size_t LookupCount = 16;
+
+    template<typename RoutineType>
+    static double Measure(
+        std::size_t OperationCount,
+        RoutineType const& Routine)
+    {
+        std::size_t Count = 0;
+        std::size_t const Iterations =
+            IterationCount * Mile::Tests::GetScale();
+        double Elapsed = Mile::Tests::RunThreads(1, [&](std::size_t)
+        {
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                Count += Routine(i);
+            }
+        });
+        static_cast<void>(Count);
+        return Elapsed / (static_cast<double>(Iterations) * OperationCount);
+    }
+}
+
+int main()
+{
+    std::wstring const CommandLine =
+        L"\"C:\\Program Files\\Mile\\Mile.Tool.exe\""
+        L" /Input:\"C:\\Users\\Mile\\Documents\\Source Files\\Main.cpp\""
+        L" /Output:D:\\Build\\Output\\"
+        L" /Define:VERSION=1.0"
+        L" /Jobs:16"
+        L" /Verbose"
+        L" /Configuration:Release"
+        L" /Platform:x64"
+        L" /Log:D:\\Build\\Logs\\Build.log"
+        L" Main.cpp Helpers.cpp";
+    std::vector<std::wstring> const Prefixes = { L"/", L"--" };
+    std::vector<std::wstring> const Separators = { L":", L"=" };
+    std::wstring const Names[] =
+    {
+        L"Input", L"Jobs", L"Log", L"Missing",
+    };
+
+    std::printf("Parsing a command line with eight options, ns\n");
+    std::printf("%20s %14s %14s\n", "Result", "Parse", "Lookup");
+
+    double MapParse = ::Measure(1, [&](std::size_t)
+    {
+        std::wstring ApplicationName;
+        std::map<std::wstring, std::wstring> Options;
+        std::wstring Unresolved;
+        Mile::SpiltCommandLineEx(
+            CommandLine,
+            Prefixes,
+            Separators,
+            ApplicationName,
+            Options,
+            Unresolved);
+        return Options.size();
+    });
+
+    std::wstring ApplicationName;
+    std::map<std::wstring, std::wstring> MapOptions;
+    std::wstring Unresolved;
+    Mile::SpiltCommandLineEx(
+        CommandLine,
+        Prefixes,
+        Separators,
+        ApplicationName,
+        MapOptions,
+        Unresolved);
+    double MapLookup = ::Measure(LookupCount, [&](std::size_t Iteration)
+    {
+        std::size_t Found = 0;
+        for (std::size_t i = 0; i < LookupCount; ++i)
+        {
+            Found += MapOptions.count(Names[(Iteration + i) % 4]);
+        }
+        return Found;
+    });
+
+    std::printf("%20s %14.1f %14.1f\n", "std::map", MapParse, MapLookup);
+
+    double FlatParse = ::Measure(1, [&](std::size_t)
+    {
+        return Mile::SpiltCommandLineEx(
+            CommandLine,
+            Prefixes,
+            Separators).Count();
+    });
+
+    Mile::CommandLineOptions FlatOptions = Mile::SpiltCommandLineEx(
+        CommandLine,
+        Prefixes,
+        Separators);
+    double FlatLookup = ::Measure(LookupCount, [&](std::size_t Iteration)
+    {
+        std::size_t Found = 0;
+        for (std::size_t i = 0; i < LookupCount; ++i)
+        {
+            Found += FlatOptions.Contains(Names[(Iteration + i) % 4]);
+        }
+        return Found;
+    });
+
+    std::printf(
+        "%20s %14.1f %14.1f\n",
+        "CommandLineOptions",
+        FlatParse,
+        FlatLookup);
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandLineOptionsTest.cpp
+ * PURPOSE:   Test for the overloads of Mile::SpiltCommandLineEx
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <map>
+#include <string>
+
+namespace
+{
+    /**
+     * @brief The number of the generated command lines per character type.
+    */
+    const std::size_t CaseCount = 5000;
+
+    template<typename CharType>
+    static std::basic_string<CharType> MakeString(
+        char const* Source)
+    {
+        std::basic_string<CharType> Result;
+        for (; *Source; ++Source)
+        {
+            Result.push_back(static_cast<CharType>(*Source));
+        }
+        return Result;
+    }
+
+    template<typename CharType>
+    static bool Equals(
+        Mile::BasicStringSpan<CharType> const* Span,
+        char const* Expected)
+    {
+        return Span && Span->ToString() == ::MakeString<CharType>(Expected);
+    }
+
+    /**
+     * @brief Checks that the std::map overload keeps the option names which
+     *        differ only in case apart, and that the CommandLineOptions
+     *        overloads merge them and keep the last one.
+    */
+    template<typename CharType>
+    static void CheckCaseFolding()
+    {
+        using StringType = std::basic_string<CharType>;
+
+        StringType const CommandLine = ::MakeString<CharType>(
+            "app.exe /A=1 /a=2 /a=3 -b \"rest  of\" /c=4");
+        std::vector<StringType> const Prefixes =
+        {
+            ::MakeString<CharType>("/"),
+            ::MakeString<CharType>("-"),
+        };
+        std::vector<StringType> const Separators =
+        {
+            ::MakeString<CharType>("="),
+        };
+
+        StringType ApplicationName;
+        std::map<StringType, StringType> Map;
+        StringType Unresolved;
+        Mile::SpiltCommandLineEx(
+            CommandLine,
+            Prefixes,
+            Separators,
+            ApplicationName,
+            Map,
+            Unresolved);
+        MILE_TEST_CHECK(ApplicationName == ::MakeString<CharType>("app.exe"));
+        MILE_TEST_CHECK(3 == Map.size());
+        MILE_TEST_CHECK(Map[::MakeString<CharType>("A")] ==
+            ::MakeString<CharType>("1"));
+        MILE_TEST_CHECK(Map[::MakeString<CharType>("a")] ==
+            ::MakeString<CharType>("3"));
+        MILE_TEST_CHECK(Map[::MakeString<CharType>("b")].empty());
+        MILE_TEST_CHECK(Unresolved ==
+            ::MakeString<CharType>("\"rest  of\" /c=4"));
+
+        Mile::BasicCommandLineOptions<CharType> Options =
+            Mile::SpiltCommandLineEx(CommandLine, Prefixes, Separators);
+        MILE_TEST_CHECK(Options.ApplicationName().ToString() ==
+            ::MakeString<CharType>("app.exe"));
+        MILE_TEST_CHECK(2 == Options.Count());
+        MILE_TEST_CHECK(::Equals(
+            Options.Find(::MakeString<CharType>("A")),
+            "3"));
+        MILE_TEST_CHECK(::Equals(
+            Options.Find(::MakeString<CharType>("a")),
+            "3"));
+        MILE_TEST_CHECK(::Equals(
+            Options.Find(::MakeString<CharType>("B")),
+            ""));
+        MILE_TEST_CHECK(!Options.Contains(::MakeString<CharType>("c")));
+        MILE_TEST_CHECK(Options.UnresolvedCommandLine().ToString() ==
+            ::MakeString<CharType>("\"rest  of\" /c=4"));
+
+        // The span overload gives the same result.
+        CharType const Slash[] = { '/', 0 };
+        CharType const Dash[] = { '-', 0 };
+        CharType const Equal[] = { '=', 0 };
+        CharType const* const PrefixArray[] = { Slash, Dash };
+        CharType const* const SeparatorArray[] = { Equal };
+        Mile::BasicCommandLineOptions<CharType> SpanOptions =
+            Mile::SpiltCommandLineEx<CharType>(
+                CommandLine,
+                PrefixArray,
+                2,
+                SeparatorArray,
+                1);
+        MILE_TEST_CHECK(SpanOptions.Count() == Options.Count());
+        for (std::size_t i = 0;
+            i < Options.Count() && i < SpanOptions.Count();
+            ++i)
+        {
+            auto const& Expected = Options.begin()[i];
+            auto const& Actual = SpanOptions.begin()[i];
+            MILE_TEST_CHECK(
+                Actual.first.ToString() == Expected.first.ToString());
+            MILE_TEST_CHECK(
+                Actual.second.ToString() == Expected.second.ToString());
+        }
+    }
+
+    /**
+     * @brief Checks that both overloads agree when no option names differ
+     *        only in case, and that the options are sorted.
+    */
+    template<typename CharType>
+    static void CheckAgreement(
+        std::uint64_t Seed)
+    {
+        using StringType = std::basic_string<CharType>;
+
+        static char const* const Names[] =
+        {
+            "input", "output", "define", "o", "v", "jobs", "x",
+        };
+        static char const* const Values[] =
+        {
+            "", "1", "C:\\Program Files\\Mile", "a=b", "\"quoted\"",
+        };
+
+        std::vector<StringType> const Prefixes =
+        {
+            ::MakeString<CharType>("--"),
+            ::MakeString<CharType>("/"),
+        };
+        std::vector<StringType> const Separators =
+        {
+            ::MakeString<CharType>("="),
+            ::MakeString<CharType>(":"),
+        };
+
+        Mile::Tests::Random Generator(Seed);
+        std::size_t const Count = CaseCount * Mile::Tests::GetScale();
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+            std::string Source = "tool";
+            std::size_t OptionCount = Generator.Next(10);
+            for (std::size_t j = 0; j < OptionCount; ++j)
+            {
+                Source += Generator.Next(2) ? " --" : " /";
+                Source += Names[Generator.Next(7)];
+                Source += Generator.Next(2) ? "=" : ":";
+                Source += Values[Generator.Next(5)];
+            }
+            if (Generator.Next(2))
+            {
+                Source += " file.txt /z";
+            }
+            StringType const CommandLine =
+                ::MakeString<CharType>(Source.c_str());
+
+            StringType ApplicationName;
+            std::map<StringType, StringType> Map;
+            StringType Unresolved;
+            Mile::SpiltCommandLineEx(
+                CommandLine,
+                Prefixes,
+                Separators,
+                ApplicationName,
+                Map,
+                Unresolved);
+
+            Mile::BasicCommandLineOptions<CharType> Options =
+                Mile::SpiltCommandLineEx(CommandLine, Prefixes, Separators);
+            MILE_TEST_CHECK(
+                Options.ApplicationName().ToString() == ApplicationName);
+            MILE_TEST_CHECK(
+                Options.UnresolvedCommandLine().ToString() == Unresolved);
+            MILE_TEST_CHECK(Options.Count() == Map.size());
+
+            // The names are lowercase, so the sorted orders are the same.
+            auto Expected = Map.begin();
+            for (auto const& Option : Options)
+            {
+                if (Expected == Map.end())
+                {
+                    break;
+                }
+                MILE_TEST_CHECK(Option.first.ToString() == Expected->first);
+                MILE_TEST_CHECK(Option.second.ToString() == Expected->second);
+                ++Expected;
+            }
+        }
+    }
+}
+
+int main()
+{
+    ::CheckCaseFolding<char>();
+    ::CheckCaseFolding<wchar_t>();
+    ::CheckCaseFolding<char16_t>();
+
+    ::CheckAgreement<char>(1);
+    ::CheckAgreement<wchar_t>(2);
+    ::CheckAgreement<char16_t>(3);
+
+    return Mile::Tests::Finish("Mile.CommandLineOptionsTest");
+}
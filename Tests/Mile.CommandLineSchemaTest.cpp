@@ -0,0 +1,199 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.CommandLineSchemaTest.cpp
+ * PURPOSE:   Test for Mile::CommandLineSchema and the typed conversions of
+ *            the command line option values
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <string>
+
+namespace
+{
+    struct ToolOptions
+    {
+        bool Verbose = false;
+        std::int64_t Jobs = 0;
+        std::uint64_t CacheSize = 0;
+        std::string Output;
+    };
+
+    using DefinitionType = Mile::CommandLineOptionDefinition<
+        ToolOptions,
+        char>;
+
+    constexpr DefinitionType Definitions[] =
+    {
+        DefinitionType("Verbose", &ToolOptions::Verbose),
+        DefinitionType("Jobs", &ToolOptions::Jobs, "4"),
+        DefinitionType("j", &ToolOptions::Jobs),
+        DefinitionType("CacheSize", &ToolOptions::CacheSize, "1GiB"),
+        DefinitionType("Output", &ToolOptions::Output),
+    };
+
+    constexpr char const* OptionPrefixes[] = { "/", "--" };
+    constexpr char const* OptionParameterSeparators[] = { "=", ":" };
+
+    constexpr Mile::CommandLineSchema<ToolOptions, char> Schema(
+        Definitions,
+        OptionPrefixes,
+        OptionParameterSeparators);
+
+    static bool Parse(
+        char const* CommandLine,
+        ToolOptions& Options,
+        std::string* UnresolvedCommandLine = nullptr)
+    {
+        Options = ToolOptions();
+        return Schema.Parse(
+            Mile::BasicStringSpan<char>(
+                CommandLine,
+                std::char_traits<char>::length(CommandLine)),
+            Options,
+            UnresolvedCommandLine);
+    }
+
+    static void CheckSchema()
+    {
+        ToolOptions Options;
+        std::string Unresolved;
+
+        MILE_TEST_CHECK(::Parse(
+            "tool /VERBOSE --jobs:-12 /cachesize=4MiB"
+            " /Output=\"C:\\Build Output\" input.txt /j=1",
+            Options,
+            &Unresolved));
+        MILE_TEST_CHECK(Options.Verbose);
+        MILE_TEST_CHECK(-12 == Options.Jobs);
+        MILE_TEST_CHECK(4 * 1024 * 1024 == Options.CacheSize);
+        MILE_TEST_CHECK(Options.Output == "C:\\Build Output");
+        MILE_TEST_CHECK(Unresolved == "input.txt /j=1");
+
+        // The defaults are applied, and the alias assigns the same member.
+        MILE_TEST_CHECK(::Parse("tool /j=3", Options));
+        MILE_TEST_CHECK(!Options.Verbose);
+        MILE_TEST_CHECK(3 == Options.Jobs);
+        MILE_TEST_CHECK(1024 * 1024 * 1024 == Options.CacheSize);
+        MILE_TEST_CHECK(Options.Output.empty());
+
+        MILE_TEST_CHECK(::Parse("tool /verbose=off", Options));
+        MILE_TEST_CHECK(!Options.Verbose);
+        MILE_TEST_CHECK(::Parse("tool /verbose=YES", Options));
+        MILE_TEST_CHECK(Options.Verbose);
+
+        MILE_TEST_CHECK(!::Parse("tool /verbose=maybe", Options));
+        MILE_TEST_CHECK(!::Parse("tool /jobs=many", Options));
+        MILE_TEST_CHECK(!::Parse("tool /cachesize=1XB", Options));
+        MILE_TEST_CHECK(!::Parse("tool /unknown", Options));
+
+        MILE_TEST_CHECK(nullptr != Schema.Find(
+            Mile::BasicStringSpan<char>("CACHESIZE", 9)));
+        MILE_TEST_CHECK(nullptr == Schema.Find(
+            Mile::BasicStringSpan<char>("Cache", 5)));
+    }
+
+    template<typename CharType>
+    static std::basic_string<CharType> MakeString(
+        char const* Source)
+    {
+        std::basic_string<CharType> Result;
+        for (; *Source; ++Source)
+        {
+            Result.push_back(static_cast<CharType>(*Source));
+        }
+        return Result;
+    }
+
+    template<typename CharType>
+    static bool ParseInteger(
+        char const* Value,
+        std::int64_t& Result)
+    {
+        std::basic_string<CharType> Source = ::MakeString<CharType>(Value);
+        return Mile::ParseCommandLineInteger(
+            Mile::BasicStringSpan<CharType>(Source),
+            Result);
+    }
+
+    template<typename CharType>
+    static bool ParseByteSize(
+        char const* Value,
+        std::uint64_t& Result)
+    {
+        std::basic_string<CharType> Source = ::MakeString<CharType>(Value);
+        return Mile::ParseCommandLineByteSize(
+            Mile::BasicStringSpan<CharType>(Source),
+            Result);
+    }
+
+    template<typename CharType>
+    static bool ParseFlag(
+        char const* Value,
+        bool& Result)
+    {
+        std::basic_string<CharType> Source = ::MakeString<CharType>(Value);
+        return Mile::ParseCommandLineFlag(
+            Mile::BasicStringSpan<CharType>(Source),
+            Result);
+    }
+
+    template<typename CharType>
+    static void CheckConversions()
+    {
+        std::int64_t Integer = 0;
+        MILE_TEST_CHECK(::ParseInteger<CharType>("0x1F", Integer));
+        MILE_TEST_CHECK(31 == Integer);
+        MILE_TEST_CHECK(::ParseInteger<CharType>("+42", Integer));
+        MILE_TEST_CHECK(42 == Integer);
+        MILE_TEST_CHECK(
+            ::ParseInteger<CharType>("9223372036854775807", Integer));
+        MILE_TEST_CHECK(INT64_MAX == Integer);
+        MILE_TEST_CHECK(
+            ::ParseInteger<CharType>("-9223372036854775808", Integer));
+        MILE_TEST_CHECK(INT64_MIN == Integer);
+        MILE_TEST_CHECK(
+            !::ParseInteger<CharType>("9223372036854775808", Integer));
+        MILE_TEST_CHECK(
+            !::ParseInteger<CharType>("99999999999999999999", Integer));
+        MILE_TEST_CHECK(!::ParseInteger<CharType>("", Integer));
+        MILE_TEST_CHECK(!::ParseInteger<CharType>("-", Integer));
+        MILE_TEST_CHECK(!::ParseInteger<CharType>("0x", Integer));
+        MILE_TEST_CHECK(!::ParseInteger<CharType>("12a", Integer));
+
+        std::uint64_t ByteSize = 0;
+        MILE_TEST_CHECK(::ParseByteSize<CharType>("512", ByteSize));
+        MILE_TEST_CHECK(512 == ByteSize);
+        MILE_TEST_CHECK(::ParseByteSize<CharType>("16kb", ByteSize));
+        MILE_TEST_CHECK(16 * 1024 == ByteSize);
+        MILE_TEST_CHECK(::ParseByteSize<CharType>("3P", ByteSize));
+        MILE_TEST_CHECK(3ULL << 50 == ByteSize);
+        MILE_TEST_CHECK(::ParseByteSize<CharType>("16383PiB", ByteSize));
+        MILE_TEST_CHECK(16383ULL << 50 == ByteSize);
+        MILE_TEST_CHECK(!::ParseByteSize<CharType>("16384PiB", ByteSize));
+        MILE_TEST_CHECK(!::ParseByteSize<CharType>("", ByteSize));
+        MILE_TEST_CHECK(!::ParseByteSize<CharType>("K", ByteSize));
+        MILE_TEST_CHECK(!::ParseByteSize<CharType>("-1", ByteSize));
+        MILE_TEST_CHECK(!::ParseByteSize<CharType>("1 KB", ByteSize));
+
+        bool Flag = false;
+        MILE_TEST_CHECK(::ParseFlag<CharType>("On", Flag) && Flag);
+        MILE_TEST_CHECK(::ParseFlag<CharType>("0", Flag) && !Flag);
+        MILE_TEST_CHECK(!::ParseFlag<CharType>("", Flag));
+        MILE_TEST_CHECK(!::ParseFlag<CharType>("truee", Flag));
+    }
+}
+
+int main()
+{
+    ::CheckSchema();
+    ::CheckConversions<char>();
+    ::CheckConversions<wchar_t>();
+    ::CheckConversions<char16_t>();
+
+    return Mile::Tests::Finish("Mile.CommandLineSchemaTest");
+}
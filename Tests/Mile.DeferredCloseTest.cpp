@@ -0,0 +1,132 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.DeferredCloseTest.cpp
+ * PURPOSE:   Test for the deferred close reaper thread
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+namespace
+{
+    /**
+     * @brief The traits of the values which record their closing.
+    */
+    struct RecordedTraits
+    {
+        using Type = std::size_t;
+
+        static std::atomic<std::size_t>& GetClosedCount()
+        {
+            static std::atomic<std::size_t> ClosedCount(0);
+            return ClosedCount;
+        }
+
+        static Type Invalid() noexcept
+        {
+            return 0;
+        }
+
+        static void Close(Type Value) noexcept
+        {
+            Mile::UnreferencedParameter(Value);
+            GetClosedCount().fetch_add(1);
+        }
+    };
+
+    using RecordedObject = Mile::DeferredCloseObject<RecordedTraits>;
+
+    /**
+     * @brief Waits until the number of the closed values reaches the target
+     *        without flushing, so a lost wake-up of the reaper thread is
+     *        reported as a failure instead of being hidden.
+    */
+    static bool WaitForClosedCount(
+        std::size_t Target)
+    {
+        auto Deadline = std::chrono::steady_clock::now() +
+            std::chrono::seconds(5);
+        while (RecordedTraits::GetClosedCount().load() < Target)
+        {
+            if (std::chrono::steady_clock::now() > Deadline)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    static void TestWakeUp()
+    {
+        std::size_t const Rounds = 2000 * Mile::Tests::GetScale();
+        std::size_t Target = RecordedTraits::GetClosedCount().load();
+        for (std::size_t i = 0; i < Rounds; ++i)
+        {
+            {
+                RecordedObject Object(i + 1);
+            }
+            ++Target;
+            bool Closed = ::WaitForClosedCount(Target);
+            MILE_TEST_CHECK(Closed);
+            if (!Closed)
+            {
+                return;
+            }
+        }
+    }
+
+    static void TestConcurrentPosting()
+    {
+        std::size_t const ThreadCount = 4;
+        std::size_t const Iterations = 10000 * Mile::Tests::GetScale();
+        std::size_t Target =
+            RecordedTraits::GetClosedCount().load() +
+            ThreadCount * Iterations;
+
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t)
+        {
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                RecordedObject Object(i + 1);
+            }
+        });
+
+        Mile::FlushDeferredClose();
+        MILE_TEST_CHECK(RecordedTraits::GetClosedCount().load() == Target);
+
+        Mile::DeferredCloseStatistics Statistics =
+            Mile::GetDeferredCloseStatistics();
+        MILE_TEST_CHECK(Statistics.PostedCount == Statistics.ClosedCount);
+        MILE_TEST_CHECK(0 == Statistics.PendingCount);
+        MILE_TEST_CHECK(Statistics.BatchCount > 0);
+    }
+
+    static void TestDrain()
+    {
+        std::size_t Target = RecordedTraits::GetClosedCount().load() + 1;
+        {
+            RecordedObject Object(1);
+        }
+        Mile::DrainDeferredClose();
+        MILE_TEST_CHECK(RecordedTraits::GetClosedCount().load() == Target);
+        ++Target;
+
+        // The values posted after draining are closed synchronously.
+        {
+            RecordedObject Object(2);
+        }
+        MILE_TEST_CHECK(RecordedTraits::GetClosedCount().load() == Target);
+    }
+}
+
+int main()
+{
+    ::TestWakeUp();
+    ::TestConcurrentPosting();
+    ::TestDrain();
+    return Mile::Tests::Finish("Mile.DeferredCloseTest");
+}
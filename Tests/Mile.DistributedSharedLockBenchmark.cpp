@@ -0,0 +1,129 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.DistributedSharedLockBenchmark.cpp
+ * PURPOSE:   Scaling benchmark for Mile::DistributedSharedLock
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace
+{
+    /**
+     * @brief The number of the operations per thread.
+    */
+    const std::size_t OperationCount = 200000;
+
+    template<typename LockType, typename ExclusiveType, typename SharedType>
+    static double Measure(
+        std::size_t ThreadCount,
+        std::size_t ReadPermille,
+        LockType& Lock,
+        ExclusiveType const& Exclusive,
+        SharedType const& Shared)
+    {
+        std::uint64_t Value = 0;
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t Index)
+            {
+                Mile::Tests::Random Generator(Index + 1);
+                std::uint64_t Local = 0;
+                for (std::size_t i = 0; i < OperationCount; ++i)
+                {
+                    if (Generator.Next(1000) < ReadPermille)
+                    {
+                        Shared(Lock, [&]() { Local += Value; });
+                    }
+                    else
+                    {
+                        Exclusive(Lock, [&]() { ++Value; });
+                    }
+                }
+                static_cast<void>(Local);
+            });
+        return Elapsed / (OperationCount * ThreadCount);
+    }
+}
+
+int main()
+{
+    std::printf("Read-mostly lock scaling, ns per operation\n");
+    std::printf(
+        "%8s %8s %22s %10s %18s\n",
+        "Threads",
+        "Reads",
+        "DistributedSharedLock",
+        "SRWLock",
+        "std::shared_mutex");
+
+    std::size_t const ReadPermilles[] = { 1000, 999, 990, 900 };
+    for (std::size_t ThreadCount : Mile::Tests::GetThreadCounts())
+    {
+        for (std::size_t ReadPermille : ReadPermilles)
+        {
+            Mile::DistributedSharedLock DistributedLock;
+            Mile::SRWLock SRWLock;
+            std::shared_mutex StandardLock;
+
+            double DistributedTime = ::Measure(
+                ThreadCount,
+                ReadPermille,
+                DistributedLock,
+                [](Mile::DistributedSharedLock& Lock, auto const& Routine)
+                {
+                    Mile::AutoDistributedExclusiveLock Guard(Lock);
+                    Routine();
+                },
+                [](Mile::DistributedSharedLock& Lock, auto const& Routine)
+                {
+                    Mile::AutoDistributedSharedLock Guard(Lock);
+                    Routine();
+                });
+            double SRWLockTime = ::Measure(
+                ThreadCount,
+                ReadPermille,
+                SRWLock,
+                [](Mile::SRWLock& Lock, auto const& Routine)
+                {
+                    Mile::AutoSRWExclusiveLock Guard(Lock);
+                    Routine();
+                },
+                [](Mile::SRWLock& Lock, auto const& Routine)
+                {
+                    Mile::AutoSRWSharedLock Guard(Lock);
+                    Routine();
+                });
+            double StandardTime = ::Measure(
+                ThreadCount,
+                ReadPermille,
+                StandardLock,
+                [](std::shared_mutex& Lock, auto const& Routine)
+                {
+                    std::unique_lock<std::shared_mutex> Guard(Lock);
+                    Routine();
+                },
+                [](std::shared_mutex& Lock, auto const& Routine)
+                {
+                    std::shared_lock<std::shared_mutex> Guard(Lock);
+                    Routine();
+                });
+
+            std::printf(
+                "%8zu %7.1f%% %22.2f %10.2f %18.2f\n",
+                ThreadCount,
+                ReadPermille / 10.0,
+                DistributedTime,
+                SRWLockTime,
+                StandardTime);
+        }
+    }
+
+    return 0;
+}
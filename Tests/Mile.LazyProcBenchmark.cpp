@@ -0,0 +1,85 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.LazyProcBenchmark.cpp
+ * PURPOSE:   Benchmark for the calls through Mile::LazyProc
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cstdlib>
+
+namespace
+{
+    /**
+     * @brief The number of the calls per thread.
+    */
+    const std::size_t IterationCount = 10000000;
+
+    template<typename RoutineType>
+    static double Measure(
+        std::size_t ThreadCount,
+        std::size_t Iterations,
+        RoutineType const& Routine)
+    {
+        std::size_t const Count = Iterations * Mile::Tests::GetScale();
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t)
+            {
+                long Sum = 0;
+                for (std::size_t i = 0; i < Count; ++i)
+                {
+                    Sum += Routine(static_cast<long>(i) - 5);
+                }
+                static_cast<void>(Sum);
+            });
+        return Elapsed / (static_cast<double>(Count) * ThreadCount);
+    }
+}
+
+int main()
+{
+    static Mile::LazyProc<long(long)> AbsoluteValue("libc.so.6", "labs");
+    if (!AbsoluteValue)
+    {
+        std::printf("The export is not found.\n");
+        return EXIT_FAILURE;
+    }
+
+    // The volatile pointer keeps the compiler from replacing the direct call
+    // with the builtin.
+    long (* volatile Direct)(long) = std::labs;
+
+    std::printf("Calling labs, ns per call\n");
+    std::printf(
+        "%8s %14s %14s %14s\n",
+        "Threads",
+        "Direct",
+        "LazyProc",
+        "Resolve");
+    for (std::size_t ThreadCount : Mile::Tests::GetThreadCounts())
+    {
+        std::printf(
+            "%8zu %14.2f %14.2f %14.2f\n",
+            ThreadCount,
+            ::Measure(ThreadCount, IterationCount, [&](long Value)
+            {
+                return Direct(Value);
+            }),
+            ::Measure(ThreadCount, IterationCount, [](long Value)
+            {
+                return AbsoluteValue(Value);
+            }),
+            ::Measure(ThreadCount, IterationCount / 100, [](long Value)
+            {
+                return reinterpret_cast<long (*)(long)>(
+                    Mile::ResolveModuleExport("libc.so.6", "labs"))(Value);
+            }));
+    }
+
+    return 0;
+}
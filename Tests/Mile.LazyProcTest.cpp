@@ -0,0 +1,106 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.LazyProcTest.cpp
+ * PURPOSE:   Test for Mile::LazyProc
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief Checks an export which is found, from the threads racing on the
+     *        first call.
+    */
+    static void CheckFound()
+    {
+        static Mile::LazyProc<pid_t()> GetProcessId("libc.so.6", "getpid");
+
+        std::vector<void*> Addresses(4);
+        Mile::Tests::RunThreads(Addresses.size(), [&](std::size_t Index)
+        {
+            Addresses[Index] = reinterpret_cast<void*>(GetProcessId.Get());
+        });
+        for (void* Address : Addresses)
+        {
+            MILE_TEST_CHECK(nullptr != Address);
+            MILE_TEST_CHECK(Address == Addresses[0]);
+        }
+
+        MILE_TEST_CHECK(static_cast<bool>(GetProcessId));
+        MILE_TEST_CHECK(::getpid() == GetProcessId());
+    }
+
+    /**
+     * @brief Checks the exports which are not found.
+    */
+    static void CheckNotFound()
+    {
+        Mile::LazyProc<int()> MissingExport(
+            "libc.so.6",
+            "MileMissingExport");
+        MILE_TEST_CHECK(nullptr == MissingExport.Get());
+        MILE_TEST_CHECK(!MissingExport);
+
+        Mile::LazyProc<int()> MissingModule(
+            "libMileMissingModule.so",
+            "MileMissingExport");
+        MILE_TEST_CHECK(!MissingModule);
+        MILE_TEST_CHECK(nullptr == MissingModule.Get());
+    }
+
+    /**
+     * @brief Checks that the export is only resolved once, so it stays not
+     *        found after the module appears.
+    */
+    static void CheckResolvedOnce()
+    {
+        Dl_info Information = {};
+        double (*Cosine)(double) = std::cos;
+        MILE_TEST_CHECK(0 != ::dladdr(
+            reinterpret_cast<void*>(Cosine),
+            &Information));
+        if (!Information.dli_fname)
+        {
+            return;
+        }
+
+        char Template[] = "/tmp/Mile.LazyProcTest.XXXXXX";
+        MILE_TEST_CHECK(nullptr != ::mkdtemp(Template));
+        std::string const Link = std::string(Template) + "/libm.so";
+
+        Mile::LazyProc<double(double)> Late(Link.c_str(), "cos");
+        MILE_TEST_CHECK(!Late);
+
+        MILE_TEST_CHECK(0 == ::symlink(Information.dli_fname, Link.c_str()));
+        MILE_TEST_CHECK(!Late);
+        MILE_TEST_CHECK(nullptr == Late.Get());
+
+        Mile::LazyProc<double(double)> Fresh(Link.c_str(), "cos");
+        MILE_TEST_CHECK(static_cast<bool>(Fresh));
+        MILE_TEST_CHECK(1.0 == Fresh(0.0));
+
+        ::unlink(Link.c_str());
+        ::rmdir(Template);
+    }
+}
+
+int main()
+{
+    ::CheckFound();
+    ::CheckNotFound();
+    ::CheckResolvedOnce();
+
+    return Mile::Tests::Finish("Mile.LazyProcTest");
+}
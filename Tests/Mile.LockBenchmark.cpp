@@ -0,0 +1,170 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.LockBenchmark.cpp
+ * PURPOSE:   Contention benchmark for Mile::CriticalSection and
+ *            Mile::SRWLock
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace
+{
+    /**
+     * @brief The number of the operations per thread.
+    */
+    const std::size_t OperationCount = 200000;
+
+    /**
+     * @brief Simulates the work in the critical section.
+    */
+    static void DoWork(
+        std::uint64_t& Value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            Value = Value * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+    }
+
+    template<typename LockRoutineType, typename UnlockRoutineType>
+    static double MeasureMutex(
+        std::size_t ThreadCount,
+        LockRoutineType const& LockRoutine,
+        UnlockRoutineType const& UnlockRoutine)
+    {
+        std::uint64_t Value = 0;
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t)
+            {
+                for (std::size_t i = 0; i < OperationCount; ++i)
+                {
+                    LockRoutine();
+                    ::DoWork(Value);
+                    UnlockRoutine();
+                }
+            });
+        return Elapsed / (OperationCount * ThreadCount);
+    }
+
+    template<typename LockType, typename ExclusiveType, typename SharedType>
+    static double MeasureReaderWriter(
+        std::size_t ThreadCount,
+        std::size_t ReadPermille,
+        LockType& Lock,
+        ExclusiveType const& Exclusive,
+        SharedType const& Shared)
+    {
+        std::uint64_t Value = 0;
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t Index)
+            {
+                Mile::Tests::Random Generator(Index + 1);
+                std::uint64_t Local = 0;
+                for (std::size_t i = 0; i < OperationCount; ++i)
+                {
+                    if (Generator.Next(1000) < ReadPermille)
+                    {
+                        Shared(Lock, [&]() { Local += Value; });
+                    }
+                    else
+                    {
+                        Exclusive(Lock, [&]() { ::DoWork(Value); });
+                    }
+                }
+                static_cast<void>(Local);
+            });
+        return Elapsed / (OperationCount * ThreadCount);
+    }
+}
+
+int main()
+{
+    std::vector<std::size_t> ThreadCounts = Mile::Tests::GetThreadCounts();
+
+    std::printf("Mutex, ns per operation\n");
+    std::printf(
+        "%8s %16s %16s\n",
+        "Threads",
+        "CriticalSection",
+        "std::mutex");
+    for (std::size_t ThreadCount : ThreadCounts)
+    {
+        Mile::CriticalSection CriticalSectionLock;
+        std::mutex StandardLock;
+        double CriticalSectionTime = ::MeasureMutex(
+            ThreadCount,
+            [&]() { CriticalSectionLock.Lock(); },
+            [&]() { CriticalSectionLock.Unlock(); });
+        double StandardTime = ::MeasureMutex(
+            ThreadCount,
+            [&]() { StandardLock.lock(); },
+            [&]() { StandardLock.unlock(); });
+        std::printf(
+            "%8zu %16.2f %16.2f\n",
+            ThreadCount,
+            CriticalSectionTime,
+            StandardTime);
+    }
+
+    std::printf("\nReader/writer lock, ns per operation\n");
+    std::printf(
+        "%8s %8s %16s %18s\n",
+        "Threads",
+        "Reads",
+        "SRWLock",
+        "std::shared_mutex");
+    std::size_t const ReadPermilles[] = { 0, 500, 900, 990 };
+    for (std::size_t ThreadCount : ThreadCounts)
+    {
+        for (std::size_t ReadPermille : ReadPermilles)
+        {
+            Mile::SRWLock SRWLock;
+            std::shared_mutex StandardLock;
+            double SRWLockTime = ::MeasureReaderWriter(
+                ThreadCount,
+                ReadPermille,
+                SRWLock,
+                [](Mile::SRWLock& Lock, auto const& Routine)
+                {
+                    Mile::AutoSRWExclusiveLock Guard(Lock);
+                    Routine();
+                },
+                [](Mile::SRWLock& Lock, auto const& Routine)
+                {
+                    Mile::AutoSRWSharedLock Guard(Lock);
+                    Routine();
+                });
+            double StandardTime = ::MeasureReaderWriter(
+                ThreadCount,
+                ReadPermille,
+                StandardLock,
+                [](std::shared_mutex& Lock, auto const& Routine)
+                {
+                    std::unique_lock<std::shared_mutex> Guard(Lock);
+                    Routine();
+                },
+                [](std::shared_mutex& Lock, auto const& Routine)
+                {
+                    std::shared_lock<std::shared_mutex> Guard(Lock);
+                    Routine();
+                });
+            std::printf(
+                "%8zu %7.1f%% %16.2f %18.2f\n",
+                ThreadCount,
+                ReadPermille / 10.0,
+                SRWLockTime,
+                StandardTime);
+        }
+    }
+
+    return 0;
+}
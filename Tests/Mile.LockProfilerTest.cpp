@@ -0,0 +1,176 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.LockProfilerTest.cpp
+ * PURPOSE:   Test for the lock profiling, which is built with
+ *            MILE_ENABLE_LOCK_PROFILING defined
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#ifndef MILE_ENABLE_LOCK_PROFILING
+#error "[Mile] Build this test with MILE_ENABLE_LOCK_PROFILING defined."
+#endif
+
+namespace
+{
+    static bool FindStatistics(
+        char const* Name,
+        Mile::LockStatistics& Statistics)
+    {
+        for (Mile::LockStatistics const& Current : Mile::GetLockStatistics())
+        {
+            if (0 == std::strcmp(Current.Name, Name))
+            {
+                Statistics = Current;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static std::uint64_t GetHoldCount(
+        Mile::LockStatistics const& Statistics)
+    {
+        std::uint64_t Count = 0;
+        for (std::uint64_t Value : Statistics.HoldTimeHistogram)
+        {
+            Count += Value;
+        }
+        return Count;
+    }
+
+    /**
+     * @brief Checks the counts of the uncontended acquisitions, and that the
+     *        recursive acquisitions are held once.
+    */
+    static void CheckUncontended()
+    {
+        std::size_t SiteCount = Mile::GetLockStatistics().size();
+        {
+            Mile::CriticalSection Unnamed;
+            Unnamed.Lock();
+            Unnamed.Unlock();
+        }
+        MILE_TEST_CHECK(SiteCount == Mile::GetLockStatistics().size());
+
+        Mile::CriticalSection Lock("Mile.LockProfilerTest.CriticalSection");
+        for (int i = 0; i < 1000; ++i)
+        {
+            Lock.Lock();
+            Lock.Unlock();
+        }
+        Lock.Lock();
+        Lock.Lock();
+        Lock.Unlock();
+        Lock.Unlock();
+        MILE_TEST_CHECK(Lock.TryLock());
+        Lock.Unlock();
+
+        Mile::LockStatistics Statistics;
+        MILE_TEST_CHECK(::FindStatistics(
+            "Mile.LockProfilerTest.CriticalSection",
+            Statistics));
+        MILE_TEST_CHECK(1003 == Statistics.AcquisitionCount);
+        MILE_TEST_CHECK(0 == Statistics.ContendedCount);
+        MILE_TEST_CHECK(0 == Statistics.TotalWaitTime);
+        MILE_TEST_CHECK(1002 == ::GetHoldCount(Statistics));
+
+        // The locks with the same name share the statistics.
+        Mile::AdaptiveMutex First("Mile.LockProfilerTest.Shared");
+        Mile::AdaptiveMutex Second("Mile.LockProfilerTest.Shared");
+        for (int i = 0; i < 10; ++i)
+        {
+            First.Lock();
+            First.Unlock();
+            Second.Lock();
+            Second.Unlock();
+        }
+        MILE_TEST_CHECK(::FindStatistics(
+            "Mile.LockProfilerTest.Shared",
+            Statistics));
+        MILE_TEST_CHECK(20 == Statistics.AcquisitionCount);
+    }
+
+    /**
+     * @brief Checks the wait and hold times of a contended acquisition, and
+     *        that the events of an exited thread are merged.
+    */
+    static void CheckContended()
+    {
+        const std::chrono::milliseconds HoldTime(50);
+
+        Mile::SRWLock Lock("Mile.LockProfilerTest.SRWLock");
+        std::atomic<bool> Started(false);
+
+        Lock.LockExclusive();
+        std::thread Waiter([&]()
+        {
+            Started.store(true);
+            Lock.LockExclusive();
+            Lock.UnlockExclusive();
+        });
+        while (!Started.load())
+        {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(HoldTime);
+        Lock.UnlockExclusive();
+        Waiter.join();
+
+        std::uint64_t const MinimumTime =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                HoldTime).count() / 2;
+
+        Mile::LockStatistics Statistics;
+        MILE_TEST_CHECK(::FindStatistics(
+            "Mile.LockProfilerTest.SRWLock",
+            Statistics));
+        MILE_TEST_CHECK(2 == Statistics.AcquisitionCount);
+        MILE_TEST_CHECK(1 == Statistics.ContendedCount);
+        MILE_TEST_CHECK(Statistics.MaximumWaitTime >= MinimumTime);
+        MILE_TEST_CHECK(
+            Statistics.TotalWaitTime == Statistics.MaximumWaitTime);
+        MILE_TEST_CHECK(2 == ::GetHoldCount(Statistics));
+        MILE_TEST_CHECK(1 == Statistics.HoldTimeHistogram[
+            Mile::LockHoldTimeBucketCount - 1]);
+    }
+
+    /**
+     * @brief Checks that the dump starts with the most contended lock.
+    */
+    static void CheckDump()
+    {
+        std::string Dump = Mile::DumpLockStatistics(1);
+        std::size_t LineCount = 0;
+        for (char Character : Dump)
+        {
+            LineCount += '\n' == Character ? 1 : 0;
+        }
+        MILE_TEST_CHECK(2 == LineCount);
+        MILE_TEST_CHECK(0 == Dump.find("Lock "));
+        MILE_TEST_CHECK(
+            std::string::npos != Dump.find("Mile.LockProfilerTest.SRWLock"));
+
+        Dump = Mile::DumpLockStatistics();
+        std::size_t Line = Dump.find("Mile.LockProfilerTest.CriticalSection");
+        MILE_TEST_CHECK(std::string::npos != Line);
+        MILE_TEST_CHECK(std::string::npos != Dump.find(" 1003 ", Line));
+    }
+}
+
+int main()
+{
+    ::CheckUncontended();
+    ::CheckContended();
+    ::CheckDump();
+
+    return Mile::Tests::Finish("Mile.LockProfilerTest");
+}
@@ -0,0 +1,430 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.LockStressTest.cpp
+ * PURPOSE:   Stress test for the locks of Mile.Portable
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <time.h>
+
+namespace
+{
+    static std::size_t GetStressThreadCount()
+    {
+        std::size_t Count = std::thread::hardware_concurrency();
+        return Count < 4 ? 4 : Count;
+    }
+
+    static void TestCriticalSectionRecursion()
+    {
+        Mile::CriticalSection Lock;
+
+        Lock.Lock();
+        MILE_TEST_CHECK(Lock.TryLock());
+        {
+            Mile::AutoCriticalSectionLock Guard(Lock);
+
+            bool Acquired = true;
+            std::thread([&]()
+            {
+                Acquired = Lock.TryLock();
+                if (Acquired)
+                {
+                    Lock.Unlock();
+                }
+            }).join();
+            MILE_TEST_CHECK(!Acquired);
+        }
+        Lock.Unlock();
+        Lock.Unlock();
+
+        bool Acquired = false;
+        std::thread([&]()
+        {
+            Mile::AutoCriticalSectionTryLock Guard(Lock);
+            Acquired = Guard.IsLocked();
+        }).join();
+        MILE_TEST_CHECK(Acquired);
+    }
+
+    static void TestCriticalSectionCounter()
+    {
+        std::size_t const ThreadCount = GetStressThreadCount();
+        std::size_t const Iterations = 20000 * Mile::Tests::GetScale();
+
+        Mile::CriticalSection Lock;
+        Mile::RawCriticalSection RawLock;
+        Mile::CriticalSection::Initialize(&RawLock);
+        std::uint64_t Counter = 0;
+        std::uint64_t RawCounter = 0;
+        std::atomic<std::uint64_t> TryCount(0);
+        std::atomic<std::uint64_t> RawTryCount(0);
+
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t Index)
+        {
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                switch ((Index + i) % 4)
+                {
+                case 0:
+                {
+                    Mile::AutoCriticalSectionLock Guard(Lock);
+                    ++Counter;
+                    break;
+                }
+                case 1:
+                {
+                    // The recursive acquisition must not deadlock.
+                    Mile::AutoCriticalSectionLock Outer(Lock);
+                    Mile::AutoCriticalSectionLock Inner(Lock);
+                    ++Counter;
+                    break;
+                }
+                case 2:
+                {
+                    Mile::AutoCriticalSectionTryLock Guard(Lock);
+                    if (Guard.IsLocked())
+                    {
+                        ++Counter;
+                        TryCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                default:
+                {
+                    Mile::AutoRawCriticalSectionTryLock Guard(RawLock);
+                    if (Guard.IsLocked())
+                    {
+                        ++RawCounter;
+                        RawTryCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    Mile::AutoRawCriticalSectionLock RawGuard(RawLock);
+                    ++RawCounter;
+                    break;
+                }
+                }
+            }
+        });
+
+        std::uint64_t Expected = 0;
+        std::uint64_t RawExpected = 0;
+        for (std::size_t Index = 0; Index < ThreadCount; ++Index)
+        {
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                switch ((Index + i) % 4)
+                {
+                case 0:
+                case 1:
+                    ++Expected;
+                    break;
+                case 2:
+                    break;
+                default:
+                    ++RawExpected;
+                    break;
+                }
+            }
+        }
+        MILE_TEST_CHECK(Counter == Expected + TryCount.load());
+        MILE_TEST_CHECK(RawCounter == RawExpected + RawTryCount.load());
+
+        Mile::CriticalSection::Delete(&RawLock);
+    }
+
+    static void TestSRWLock()
+    {
+        std::size_t const ThreadCount = GetStressThreadCount();
+        std::size_t const Iterations = 20000 * Mile::Tests::GetScale();
+
+        Mile::SRWLock Lock;
+        Mile::RawSRWLock RawLock;
+        Mile::SRWLock::Initialize(&RawLock);
+        std::uint64_t First = 0;
+        std::uint64_t Second = 0;
+        std::uint64_t RawFirst = 0;
+        std::uint64_t RawSecond = 0;
+        std::atomic<std::uint64_t> WriteCount(0);
+        std::atomic<std::uint64_t> TornCount(0);
+
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t Index)
+        {
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                switch ((Index * 7 + i) % 16)
+                {
+                case 0:
+                {
+                    Mile::AutoSRWExclusiveLock Guard(Lock);
+                    ++First;
+                    ++Second;
+                    WriteCount.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                case 1:
+                {
+                    Mile::AutoSRWExclusiveTryLock Guard(Lock);
+                    if (Guard.IsLocked())
+                    {
+                        ++First;
+                        ++Second;
+                        WriteCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                case 2:
+                {
+                    Mile::AutoRawSRWExclusiveLock Guard(RawLock);
+                    ++RawFirst;
+                    ++RawSecond;
+                    break;
+                }
+                case 3:
+                {
+                    Mile::AutoRawSRWSharedLock Guard(RawLock);
+                    if (RawFirst != RawSecond)
+                    {
+                        TornCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                case 4:
+                {
+                    Mile::AutoRawSRWSharedTryLock Guard(RawLock);
+                    if (Guard.IsLocked() && RawFirst != RawSecond)
+                    {
+                        TornCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                case 5:
+                {
+                    Mile::AutoSRWSharedTryLock Guard(Lock);
+                    if (Guard.IsLocked() && First != Second)
+                    {
+                        TornCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                default:
+                {
+                    Mile::AutoSRWSharedLock Guard(Lock);
+                    if (First != Second)
+                    {
+                        TornCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                }
+            }
+        });
+
+        MILE_TEST_CHECK(0 == TornCount.load());
+        MILE_TEST_CHECK(First == WriteCount.load());
+        MILE_TEST_CHECK(First == Second);
+        MILE_TEST_CHECK(RawFirst == RawSecond);
+    }
+
+    static void TestAdaptiveMutexOwnership()
+    {
+        Mile::AdaptiveMutex Lock;
+
+        {
+            Mile::AutoAdaptiveMutexLock Guard(Lock);
+
+            bool Acquired = true;
+            std::thread([&]()
+            {
+                Mile::AutoAdaptiveMutexTryLock TryGuard(Lock);
+                Acquired = TryGuard.IsLocked();
+            }).join();
+            MILE_TEST_CHECK(!Acquired);
+        }
+
+        MILE_TEST_CHECK(Lock.TryLock());
+        Lock.Unlock();
+    }
+
+    static void TestAdaptiveMutexCounter(
+        std::uint32_t MaximumSpinCount)
+    {
+        std::size_t const ThreadCount = GetStressThreadCount();
+        std::size_t const Iterations = 20000 * Mile::Tests::GetScale();
+
+        Mile::AdaptiveMutex Lock;
+        Lock.SetMaximumSpinCount(MaximumSpinCount);
+        std::uint64_t Counter = 0;
+        std::uint64_t Work = 0;
+        std::atomic<std::uint64_t> ExpectedCounter(0);
+
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t Index)
+        {
+            std::uint64_t Local = 0;
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                if (0 == (Index + i) % 3)
+                {
+                    Mile::AutoAdaptiveMutexTryLock Guard(Lock);
+                    if (Guard.IsLocked())
+                    {
+                        ++Counter;
+                        ++Local;
+                    }
+                }
+                else
+                {
+                    Mile::AutoAdaptiveMutexLock Guard(Lock);
+                    // Vary the hold time, so that both the spinning and the
+                    // parking paths are taken.
+                    for (std::size_t j = 0; j < i % 64; ++j)
+                    {
+                        Work = Work * 3 + 1;
+                    }
+                    ++Counter;
+                    ++Local;
+                }
+            }
+            ExpectedCounter.fetch_add(Local);
+        });
+
+        MILE_TEST_CHECK(Counter == ExpectedCounter.load());
+        MILE_TEST_CHECK(Lock.GetSpinBudget() <= MaximumSpinCount);
+    }
+
+    static void TestDistributedSharedLock()
+    {
+        std::size_t const ThreadCount = GetStressThreadCount();
+        std::size_t const Iterations = 20000 * Mile::Tests::GetScale();
+
+        Mile::DistributedSharedLock Lock;
+        std::uint64_t First = 0;
+        std::uint64_t Second = 0;
+        std::atomic<std::uint64_t> WriteCount(0);
+        std::atomic<std::uint64_t> TornCount(0);
+
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t Index)
+        {
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                switch ((Index * 5 + i) % 32)
+                {
+                case 0:
+                {
+                    Mile::AutoDistributedExclusiveLock Guard(Lock);
+                    ++First;
+                    ++Second;
+                    WriteCount.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                case 1:
+                {
+                    Mile::AutoDistributedExclusiveTryLock Guard(Lock);
+                    if (Guard.IsLocked())
+                    {
+                        ++First;
+                        ++Second;
+                        WriteCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                case 2:
+                {
+                    Mile::AutoDistributedSharedTryLock Guard(Lock);
+                    if (Guard.IsLocked() && First != Second)
+                    {
+                        TornCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                default:
+                {
+                    Mile::AutoDistributedSharedLock Guard(Lock);
+                    if (First != Second)
+                    {
+                        TornCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                }
+            }
+        });
+
+        MILE_TEST_CHECK(0 == TornCount.load());
+        MILE_TEST_CHECK(First == WriteCount.load());
+        MILE_TEST_CHECK(First == Second);
+    }
+
+    /**
+     * @brief Retrieves the processor time of the current thread.
+     * @return The processor time of the current thread in nanoseconds.
+    */
+    static std::uint64_t GetThreadProcessorTime()
+    {
+        timespec Time;
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Time);
+        return static_cast<std::uint64_t>(Time.tv_sec) * 1000000000 +
+            static_cast<std::uint64_t>(Time.tv_nsec);
+    }
+
+    /**
+     * @brief Checks that the waiters of the DistributedSharedLock park
+     *        instead of burning the processor while the lock is held for a
+     *        long time.
+    */
+    static void TestDistributedSharedLockParking()
+    {
+        const auto HoldTime = std::chrono::milliseconds(300);
+        const std::uint64_t MaximumWaitProcessorTime = 50000000;
+
+        Mile::DistributedSharedLock Lock;
+        std::uint64_t WaitProcessorTime = 0;
+
+        // The writer waits for a reader.
+        Lock.LockShared();
+        std::thread Writer([&]()
+        {
+            std::uint64_t Start = ::GetThreadProcessorTime();
+            Lock.LockExclusive();
+            WaitProcessorTime = ::GetThreadProcessorTime() - Start;
+            Lock.UnlockExclusive();
+        });
+        std::this_thread::sleep_for(HoldTime);
+        Lock.UnlockShared();
+        Writer.join();
+        MILE_TEST_CHECK(WaitProcessorTime < MaximumWaitProcessorTime);
+
+        // The reader waits for a writer.
+        Lock.LockExclusive();
+        std::thread Reader([&]()
+        {
+            std::uint64_t Start = ::GetThreadProcessorTime();
+            Lock.LockShared();
+            WaitProcessorTime = ::GetThreadProcessorTime() - Start;
+            Lock.UnlockShared();
+        });
+        std::this_thread::sleep_for(HoldTime);
+        Lock.UnlockExclusive();
+        Reader.join();
+        MILE_TEST_CHECK(WaitProcessorTime < MaximumWaitProcessorTime);
+    }
+}
+
+int main()
+{
+    ::TestCriticalSectionRecursion();
+    ::TestCriticalSectionCounter();
+    ::TestSRWLock();
+    ::TestAdaptiveMutexOwnership();
+    ::TestAdaptiveMutexCounter(0);
+    ::TestAdaptiveMutexCounter(
+        Mile::AdaptiveMutex::DefaultMaximumSpinCount);
+    ::TestAdaptiveMutexCounter(1000);
+    ::TestDistributedSharedLock();
+    ::TestDistributedSharedLockParking();
+    return Mile::Tests::Finish("Mile.LockStressTest");
+}
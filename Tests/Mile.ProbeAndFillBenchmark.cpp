@@ -0,0 +1,107 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.ProbeAndFillBenchmark.cpp
+ * PURPOSE:   Benchmark for the stack-first path of Mile::ProbeAndFill
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cerrno>
+#include <string>
+
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief The number of the calls.
+    */
+    const std::size_t IterationCount = 200000;
+
+    template<typename RoutineType>
+    static double Measure(
+        RoutineType const& Routine)
+    {
+        std::size_t Length = 0;
+        std::size_t const Count = IterationCount * Mile::Tests::GetScale();
+        double Elapsed = Mile::Tests::RunThreads(1, [&](std::size_t)
+        {
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                Length += Routine().size();
+            }
+        });
+        static_cast<void>(Length);
+        return Elapsed / static_cast<double>(Count);
+    }
+
+    /**
+     * @brief Calls confstr twice, the first time for the required size and
+     *        the second time with a heap buffer of that size.
+    */
+    static std::string GetConfigurationStringByProbing(
+        int Name)
+    {
+        std::size_t Length = ::confstr(Name, nullptr, 0);
+        if (!Length)
+        {
+            return std::string();
+        }
+        std::string Value(Length, '\0');
+        ::confstr(Name, &Value[0], Length);
+        Value.resize(Length - 1);
+        return Value;
+    }
+
+    /**
+     * @brief Calls getcwd with a heap buffer, which is doubled until the
+     *        path fits.
+    */
+    static std::string GetCurrentWorkingDirectoryOnHeap()
+    {
+        std::string Path(64, '\0');
+        while (!::getcwd(&Path[0], Path.size()))
+        {
+            if (ERANGE != errno)
+            {
+                return std::string();
+            }
+            Path.resize(Path.size() * 2);
+        }
+        Path.resize(std::char_traits<char>::length(Path.c_str()));
+        return Path;
+    }
+}
+
+int main()
+{
+    if (Mile::GetConfigurationString(_CS_PATH) !=
+        ::GetConfigurationStringByProbing(_CS_PATH) ||
+        Mile::GetCurrentWorkingDirectory() !=
+        ::GetCurrentWorkingDirectoryOnHeap())
+    {
+        std::printf("The implementations disagree.\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Filling the result of an API, ns per call\n");
+    std::printf("%10s %14s %14s\n", "API", "ProbeAndFill", "Heap");
+    std::printf(
+        "%10s %14.1f %14.1f\n",
+        "confstr",
+        ::Measure([]() { return Mile::GetConfigurationString(_CS_PATH); }),
+        ::Measure([]()
+        {
+            return ::GetConfigurationStringByProbing(_CS_PATH);
+        }));
+    std::printf(
+        "%10s %14.1f %14.1f\n",
+        "getcwd",
+        ::Measure([]() { return Mile::GetCurrentWorkingDirectory(); }),
+        ::Measure([]() { return ::GetCurrentWorkingDirectoryOnHeap(); }));
+    return 0;
+}
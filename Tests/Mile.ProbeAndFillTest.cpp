@@ -0,0 +1,168 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.ProbeAndFillTest.cpp
+ * PURPOSE:   Test for Mile::ProbeAndFill and its Linux adapters
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief Simulates an API which fills the buffer with the value of the
+     *        given length and reports the required size, or only reports that
+     *        the buffer is too small.
+    */
+    struct SimulatedApi
+    {
+        std::string Value;
+        bool ReportsSize = true;
+        std::size_t CallCount = 0;
+
+        bool operator()(
+            char* Buffer,
+            std::size_t& Size)
+        {
+            ++this->CallCount;
+            if (Size < this->Value.size())
+            {
+                Size = this->ReportsSize ? this->Value.size() : Size * 2;
+                return false;
+            }
+            std::memcpy(Buffer, this->Value.data(), this->Value.size());
+            Size = this->Value.size();
+            return true;
+        }
+    };
+
+    /**
+     * @brief Checks that the inline buffer is used when it is large enough,
+     *        and that the buffer grows to the reported or guessed size
+     *        otherwise.
+    */
+    static void CheckGrowth()
+    {
+        SimulatedApi Api;
+        std::string Result;
+        auto Consume = [&](char const* Buffer, std::size_t Length) -> bool
+        {
+            Result.assign(Buffer, Length);
+            return true;
+        };
+
+        Api.Value = "abc";
+        MILE_TEST_CHECK((Mile::ProbeAndFill<char, 4>(std::ref(Api), Consume)));
+        MILE_TEST_CHECK(1 == Api.CallCount);
+        MILE_TEST_CHECK(Result == Api.Value);
+
+        Api.Value = std::string(1000, 'x') + "end";
+        Api.CallCount = 0;
+        MILE_TEST_CHECK((Mile::ProbeAndFill<char, 4>(std::ref(Api), Consume)));
+        MILE_TEST_CHECK(2 == Api.CallCount);
+        MILE_TEST_CHECK(Result == Api.Value);
+
+        // The size is doubled from 4 to 512 without the reported size.
+        Api.Value = std::string(500, 'z');
+        Api.ReportsSize = false;
+        Api.CallCount = 0;
+        MILE_TEST_CHECK((Mile::ProbeAndFill<char, 4>(std::ref(Api), Consume)));
+        MILE_TEST_CHECK(8 == Api.CallCount);
+        MILE_TEST_CHECK(Result == Api.Value);
+
+        // The number of the attempts is bounded.
+        Api.Value = std::string(4096, 'y');
+        Api.CallCount = 0;
+        MILE_TEST_CHECK(
+            !(Mile::ProbeAndFill<char, 4>(std::ref(Api), Consume)));
+        MILE_TEST_CHECK(8 == Api.CallCount);
+
+        // The failures which don't ask for a larger buffer aren't retried.
+        std::size_t CallCount = 0;
+        MILE_TEST_CHECK(!(Mile::ProbeAndFill<char, 4>(
+            [&](char*, std::size_t&) -> bool
+            {
+                ++CallCount;
+                return false;
+            },
+            Consume)));
+        MILE_TEST_CHECK(1 == CallCount);
+
+        Api.Value = "abc";
+        MILE_TEST_CHECK(!(Mile::ProbeAndFill<char, 4>(
+            std::ref(Api),
+            [](char const*, std::size_t) -> bool
+            {
+                return false;
+            })));
+    }
+
+    /**
+     * @brief Checks the adapters with the paths which are longer than their
+     *        inline buffers.
+    */
+    static void CheckLongPaths()
+    {
+        std::string const OriginalDirectory =
+            Mile::GetCurrentWorkingDirectory();
+        MILE_TEST_CHECK(!OriginalDirectory.empty());
+
+        char Template[] = "/tmp/Mile.ProbeAndFillTest.XXXXXX";
+        MILE_TEST_CHECK(nullptr != ::mkdtemp(Template));
+        std::string const Root = Template;
+
+        std::string Directory = Root;
+        std::vector<std::string> Directories;
+        for (int i = 0; i < 4; ++i)
+        {
+            Directory += '/' + std::string(120, static_cast<char>('a' + i));
+            MILE_TEST_CHECK(0 == ::mkdir(Directory.c_str(), 0700));
+            Directories.push_back(Directory);
+        }
+        MILE_TEST_CHECK(Directory.size() > 260);
+
+        MILE_TEST_CHECK(0 == ::chdir(Directory.c_str()));
+        MILE_TEST_CHECK(Mile::GetCurrentWorkingDirectory() == Directory);
+        MILE_TEST_CHECK(0 == ::chdir(OriginalDirectory.c_str()));
+
+        std::string const Link = Root + "/Link";
+        MILE_TEST_CHECK(0 == ::symlink(Directory.c_str(), Link.c_str()));
+        MILE_TEST_CHECK(Mile::ReadSymbolicLink(Link) == Directory);
+        MILE_TEST_CHECK(Mile::ReadSymbolicLink(Root + "/Missing").empty());
+
+        ::unlink(Link.c_str());
+        for (auto Current = Directories.rbegin();
+            Current != Directories.rend();
+            ++Current)
+        {
+            ::rmdir(Current->c_str());
+        }
+        ::rmdir(Root.c_str());
+
+        std::size_t Length = ::confstr(_CS_PATH, nullptr, 0);
+        MILE_TEST_CHECK(Length > 0);
+        std::string Expected(Length, '\0');
+        ::confstr(_CS_PATH, &Expected[0], Length);
+        Expected.resize(Length - 1);
+        MILE_TEST_CHECK(Mile::GetConfigurationString(_CS_PATH) == Expected);
+    }
+}
+
+int main()
+{
+    ::CheckGrowth();
+    ::CheckLongPaths();
+
+    return Mile::Tests::Finish("Mile.ProbeAndFillTest");
+}
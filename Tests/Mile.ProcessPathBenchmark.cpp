@@ -0,0 +1,112 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.ProcessPathBenchmark.cpp
+ * PURPOSE:   Benchmark for the cached process and system paths
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief The number of the calls per thread.
+    */
+    const std::size_t IterationCount = 100000;
+
+    template<typename RoutineType>
+    static double Measure(
+        std::size_t ThreadCount,
+        RoutineType const& Routine)
+    {
+        std::size_t const Count = IterationCount * Mile::Tests::GetScale();
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t)
+            {
+                std::size_t Length = 0;
+                for (std::size_t i = 0; i < Count; ++i)
+                {
+                    Length += Routine();
+                }
+                static_cast<void>(Length);
+            });
+        return Elapsed / (static_cast<double>(Count) * ThreadCount);
+    }
+
+    /**
+     * @brief Resolves the directories of _CS_PATH on every call, which is
+     *        what GetSystemExecutableDirectories does on its first call.
+    */
+    static std::size_t ResolveSystemExecutableDirectories()
+    {
+        std::size_t Count = 0;
+        std::string Paths = Mile::GetConfigurationString(_CS_PATH);
+        std::size_t Start = 0;
+        while (Start <= Paths.size())
+        {
+            std::size_t End = Paths.find(':', Start);
+            if (std::string::npos == End)
+            {
+                End = Paths.size();
+            }
+            std::string Path = Paths.substr(Start, End - Start);
+            char* CanonicalPath = ::realpath(Path.c_str(), nullptr);
+            if (CanonicalPath)
+            {
+                ++Count;
+                std::free(CanonicalPath);
+            }
+            Start = End + 1;
+        }
+        return Count;
+    }
+}
+
+int main()
+{
+    if (Mile::GetCurrentProcessModulePath() !=
+        Mile::ReadSymbolicLink("/proc/self/exe"))
+    {
+        std::printf("The implementations disagree.\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Repeated calls, ns per call\n");
+    std::printf(
+        "%8s %14s %14s %14s %14s\n",
+        "Threads",
+        "ModulePath",
+        "readlink",
+        "Directories",
+        "realpath");
+    for (std::size_t ThreadCount : Mile::Tests::GetThreadCounts())
+    {
+        std::printf(
+            "%8zu %14.1f %14.1f %14.1f %14.1f\n",
+            ThreadCount,
+            ::Measure(ThreadCount, []()
+            {
+                return Mile::GetCurrentProcessModulePath().size();
+            }),
+            ::Measure(ThreadCount, []()
+            {
+                return Mile::ReadSymbolicLink("/proc/self/exe").size();
+            }),
+            ::Measure(ThreadCount, []()
+            {
+                return Mile::GetSystemExecutableDirectories().size();
+            }),
+            ::Measure(ThreadCount, ::ResolveSystemExecutableDirectories));
+    }
+
+    return 0;
+}
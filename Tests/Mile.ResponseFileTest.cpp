@@ -0,0 +1,231 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.ResponseFileTest.cpp
+ * PURPOSE:   Test for the response file expansion of
+ *            Mile::ExpandCommandArguments
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * @brief The number of the generated response files.
+    */
+    const std::size_t CaseCount = 200;
+
+    /**
+     * @brief The directory of the response files.
+    */
+    std::string g_Directory;
+
+    static std::string WriteFile(
+        char const* Name,
+        std::string const& Content)
+    {
+        std::string Path = g_Directory + "/" + Name;
+        std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+        File.write(Content.data(), Content.size());
+        return Path;
+    }
+
+    template<typename CharType>
+    static bool Expand(
+        std::basic_string<CharType> const& Arguments,
+        std::vector<std::basic_string<CharType>>& Result)
+    {
+        Result.clear();
+        return Mile::ExpandCommandArguments<CharType>(
+            Mile::BasicStringSpan<CharType>(Arguments),
+            [&](Mile::BasicStringSpan<CharType> const& Argument)
+            {
+                Result.push_back(Argument.ToString());
+            });
+    }
+
+    static bool Expand(
+        std::string const& Arguments,
+        std::vector<std::string>& Result)
+    {
+        return ::Expand<char>(Arguments, Result);
+    }
+
+    /**
+     * @brief Checks the nested, missing and recursive response files, and
+     *        the encodings of the response files.
+    */
+    static void CheckNesting()
+    {
+        std::vector<std::string> Result;
+
+        std::string Inner = ::WriteFile(
+            "Inner.rsp",
+            "\"quoted argument\" inner\r\n\r\n  last");
+        std::string Outer = ::WriteFile(
+            "Outer.rsp",
+            "first @" + Inner + " \"@" + Inner + "\"\nsecond");
+        MILE_TEST_CHECK(::Expand("app @" + Outer + " tail", Result));
+        MILE_TEST_CHECK(Result == std::vector<std::string>({
+            "app",
+            "first",
+            "quoted argument", "inner", "last",
+            "quoted argument", "inner", "last",
+            "second",
+            "tail" }));
+
+        // The arguments before the failure have been passed.
+        MILE_TEST_CHECK(
+            !::Expand("app @" + g_Directory + "/Missing.rsp tail", Result));
+        MILE_TEST_CHECK(Result == std::vector<std::string>({ "app" }));
+
+        std::string Missing = ::WriteFile(
+            "NestedMissing.rsp",
+            "before @" + g_Directory + "/Missing.rsp after");
+        MILE_TEST_CHECK(!::Expand("@" + Missing, Result));
+        MILE_TEST_CHECK(Result == std::vector<std::string>({ "before" }));
+
+        std::string Recursive = g_Directory + "/Recursive.rsp";
+        ::WriteFile("Recursive.rsp", "again @" + Recursive);
+        MILE_TEST_CHECK(!::Expand("@" + Recursive, Result));
+        MILE_TEST_CHECK(8 == Result.size());
+
+        std::string Empty = ::WriteFile("Empty.rsp", "");
+        MILE_TEST_CHECK(::Expand("a @" + Empty + " b", Result));
+        MILE_TEST_CHECK(Result == std::vector<std::string>({ "a", "b" }));
+
+        std::string Utf8 = ::WriteFile(
+            "Utf8.rsp",
+            "\xEF\xBB\xBF\xC3\xA9t\xC3\xA9 \"caf\xC3\xA9 au lait\"");
+        std::vector<std::u16string> WideResult;
+        MILE_TEST_CHECK(::Expand<char16_t>(
+            u"@" + std::u16string(Utf8.begin(), Utf8.end()),
+            WideResult));
+        MILE_TEST_CHECK(WideResult == std::vector<std::u16string>({
+            u"\u00E9t\u00E9",
+            u"caf\u00E9 au lait" }));
+
+        std::u16string Utf16Content = u"\uFEFFwide \"\u00E9t\u00E9 x\"\r\n";
+        std::string Utf16Bytes;
+        for (char16_t Character : Utf16Content)
+        {
+            Utf16Bytes.push_back(static_cast<char>(Character & 0xFF));
+            Utf16Bytes.push_back(static_cast<char>(Character >> 8));
+        }
+        std::string Utf16 = ::WriteFile("Utf16.rsp", Utf16Bytes);
+        MILE_TEST_CHECK(::Expand("@" + Utf16, Result));
+        MILE_TEST_CHECK(Result == std::vector<std::string>({
+            "wide",
+            "\xC3\xA9t\xC3\xA9 x" }));
+    }
+
+    /**
+     * @brief Generates a line which is dense with the quotes, backslashes and
+     *        spaces, and is sometimes long so the line buffer grows.
+    */
+    static std::string GenerateLine(
+        Mile::Tests::Random& Generator)
+    {
+        static char const Alphabet[] = { 'a', 'Z', ' ', '\t', '"', '\\' };
+
+        std::string Line;
+        std::size_t Length = Generator.Next(8)
+            ? Generator.Next(40)
+            : 1000 + Generator.Next(5000);
+        for (std::size_t i = 0; i < Length; ++i)
+        {
+            Line.push_back(Alphabet[Generator.Next(sizeof(Alphabet))]);
+        }
+        return Line;
+    }
+
+    /**
+     * @brief Checks that each line is split like a command line of its own,
+     *        so an unterminated quote ends at the end of the line, and the
+     *        lines which are longer than the previous lines and the page
+     *        boundaries of the mapping don't matter.
+    */
+    static void CheckLines(
+        std::uint64_t Seed)
+    {
+        Mile::Tests::Random Generator(Seed);
+        std::size_t const Count = CaseCount * Mile::Tests::GetScale();
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+            std::string Content;
+            std::vector<std::string> Expected;
+            std::size_t LineCount = 1 + Generator.Next(12);
+            for (std::size_t j = 0; j < LineCount; ++j)
+            {
+                std::string Line = ::GenerateLine(Generator);
+                Mile::BasicCommandArgumentSpans<char> Spans =
+                    Mile::SpiltCommandArgumentsToSpans(Line);
+                for (std::size_t k = 0; k < Spans.Count(); ++k)
+                {
+                    Expected.push_back(Spans[k].ToString());
+                }
+                Content += Line;
+                if (j + 1 != LineCount)
+                {
+                    Content += Generator.Next(2) ? "\r\n" : "\n";
+                }
+            }
+
+            std::vector<std::string> Result;
+            MILE_TEST_CHECK(::Expand(
+                "@" + ::WriteFile("Lines.rsp", Content),
+                Result));
+            MILE_TEST_CHECK(Result == Expected);
+        }
+
+        // A quoted argument across the first page boundary, and the file
+        // ends exactly at the second one inside a quoted argument.
+        std::string Content(4090, ' ');
+        Content += "\"across the page\\\" boundary\" x";
+        Content.append(8192 - Content.size() - 6, ' ');
+        Content += "\"open ";
+        std::vector<std::string> Result;
+        MILE_TEST_CHECK(::Expand(
+            "@" + ::WriteFile("Page.rsp", Content),
+            Result));
+        MILE_TEST_CHECK(Result == std::vector<std::string>({
+            "across the page\" boundary",
+            "x",
+            "open " }));
+    }
+}
+
+int main()
+{
+    char Template[] = "/tmp/Mile.ResponseFileTest.XXXXXX";
+    if (!::mkdtemp(Template))
+    {
+        std::printf("Mile.ResponseFileTest: mkdtemp failed\n");
+        return EXIT_FAILURE;
+    }
+    g_Directory = Template;
+
+    ::CheckNesting();
+    ::CheckLines(1);
+
+    for (char const* Name :
+        {
+            "Inner.rsp", "Outer.rsp", "NestedMissing.rsp", "Recursive.rsp",
+            "Empty.rsp", "Utf8.rsp", "Utf16.rsp", "Lines.rsp", "Page.rsp",
+        })
+    {
+        ::unlink((g_Directory + "/" + Name).c_str());
+    }
+    ::rmdir(Template);
+
+    return Mile::Tests::Finish("Mile.ResponseFileTest");
+}
@@ -0,0 +1,121 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.SeqLockBenchmark.cpp
+ * PURPOSE:   Benchmark for Mile::SeqLock against the shared acquisition of
+ *            Mile::SRWLock
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+namespace
+{
+    /**
+     * @brief The number of the operations per thread.
+    */
+    const std::size_t OperationCount = 500000;
+
+    /**
+     * @brief The snapshot type which is read by the benchmark.
+    */
+    struct Snapshot
+    {
+        std::uint64_t Values[4];
+    };
+
+    /**
+     * @brief The snapshot protected by a reader/writer lock.
+    */
+    struct LockedSnapshot
+    {
+        Mile::SRWLock Lock;
+        Snapshot Value = {};
+    };
+
+    template<typename ReadRoutineType, typename WriteRoutineType>
+    static double Measure(
+        std::size_t ThreadCount,
+        std::size_t ReadPermille,
+        ReadRoutineType const& ReadRoutine,
+        WriteRoutineType const& WriteRoutine)
+    {
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t Index)
+            {
+                Mile::Tests::Random Generator(Index + 1);
+                std::uint64_t Sum = 0;
+                for (std::size_t i = 0; i < OperationCount; ++i)
+                {
+                    if (Generator.Next(1000) < ReadPermille)
+                    {
+                        Sum += ReadRoutine().Values[i % 4];
+                    }
+                    else
+                    {
+                        WriteRoutine(i);
+                    }
+                }
+                static_cast<void>(Sum);
+            });
+        return Elapsed / (OperationCount * ThreadCount);
+    }
+}
+
+int main()
+{
+    std::printf("Reading a 32-byte snapshot, ns per operation\n");
+    std::printf(
+        "%8s %8s %10s %16s\n",
+        "Threads",
+        "Reads",
+        "SeqLock",
+        "SRWLock shared");
+
+    std::size_t const ReadPermilles[] = { 1000, 990 };
+    for (std::size_t ThreadCount : Mile::Tests::GetThreadCounts())
+    {
+        for (std::size_t ReadPermille : ReadPermilles)
+        {
+            Mile::SeqLock<Snapshot> SequenceLock;
+            LockedSnapshot Locked;
+
+            double SequenceLockTime = ::Measure(
+                ThreadCount,
+                ReadPermille,
+                [&]() { return SequenceLock.Load(); },
+                [&](std::size_t Value)
+                {
+                    SequenceLock.Update([&](Snapshot& Current)
+                    {
+                        Current.Values[Value % 4] = Value;
+                    });
+                });
+            double SRWLockTime = ::Measure(
+                ThreadCount,
+                ReadPermille,
+                [&]()
+                {
+                    Mile::AutoSRWSharedLock Guard(Locked.Lock);
+                    return Locked.Value;
+                },
+                [&](std::size_t Value)
+                {
+                    Mile::AutoSRWExclusiveLock Guard(Locked.Lock);
+                    Locked.Value.Values[Value % 4] = Value;
+                });
+
+            std::printf(
+                "%8zu %7.1f%% %10.2f %16.2f\n",
+                ThreadCount,
+                ReadPermille / 10.0,
+                SequenceLockTime,
+                SRWLockTime);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.SeqLockTest.cpp
+ * PURPOSE:   Torture test for Mile::SeqLock
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * @brief The snapshot whose fields are derived from the first one, so a
+     *        torn read breaks the invariant.
+    */
+    struct Snapshot
+    {
+        std::uint64_t Value;
+        std::uint64_t Tripled;
+        std::uint64_t Inverted;
+        std::uint32_t Low;
+        std::uint32_t High;
+    };
+
+    static Snapshot MakeSnapshot(
+        std::uint64_t Value)
+    {
+        Snapshot Result;
+        Result.Value = Value;
+        Result.Tripled = Value * 3;
+        Result.Inverted = ~Value;
+        Result.Low = static_cast<std::uint32_t>(Value);
+        Result.High = static_cast<std::uint32_t>(Value >> 32);
+        return Result;
+    }
+
+    static bool IsConsistent(
+        Snapshot const& Value)
+    {
+        return
+            Value.Tripled == Value.Value * 3 &&
+            Value.Inverted == ~Value.Value &&
+            Value.Low == static_cast<std::uint32_t>(Value.Value) &&
+            Value.High == static_cast<std::uint32_t>(Value.Value >> 32);
+    }
+
+    static void TestThrowingUpdate()
+    {
+        Mile::SeqLock<Snapshot> Lock(::MakeSnapshot(42));
+
+        bool Thrown = false;
+        try
+        {
+            Lock.Update([](Snapshot& Value)
+            {
+                Value.Tripled = 0;
+                throw std::runtime_error("Update failed");
+            });
+        }
+        catch (std::runtime_error const&)
+        {
+            Thrown = true;
+        }
+        MILE_TEST_CHECK(Thrown);
+
+        // The sequence must be even again, otherwise these would not return.
+        Snapshot Value = Lock.Load();
+        MILE_TEST_CHECK(42 == Value.Value);
+        MILE_TEST_CHECK(::IsConsistent(Value));
+        Lock.Store(::MakeSnapshot(43));
+        MILE_TEST_CHECK(43 == Lock.Load().Value);
+    }
+
+    static void TestConcurrentAccess()
+    {
+        std::size_t const WriterCount = 2;
+        std::size_t ReaderCount = std::thread::hardware_concurrency();
+        ReaderCount = ReaderCount < 4 ? 2 : ReaderCount - 2;
+        std::size_t const Iterations = 20000 * Mile::Tests::GetScale();
+
+        Mile::SeqLock<Snapshot> Lock(::MakeSnapshot(0));
+        std::atomic<std::size_t> RunningWriterCount(WriterCount);
+        std::atomic<std::uint64_t> LoadCount(0);
+        std::atomic<std::uint64_t> TornCount(0);
+        std::atomic<std::uint64_t> UpdateCount(0);
+
+        Mile::Tests::RunThreads(
+            WriterCount + ReaderCount,
+            [&](std::size_t Index)
+            {
+                if (Index >= WriterCount)
+                {
+                    std::uint64_t Loads = 0;
+                    do
+                    {
+                        if (!::IsConsistent(Lock.Load()))
+                        {
+                            TornCount.fetch_add(1);
+                        }
+                        ++Loads;
+                    } while (RunningWriterCount.load());
+                    LoadCount.fetch_add(Loads);
+                    return;
+                }
+
+                Mile::Tests::Random Generator(Index + 1);
+                for (std::size_t i = 0; i < Iterations; ++i)
+                {
+                    std::size_t Kind = Generator.Next(8);
+                    if (0 == Kind)
+                    {
+                        Lock.Store(::MakeSnapshot(Generator.Next()));
+                    }
+                    else if (1 == Kind)
+                    {
+                        // A throwing routine must leave the value as is.
+                        try
+                        {
+                            Lock.Update([](Snapshot& Value)
+                            {
+                                Value.Inverted = Value.Value;
+                                throw std::runtime_error("Update failed");
+                            });
+                        }
+                        catch (std::runtime_error const&)
+                        {
+                        }
+                    }
+                    else
+                    {
+                        Lock.Update([](Snapshot& Value)
+                        {
+                            Value = ::MakeSnapshot(Value.Value + 1);
+                        });
+                        UpdateCount.fetch_add(1);
+                    }
+                }
+                RunningWriterCount.fetch_sub(1);
+            });
+
+        MILE_TEST_CHECK(0 == TornCount.load());
+        MILE_TEST_CHECK(::IsConsistent(Lock.Load()));
+        MILE_TEST_CHECK(LoadCount.load() >= ReaderCount);
+        MILE_TEST_CHECK(UpdateCount.load() > 0);
+    }
+
+    static void TestUpdateCount()
+    {
+        std::size_t const ThreadCount = 4;
+        std::size_t const Iterations = 20000 * Mile::Tests::GetScale();
+
+        Mile::SeqLock<Snapshot> Lock(::MakeSnapshot(0));
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t)
+        {
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                Lock.Update([](Snapshot& Value)
+                {
+                    Value = ::MakeSnapshot(Value.Value + 1);
+                });
+            }
+        });
+
+        Snapshot Value = Lock.Load();
+        MILE_TEST_CHECK(ThreadCount * Iterations == Value.Value);
+        MILE_TEST_CHECK(::IsConsistent(Value));
+    }
+}
+
+int main()
+{
+    ::TestThrowingUpdate();
+    ::TestConcurrentAccess();
+    ::TestUpdateCount();
+    return Mile::Tests::Finish("Mile.SeqLockTest");
+}
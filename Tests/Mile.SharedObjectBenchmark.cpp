@@ -0,0 +1,184 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.SharedObjectBenchmark.cpp
+ * PURPOSE:   Benchmark for Mile::SharedObject and std::shared_ptr
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+#include <memory>
+
+namespace
+{
+    /**
+     * @brief The number of the operations per thread.
+    */
+    const std::size_t OperationCount = 1000000;
+
+    /**
+     * @brief The number of the copies which are alive at the same time.
+    */
+    const std::size_t CopyCount = 64;
+
+    /**
+     * @brief The traits of the descriptors which are never closed, so only
+     *        the cost of the reference counting is measured.
+    */
+    struct DescriptorTraits
+    {
+        using Type = int;
+
+        static constexpr Type Invalid() noexcept
+        {
+            return -1;
+        }
+
+        static void Close(Type const& Value) noexcept
+        {
+            static_cast<void>(Value);
+        }
+    };
+
+    using AtomicObject = Mile::SharedObject<
+        DescriptorTraits,
+        Mile::AtomicReferenceCounter>;
+
+    using NonAtomicObject = Mile::SharedObject<
+        DescriptorTraits,
+        Mile::NonAtomicReferenceCounter>;
+
+    /**
+     * @brief The std::shared_ptr way to share a descriptor, which closes it
+     *        with a custom deleter.
+    */
+    struct DescriptorDeleter
+    {
+        void operator()(int* Value) const noexcept
+        {
+            DescriptorTraits::Close(*Value);
+            delete Value;
+        }
+    };
+
+    using StandardObject = std::shared_ptr<int>;
+
+    /**
+     * @brief Measures copying a shared object into a few slots and
+     *        destroying the copies, and each thread copies its own source or
+     *        the shared source.
+    */
+    template<typename ObjectType>
+    static double MeasureCopy(
+        std::size_t ThreadCount,
+        ObjectType const& SharedSource,
+        bool Contended)
+    {
+        std::size_t const Count = OperationCount * Mile::Tests::GetScale();
+        double Elapsed = Mile::Tests::RunThreads(
+            ThreadCount,
+            [&](std::size_t)
+            {
+                ObjectType const LocalSource = SharedSource;
+                ObjectType const& Source =
+                    Contended ? SharedSource : LocalSource;
+                ObjectType Copies[CopyCount];
+                for (std::size_t i = 0; i < Count; i += CopyCount)
+                {
+                    for (ObjectType& Copy : Copies)
+                    {
+                        Copy = Source;
+                    }
+                    for (ObjectType& Copy : Copies)
+                    {
+                        Copy = ObjectType();
+                    }
+                }
+            });
+        return Elapsed / (static_cast<double>(Count) * ThreadCount);
+    }
+
+    /**
+     * @brief Measures creating and destroying a shared object.
+    */
+    template<typename RoutineType>
+    static double MeasureCreate(
+        RoutineType const& Routine)
+    {
+        std::size_t const Count = OperationCount * Mile::Tests::GetScale();
+        std::size_t Valid = 0;
+        double Elapsed = Mile::Tests::RunThreads(1, [&](std::size_t)
+        {
+            for (std::size_t i = 0; i < Count; ++i)
+            {
+                Valid += Routine(static_cast<int>(i)) ? 1 : 0;
+            }
+        });
+        static_cast<void>(Valid);
+        return Elapsed / static_cast<double>(Count);
+    }
+}
+
+int main()
+{
+    std::printf("Create and destroy, ns per object\n");
+    std::printf(
+        "%20s %14.2f\n",
+        "SharedObject",
+        ::MeasureCreate([](int Value)
+        {
+            return static_cast<bool>(AtomicObject(Value));
+        }));
+    std::printf(
+        "%20s %14.2f\n",
+        "shared_ptr",
+        ::MeasureCreate([](int Value)
+        {
+            return static_cast<bool>(
+                StandardObject(new int(Value), DescriptorDeleter()));
+        }));
+    std::printf(
+        "%20s %14.2f\n",
+        "make_shared",
+        ::MeasureCreate([](int Value)
+        {
+            return static_cast<bool>(std::make_shared<int>(Value));
+        }));
+
+    AtomicObject const Atomic(1);
+    NonAtomicObject const NonAtomic(1);
+    StandardObject const Standard(new int(1), DescriptorDeleter());
+
+    std::printf("\nCopy and destroy, ns per copy\n");
+    std::printf(
+        "%8s %10s %14s %14s %14s\n",
+        "Threads",
+        "Source",
+        "Atomic",
+        "NonAtomic",
+        "shared_ptr");
+    std::printf(
+        "%8d %10s %14.2f %14.2f %14.2f\n",
+        1,
+        "Local",
+        ::MeasureCopy(1, Atomic, false),
+        ::MeasureCopy(1, NonAtomic, false),
+        ::MeasureCopy(1, Standard, false));
+
+    // The non-atomic counter can't be shared between threads.
+    for (std::size_t ThreadCount : Mile::Tests::GetThreadCounts())
+    {
+        std::printf(
+            "%8zu %10s %14.2f %14s %14.2f\n",
+            ThreadCount,
+            "Shared",
+            ::MeasureCopy(ThreadCount, Atomic, true),
+            "-",
+            ::MeasureCopy(ThreadCount, Standard, true));
+    }
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.Tests.h
+ * PURPOSE:   Definition for the shared helpers of the tests and benchmarks
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#ifndef MILE_TESTS
+#define MILE_TESTS
+
+#include "Mile.Portable.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace Mile
+{
+    namespace Tests
+    {
+        /**
+         * @brief Retrieves the number of the failed checks.
+         * @return The reference of the number of the failed checks.
+        */
+        inline std::size_t& GetFailureCount()
+        {
+            static std::size_t FailureCount = 0;
+            return FailureCount;
+        }
+
+        /**
+         * @brief Reports the result of the test program.
+         * @param Name The name of the test program.
+         * @return The exit code of the test program.
+        */
+        inline int Finish(
+            char const* Name)
+        {
+            std::size_t FailureCount = GetFailureCount();
+            if (FailureCount)
+            {
+                std::printf(
+                    "%s: %zu check(s) failed\n",
+                    Name,
+                    FailureCount);
+                return EXIT_FAILURE;
+            }
+            std::printf("%s: passed\n", Name);
+            return EXIT_SUCCESS;
+        }
+
+        /**
+         * @brief Retrieves the scale of the iteration counts, which is read
+         *        from the MILE_TESTS_SCALE environment variable, and is 1 by
+         *        default.
+         * @return The scale of the iteration counts.
+        */
+        inline std::size_t GetScale()
+        {
+            char const* Value = std::getenv("MILE_TESTS_SCALE");
+            long Scale = Value ? std::atol(Value) : 1;
+            return Scale > 0 ? static_cast<std::size_t>(Scale) : 1;
+        }
+
+        /**
+         * @brief Retrieves the thread counts for the scaling benchmarks, the
+         *        powers of two up to the number of the hardware threads and
+         *        the number of the hardware threads itself.
+         * @return The thread counts.
+        */
+        inline std::vector<std::size_t> GetThreadCounts()
+        {
+            std::size_t Maximum = std::thread::hardware_concurrency();
+            if (Maximum < 1)
+            {
+                Maximum = 1;
+            }
+            std::vector<std::size_t> Counts;
+            for (std::size_t Count = 1; Count < Maximum; Count *= 2)
+            {
+                Counts.push_back(Count);
+            }
+            Counts.push_back(Maximum);
+            return Counts;
+        }
+
+        /**
+         * @brief The xorshift64* pseudo-random number generator, which makes
+         *        the generated inputs reproducible on all platforms.
+        */
+        class Random
+        {
+        private:
+
+            std::uint64_t m_State;
+
+        public:
+
+            explicit Random(
+                std::uint64_t Seed) noexcept :
+                m_State(Seed ? Seed : 0x9E3779B97F4A7C15ULL)
+            {
+            }
+
+            std::uint64_t Next() noexcept
+            {
+                this->m_State ^= this->m_State >> 12;
+                this->m_State ^= this->m_State << 25;
+                this->m_State ^= this->m_State >> 27;
+                return this->m_State * 0x2545F4914F6CDD1DULL;
+            }
+
+            std::size_t Next(
+                std::size_t Bound) noexcept
+            {
+                return static_cast<std::size_t>(this->Next() % Bound);
+            }
+        };
+
+        /**
+         * @brief Runs the routine on the threads at the same time, and
+         *        measures the elapsed time.
+         * @param ThreadCount The number of the threads.
+         * @param Routine The routine which receives the thread index.
+         * @return The elapsed time in nanoseconds.
+        */
+        template<typename RoutineType>
+        double RunThreads(
+            std::size_t ThreadCount,
+            RoutineType const& Routine)
+        {
+            std::atomic<std::size_t> ReadyCount(0);
+            std::atomic<bool> Started(false);
+            std::vector<std::thread> Threads;
+            for (std::size_t i = 0; i < ThreadCount; ++i)
+            {
+                Threads.emplace_back([&, i]()
+                {
+                    ReadyCount.fetch_add(1);
+                    while (!Started.load())
+                    {
+                        std::this_thread::yield();
+                    }
+                    Routine(i);
+                });
+            }
+            while (ReadyCount.load() != ThreadCount)
+            {
+                std::this_thread::yield();
+            }
+            auto Start = std::chrono::steady_clock::now();
+            Started.store(true);
+            for (std::thread& Thread : Threads)
+            {
+                Thread.join();
+            }
+            return std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - Start).count();
+        }
+    }
+}
+
+/**
+ * @brief Checks the condition, and reports the failure without stopping the
+ *        test program.
+ * @param Condition The condition to check.
+*/
+#define MILE_TEST_CHECK(Condition) \
+    do \
+    { \
+        if (!(Condition)) \
+        { \
+            std::fprintf( \
+                stderr, \
+                "%s(%d): check failed: %s\n", \
+                __FILE__, \
+                __LINE__, \
+                #Condition); \
+            ++::Mile::Tests::GetFailureCount(); \
+        } \
+    } while (false)
+
+#endif // !MILE_TESTS
@@ -0,0 +1,152 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.UniqueBufferTest.cpp
+ * PURPOSE:   Tests for the length and the ownership of
+ *            Mile::BasicUniqueBuffer
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+namespace
+{
+    /**
+     * @brief The number of the elements of the allocated buffers.
+    */
+    const std::size_t BufferCapacity = 16;
+
+    /**
+     * @brief The traits of the buffers allocated by new[], which record
+     *        their freeing.
+    */
+    struct RecordedTraits
+    {
+        using Type = char*;
+
+        static std::size_t& GetFreedCount()
+        {
+            static std::size_t FreedCount = 0;
+            return FreedCount;
+        }
+
+        static Type Invalid() noexcept
+        {
+            return nullptr;
+        }
+
+        static void Close(Type Value) noexcept
+        {
+            delete[] Value;
+            ++GetFreedCount();
+        }
+    };
+
+    using RecordedBuffer = Mile::BasicUniqueBuffer<char, RecordedTraits>;
+
+    static RecordedBuffer CreateBuffer(
+        char const* Content)
+    {
+        std::size_t Length = std::strlen(Content);
+        char* Value = new char[BufferCapacity];
+        std::memcpy(Value, Content, Length);
+        return RecordedBuffer(Value, Length, BufferCapacity);
+    }
+
+    static void TestLength()
+    {
+        RecordedBuffer Empty;
+        MILE_TEST_CHECK(!Empty);
+        MILE_TEST_CHECK(Empty.Empty());
+        MILE_TEST_CHECK(0 == Empty.Length());
+        MILE_TEST_CHECK(0 == Empty.Capacity());
+
+        // The length and capacity of a null buffer are ignored.
+        RecordedBuffer Null(nullptr, 4, BufferCapacity);
+        MILE_TEST_CHECK(0 == Null.Length());
+        MILE_TEST_CHECK(0 == Null.Capacity());
+
+        RecordedBuffer Buffer = ::CreateBuffer("Mile");
+        MILE_TEST_CHECK(Buffer);
+        MILE_TEST_CHECK(4 == Buffer.Length());
+        MILE_TEST_CHECK(BufferCapacity == Buffer.Capacity());
+        MILE_TEST_CHECK(Buffer.View().ToString() == "Mile");
+        MILE_TEST_CHECK(4 == static_cast<std::size_t>(
+            Buffer.end() - Buffer.begin()));
+
+        // The content after the length is not part of the view.
+        Buffer[4] = '!';
+        MILE_TEST_CHECK(Buffer.View().ToString() == "Mile");
+        Buffer.SetLength(5);
+        MILE_TEST_CHECK(Buffer.View().ToString() == "Mile!");
+        MILE_TEST_CHECK(BufferCapacity == Buffer.Capacity());
+    }
+
+    static void TestOwnership()
+    {
+        std::size_t& FreedCount = RecordedTraits::GetFreedCount();
+        std::size_t Expected = FreedCount;
+
+        {
+            RecordedBuffer Source = ::CreateBuffer("Source");
+            char* Value = Source.Get();
+
+            // The moved buffer takes the ownership and the length.
+            RecordedBuffer Target(std::move(Source));
+            MILE_TEST_CHECK(!Source);
+            MILE_TEST_CHECK(0 == Source.Length());
+            MILE_TEST_CHECK(0 == Source.Capacity());
+            MILE_TEST_CHECK(Value == Target.Get());
+            MILE_TEST_CHECK(6 == Target.Length());
+
+            // The assigned buffer frees its previous buffer.
+            RecordedBuffer Other = ::CreateBuffer("Other");
+            Other = std::move(Target);
+            ++Expected;
+            MILE_TEST_CHECK(Expected == FreedCount);
+            MILE_TEST_CHECK(!Target);
+            MILE_TEST_CHECK(Value == Other.Get());
+            MILE_TEST_CHECK(Other.View().ToString() == "Source");
+        }
+        ++Expected;
+        MILE_TEST_CHECK(Expected == FreedCount);
+
+        {
+            RecordedBuffer Left = ::CreateBuffer("Left");
+            RecordedBuffer Right = ::CreateBuffer("Right!");
+            swap(Left, Right);
+            MILE_TEST_CHECK(Left.View().ToString() == "Right!");
+            MILE_TEST_CHECK(Right.View().ToString() == "Left");
+            MILE_TEST_CHECK(Expected == FreedCount);
+
+            // The detached buffer is not freed by the unique buffer.
+            char* Value = Left.Detach();
+            MILE_TEST_CHECK(!Left);
+            MILE_TEST_CHECK(0 == Left.Length());
+            MILE_TEST_CHECK(0 == Left.Capacity());
+
+            // Attaching frees the previous buffer.
+            Right.Attach(Value, 6, BufferCapacity);
+            ++Expected;
+            MILE_TEST_CHECK(Expected == FreedCount);
+            MILE_TEST_CHECK(Right.View().ToString() == "Right!");
+
+            Right.Close();
+            ++Expected;
+            MILE_TEST_CHECK(Expected == FreedCount);
+            MILE_TEST_CHECK(!Right);
+            MILE_TEST_CHECK(0 == Right.Length());
+            MILE_TEST_CHECK(0 == Right.Capacity());
+        }
+        MILE_TEST_CHECK(Expected == FreedCount);
+    }
+}
+
+int main()
+{
+    ::TestLength();
+    ::TestOwnership();
+    return Mile::Tests::Finish("Mile.UniqueBufferTest");
+}
@@ -0,0 +1,198 @@
+﻿/*
+ * PROJECT:   Mouri Internal Library Essentials
+ * FILE:      Mile.UniqueObjectPoolTest.cpp
+ * PURPOSE:   Tests for the statistics of Mile::UniqueObjectPool and the
+ *            values released after the free list of a thread is destroyed
+ *
+ * LICENSE:   The MIT License
+ *
+ * DEVELOPER: MouriNaruto (KurikoMouri@outlook.jp)
+ */
+
+#include "Mile.Tests.h"
+
+namespace
+{
+    /**
+     * @brief The value which cannot be reset and is always discarded.
+    */
+    const std::size_t UnresettableValue = ~static_cast<std::size_t>(0);
+
+    /**
+     * @brief The traits of the values which record their creation and
+     *        closing, each tag has its own pool and counters.
+     * @tparam Tag The tag which distinguishes the pools of the tests.
+    */
+    template<int Tag>
+    struct CountedTraits
+    {
+        using Type = std::size_t;
+
+        static std::atomic<std::size_t>& GetCreatedCount()
+        {
+            static std::atomic<std::size_t> CreatedCount(0);
+            return CreatedCount;
+        }
+
+        static std::atomic<std::size_t>& GetClosedCount()
+        {
+            static std::atomic<std::size_t> ClosedCount(0);
+            return ClosedCount;
+        }
+
+        static Type Create()
+        {
+            return GetCreatedCount().fetch_add(1) + 1;
+        }
+
+        static Type Invalid() noexcept
+        {
+            return 0;
+        }
+
+        static bool Reset(Type Value) noexcept
+        {
+            return UnresettableValue != Value;
+        }
+
+        static void Close(Type Value) noexcept
+        {
+            Mile::UnreferencedParameter(Value);
+            GetClosedCount().fetch_add(1);
+        }
+    };
+
+    static void TestStatistics()
+    {
+        using Traits = CountedTraits<0>;
+        using Pool = Mile::UniqueObjectPool<Traits, 4>;
+
+        {
+            Pool::ObjectType Object = Pool::Acquire(Traits::Create);
+            MILE_TEST_CHECK(1 == Object.Get());
+        }
+        {
+            // The recycled value is handed out again without creation.
+            Pool::ObjectType Object = Pool::Acquire(Traits::Create);
+            MILE_TEST_CHECK(1 == Object.Get());
+        }
+        MILE_TEST_CHECK(1 == Traits::GetCreatedCount().load());
+        MILE_TEST_CHECK(0 == Traits::GetClosedCount().load());
+
+        Mile::UniqueObjectPoolStatistics Statistics = Pool::GetStatistics();
+        MILE_TEST_CHECK(1 == Statistics.HitCount);
+        MILE_TEST_CHECK(1 == Statistics.MissCount);
+        MILE_TEST_CHECK(2 == Statistics.RecycledCount);
+        MILE_TEST_CHECK(0 == Statistics.DiscardedCount);
+
+        {
+            // One hit and five misses, the free list keeps four values and
+            // the other two are closed.
+            std::vector<Pool::ObjectType> Objects;
+            for (std::size_t i = 0; i < 6; ++i)
+            {
+                Objects.push_back(Pool::Acquire(Traits::Create));
+            }
+        }
+        MILE_TEST_CHECK(6 == Traits::GetCreatedCount().load());
+        MILE_TEST_CHECK(2 == Traits::GetClosedCount().load());
+
+        Pool::Trim();
+        MILE_TEST_CHECK(6 == Traits::GetClosedCount().load());
+
+        {
+            // The value which cannot be reset is closed instead of cached.
+            Pool::ObjectType Object = Pool::Acquire([]()
+            {
+                return UnresettableValue;
+            });
+        }
+        MILE_TEST_CHECK(7 == Traits::GetClosedCount().load());
+
+        Statistics = Pool::GetStatistics();
+        MILE_TEST_CHECK(2 == Statistics.HitCount);
+        MILE_TEST_CHECK(7 == Statistics.MissCount);
+        MILE_TEST_CHECK(6 == Statistics.RecycledCount);
+        MILE_TEST_CHECK(3 == Statistics.DiscardedCount);
+
+        {
+            Pool::ObjectType Object = Pool::Acquire(Traits::Create);
+            MILE_TEST_CHECK(7 == Object.Get());
+        }
+    }
+
+    static void TestThreadExit()
+    {
+        using Traits = CountedTraits<1>;
+        using Pool = Mile::UniqueObjectPool<Traits, 4>;
+
+        std::size_t const ThreadCount = 4;
+        std::size_t const Iterations = 1000 * Mile::Tests::GetScale();
+
+        Mile::Tests::RunThreads(ThreadCount, [&](std::size_t)
+        {
+            for (std::size_t i = 0; i < Iterations; ++i)
+            {
+                Pool::ObjectType Object = Pool::Acquire(Traits::Create);
+            }
+        });
+
+        // Each thread creates one value, recycles it for every iteration
+        // and closes it when it exits, the counts of the threads are merged
+        // when they exit.
+        MILE_TEST_CHECK(ThreadCount == Traits::GetCreatedCount().load());
+        MILE_TEST_CHECK(ThreadCount == Traits::GetClosedCount().load());
+
+        Mile::UniqueObjectPoolStatistics Statistics = Pool::GetStatistics();
+        MILE_TEST_CHECK(ThreadCount * (Iterations - 1) == Statistics.HitCount);
+        MILE_TEST_CHECK(ThreadCount == Statistics.MissCount);
+        MILE_TEST_CHECK(ThreadCount * Iterations == Statistics.RecycledCount);
+        MILE_TEST_CHECK(0 == Statistics.DiscardedCount);
+    }
+
+    /**
+     * @brief The thread local holder of a pooled unique object, which is
+     *        constructed before the free list and destroyed after it.
+    */
+    template<typename PoolType>
+    struct ThreadLocalHolder
+    {
+        typename PoolType::ObjectType Object;
+    };
+
+    static void TestReleaseAfterFreeListDestroyed()
+    {
+        using Traits = CountedTraits<2>;
+        using Pool = Mile::UniqueObjectPool<Traits, 4>;
+
+        std::thread Thread([]()
+        {
+            static thread_local ThreadLocalHolder<Pool> Holder;
+            {
+                Pool::ObjectType Cached = Pool::Acquire(Traits::Create);
+            }
+            Holder.Object = Pool::Acquire(Traits::Create);
+        });
+        Thread.join();
+
+        // The cached value is closed with the free list, and the value held
+        // by the holder is closed directly when it is released later instead
+        // of being leaked in the destroyed free list.
+        MILE_TEST_CHECK(1 == Traits::GetCreatedCount().load());
+        MILE_TEST_CHECK(1 == Traits::GetClosedCount().load());
+
+        Mile::UniqueObjectPoolStatistics Statistics = Pool::GetStatistics();
+        MILE_TEST_CHECK(1 == Statistics.HitCount);
+        MILE_TEST_CHECK(1 == Statistics.MissCount);
+        MILE_TEST_CHECK(1 == Statistics.RecycledCount);
+        MILE_TEST_CHECK(1 == Statistics.DiscardedCount);
+    }
+}
+
+int main()
+{
+    ::TestStatistics();
+    ::TestThreadExit();
+    ::TestReleaseAfterFreeListDestroyed();
+    return Mile::Tests::Finish("Mile.UniqueObjectPoolTest");
+}